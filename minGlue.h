@@ -27,18 +27,72 @@
  */
 extern SceBool psp_read_fgets(char *s, SceSize n, INI_FILETYPE *stream);
 
-#define ini_openread(filename,file)     ((*(file) = sceIoOpen((filename), PSP_O_RDONLY, 0777)) >= 0)
-#define ini_openwrite(filename,file)    ((*(file) = sceIoOpen((filename), PSP_O_CREAT | PSP_O_TRUNC | PSP_O_WRONLY, 0777)) >= 0)
-#define ini_openrewrite(filename,file)  ((*(file) = sceIoOpen((filename), PSP_O_RDWR, 0777)) >= 0)
-#define ini_close(file)                 (sceIoClose(*(file)) >= 0)
-#define ini_read(buffer,size,file)      psp_read_fgets((buffer), (size), (file))
-#define ini_write(buffer,size,file)     (sceIoWrite(*(file), (buffer), (size)) > 0)
-#define ini_rename(source,dest)         (sceIoRename((source), (dest)) >= 0)
-#define ini_remove(filename)            (sceIoRemove((filename)) >= 0)
+/* The I/O calls go through ini_traceio(), which minIni.c redefines to trace
+ * them (INI_TRACE) */
+#ifndef ini_traceio
+  #define ini_traceio(name,expr)        (expr)
+#endif
+
+#define ini_openread(filename,file)     ini_traceio("openread", (*(file) = sceIoOpen((filename), PSP_O_RDONLY, 0777)) >= 0)
+#define ini_openwrite(filename,file)    ini_traceio("openwrite", (*(file) = sceIoOpen((filename), PSP_O_CREAT | PSP_O_TRUNC | PSP_O_WRONLY, 0777)) >= 0)
+#define ini_openrewrite(filename,file)  ini_traceio("openrewrite", (*(file) = sceIoOpen((filename), PSP_O_RDWR, 0777)) >= 0)
+#define ini_openappend(filename,file)   ini_traceio("openappend", (*(file) = sceIoOpen((filename), PSP_O_WRONLY | PSP_O_APPEND, 0777)) >= 0)
+#define ini_close(file)                 ini_traceio("close", sceIoClose(*(file)) >= 0)
+#define ini_read(buffer,size,file)      ini_traceio("read", psp_read_fgets((buffer), (size), (file)))
+#define ini_readblock(buffer,size,file) ini_traceio("readblock", sceIoRead(*(file), (buffer), (size)))
+#define ini_write(buffer,size,file)     ini_traceio("write", sceIoWrite(*(file), (buffer), (size)) > 0)
+#define ini_rename(source,dest)         ini_traceio("rename", sceIoRename((source), (dest)) >= 0)
+#define ini_remove(filename)            ini_traceio("remove", sceIoRemove((filename)) >= 0)
+#define ini_sync(device)                ini_traceio("sync", sceIoSync((device), 0) >= 0)
 
+/* file positions are 64-bit, so files above 2 GiB work */
 #define INI_FILEPOS                     SceOff
-#define ini_tell(file,pos)              ((*(pos) = sceIoLseek32(*(file), 0, PSP_SEEK_CUR)) >= 0)
-#define ini_seek(file,pos)              ((*(pos) = sceIoLseek32(*(file), *(pos), PSP_SEEK_SET)) >= 0)
+#define ini_tell(file,pos)              ini_traceio("tell", (*(pos) = sceIoLseek(*(file), 0, PSP_SEEK_CUR)) >= 0)
+#define ini_seek(file,pos)              ini_traceio("seek", (*(pos) = sceIoLseek(*(file), *(pos), PSP_SEEK_SET)) >= 0)
+#define ini_seekend(file,pos)           ini_traceio("seekend", (*(pos) = sceIoLseek(*(file), 0, PSP_SEEK_END)) >= 0)
+
+/* file status, for the sidecar index */
+#define INI_FILESTAT                    SceIoStat
+#define INI_FILETIME                    ScePspDateTime
+#define ini_stat(filename,stat)         ini_traceio("stat", sceIoGetstat((filename), (stat)) >= 0)
+#define ini_statsize(stat)              ((stat)->st_size)
+#define ini_statmtime(stat)             ((stat)->sce_st_mtime)
+
+#define ini_malloc(size)                malloc(size)
+#define ini_realloc(ptr,size)           realloc((ptr), (size))
+#define ini_free(ptr)                   free(ptr)
+
+/* memory ordering and waiting, for the published image */
+#define ini_barrier()                   __sync_synchronize()
+#define ini_yield()                     sceKernelDelayThread(0)
+
+#if defined(MININI_SHAREDIMAGE)
+/* POSIX shared memory for a published image (only on the host) */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define INI_SHMTYPE                     int
+#define INI_SHMSTAT                     struct stat
+#define ini_shmcreate(name,shm)         ((*(shm) = shm_open((name), O_RDWR | O_CREAT, 0666)) >= 0)
+#define ini_shmopen(name,shm)           ((*(shm) = shm_open((name), O_RDONLY, 0)) >= 0)
+#define ini_shmstat(shm,stat)           (fstat(*(shm), (stat)) == 0)
+#define ini_shmstatsize(stat)           ((SceSize)(stat)->st_size)
+#define ini_shmresize(shm,size)         (ftruncate(*(shm), (off_t)(size)) == 0)
+#define ini_shmmap(shm,size,writable,ptr) \
+  ((*(ptr) = mmap(NULL, (size), (writable) ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, *(shm), 0)) != MAP_FAILED)
+#define ini_shmunmap(ptr,size)          (munmap((void *)(ptr), (size)) == 0)
+#define ini_shmclose(shm)               (close(*(shm)) == 0)
+#define ini_shmremove(name)             (shm_unlink(name) == 0)
+#endif
+
+/* a lock that is taken without waiting, for the enumeration cursor */
+#define ini_trylock(lock)               (__sync_lock_test_and_set((lock), 1) == 0)
+#define ini_unlock(lock)                __sync_lock_release((lock))
+
+/* time in microseconds and the current thread, for the profiler and the trace */
+#define ini_clock()                     sceKernelGetSystemTimeWide()
+#define ini_threadid()                  sceKernelGetThreadId()
 
 #define ini_itoa(string,size,value)     snprintf((string), (size), "%i", (value))
 #define ini_utoa(string,size,value)     snprintf((string), (size), "%u", (value))
@@ -29,8 +29,18 @@
 #include <stdlib.h>
 
 #include "minIni.h"
+#if INI_TRACE
+  /* wrap the glue I/O calls in trace events */
+  static void trace_event(const char *category, const char *name, char phase);
+  static int trace_io(const char *name, int result);
+  #define ini_traceio(name,expr)  (trace_event("io", (name), 'B'), trace_io((name), (int)(expr)))
+#endif
 #include "minGlue.h"
 
+/* File positions must be 64 bits wide, so that files above 2 GiB work (the
+ * array has a negative size otherwise) */
+typedef char ini_fileposcheck[(sizeof(INI_FILEPOS) == 8) ? 1 : -1];
+
 /* Only compile asserts if INI_DEBUG is TRUE */
 #if INI_DEBUG
   #include <assert.h>
@@ -44,6 +54,14 @@ enum quote_option {
   QUOTE_DEQUOTE,
 };
 
+/* Where getkeystring() stopped scanning */
+enum scan_end {
+  SCAN_FOUND,       /* the key (or the indexed section/key) was found */
+  SCAN_NEXTSECTION, /* the key was not found, the next section was reached */
+  SCAN_EOF,         /* the key was not found, the section runs up to EOF */
+  SCAN_NOSECTION,   /* the section was not found */
+};
+
 /* Define strnicmp when PSPSDK LIBC doesn't provide it */
 #ifndef strnicmp
   /* If strncasecmp exists, just use it, otherwise, define it manually */
@@ -68,31 +86,269 @@ enum quote_option {
   #endif
 #endif
 
+/* The dialect (INI_COLONDELIM, INI_HASHCOMMENT, INI_QUOTES and
+ * INI_CASESENSITIVE): the cases that a dialect leaves out are removed at
+ * compile time */
+#if INI_HASHCOMMENT
+  #define is_comment(c)       ((c) == ';' || (c) == '#')
+#else
+  #define is_comment(c)       ((c) == ';')
+#endif
+#if INI_CASESENSITIVE
+  #define namencmp(s1,s2,n)   strncmp((s1), (s2), (n))
+#else
+  #define namencmp(s1,s2,n)   strnicmp((s1), (s2), (n))
+#endif
+/* The same with a case mode of the index or document (exact): namecasecmp()
+ * for zero-terminated names, and namememcmp() for names that are both at
+ * least n bytes long, which case-sensitive names compare with memcmp() */
+#define namecasecmp(s1,s2,n,exact)  ((exact) ? strncmp((s1), (s2), (n)) : strnicmp((s1), (s2), (n)))
+#define namememcmp(s1,s2,n,exact)   ((exact) ? memcmp((s1), (s2), (n)) : strnicmp((s1), (s2), (n)))
+
+#if INI_TRACE
+/* The trace goes to a caller-provided buffer, or to a file through a staging
+ * buffer. Events that the library emits while it writes the trace itself
+ * (the glue I/O of the file sink) are suppressed. The trace state is not
+ * protected against concurrent use.
+ */
+static struct {
+  SceBool   active;
+  SceBool   busy;       /* the trace itself is being written */
+  SceBool   full;       /* the buffer is full, further events are dropped */
+  SceBool   first;      /* no event has been written yet */
+  char      *buffer;    /* memory sink */
+  SceSize   size, used;
+  SceBool   tofile;     /* file sink */
+  INI_FILETYPE fd;
+  char      stage[INI_BUFFERSIZE];
+  SceSize   staged;
+  SceSize   written;
+  SceUInt32 dropped;
+} trace;
+
+static SceBool trace_flush(void)
+{
+  SceBool ok = (trace.staged == 0 || ini_write(trace.stage, trace.staged, &trace.fd));
+  trace.written += trace.staged;
+  trace.staged = 0;
+  return ok;
+}
+
+/* Append text to the sink; the memory sink keeps room for the closing "]" */
+static SceBool trace_emit(const char *text, SceSize len)
+{
+  if (trace.tofile) {
+    if (trace.staged + len > sizeof(trace.stage) && !trace_flush())
+      return INI_FALSE;
+    memcpy(trace.stage + trace.staged, text, len);
+    trace.staged += len;
+    return INI_TRUE;
+  }
+  if (trace.full || trace.used + len + 4 > trace.size) {
+    trace.full = INI_TRUE;
+    return INI_FALSE;
+  }
+  memcpy(trace.buffer + trace.used, text, len);
+  trace.used += len;
+  return INI_TRUE;
+}
+
+static SceSize trace_number(char *dest, SceUInt64 value)
+{
+  char digits[20];
+  SceSize n = 0, len = 0;
+  do {
+    digits[n++] = (char)('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+  while (n > 0)
+    dest[len++] = digits[--n];
+  return len;
+}
+
+static SceSize trace_string(char *dest, const char *text)
+{
+  SceSize len = (SceSize)strlen(text);
+  memcpy(dest, text, len);
+  return len;
+}
+
+/* Write a trace event; phase is 'B' (begin) or 'E' (end) */
+static void trace_event(const char *category, const char *name, char phase)
+{
+  char line[128];
+  SceSize len = 0;
+
+  if (!trace.active || trace.busy)
+    return;
+  trace.busy = INI_TRUE;
+  if (!trace.first)
+    line[len++] = ',';
+  len += trace_string(line + len, INI_LINETERM "{\"name\":\"");
+  len += trace_string(line + len, name);
+  len += trace_string(line + len, "\",\"cat\":\"");
+  len += trace_string(line + len, category);
+  len += trace_string(line + len, "\",\"ph\":\"");
+  line[len++] = phase;
+  len += trace_string(line + len, "\",\"pid\":0,\"tid\":");
+  len += trace_number(line + len, (SceUInt64)(SceUInt32)ini_threadid());
+  len += trace_string(line + len, ",\"ts\":");
+  len += trace_number(line + len, ini_clock());
+  line[len++] = '}';
+  if (trace_emit(line, len))
+    trace.first = INI_FALSE;
+  else
+    trace.dropped++;
+  trace.busy = INI_FALSE;
+}
+
+/* End the trace event of a glue I/O call and pass on its result */
+static int trace_io(const char *name, int result)
+{
+  trace_event("io", name, 'E');
+  return result;
+}
+
+static void trace_begin(void)
+{
+  trace.active = INI_TRUE;
+  trace.full = INI_FALSE;
+  trace.first = INI_TRUE;
+  trace.dropped = 0;
+  trace.busy = INI_TRUE;
+  (void)trace_emit("[", 1);
+  trace.busy = INI_FALSE;
+}
+
+/** ini_trace_start()
+ * \param Buffer      the buffer that receives the trace, as JSON text
+ * \param BufferSize  the size of the buffer
+ *
+ * Starts tracing all API calls and glue I/O calls as Chrome trace events
+ * (begin/end pairs with the thread ID and a timestamp in microseconds). When
+ * the buffer is full, further events are dropped. A trace that was already
+ * running is stopped first.
+ *
+ * \return            1 on success, 0 if the buffer is too small
+ */
+SceBool ini_trace_start(char *Buffer, SceSize BufferSize)
+{
+  if (Buffer == NULL || BufferSize < 8)
+    return INI_FALSE;
+  (void)ini_trace_stop();
+  trace.buffer = Buffer;
+  trace.size = BufferSize;
+  trace.used = 0;
+  trace.tofile = INI_FALSE;
+  trace_begin();
+  return INI_TRUE;
+}
+
+/** ini_trace_startfile()
+ * \param Filename    the name and full path of the file that receives the trace
+ *
+ * Starts tracing, like ini_trace_start(), to a file.
+ *
+ * \return            1 on success, 0 if the file cannot be created
+ */
+SceBool ini_trace_startfile(const char *Filename)
+{
+  assert(Filename != NULL);
+  (void)ini_trace_stop();
+  if (!ini_openwrite(Filename, &trace.fd))
+    return INI_FALSE;
+  trace.tofile = INI_TRUE;
+  trace.staged = trace.written = 0;
+  trace_begin();
+  return INI_TRUE;
+}
+
+/** ini_trace_stop()
+ * Stops tracing and closes the JSON array; a trace in a buffer is
+ * zero-terminated.
+ *
+ * \return            the size of the trace in bytes, 0 if no trace was running
+ */
+SceSize ini_trace_stop(void)
+{
+  SceSize size;
+
+  if (!trace.active)
+    return 0;
+  trace.active = INI_FALSE;
+  trace.busy = INI_TRUE;
+  if (trace.tofile) {
+    (void)trace_emit(INI_LINETERM "]" INI_LINETERM, sizeof(INI_LINETERM "]" INI_LINETERM) - 1);
+    (void)trace_flush();
+    (void)ini_close(&trace.fd);
+    size = trace.written;
+  } else {
+    /* trace_emit() kept room for the closing bracket */
+    memcpy(trace.buffer + trace.used, INI_LINETERM "]", sizeof(INI_LINETERM "]"));
+    trace.used += sizeof(INI_LINETERM "]") - 1;
+    size = trace.used;
+  }
+  trace.busy = INI_FALSE;
+  return size;
+}
+
+/** ini_trace_dropped()
+ *
+ * \return            the number of events of the current (or last) trace
+ *                    that were dropped, because the buffer was full or the
+ *                    file could not be written
+ */
+SceUInt32 ini_trace_dropped(void)
+{
+  return trace.dropped;
+}
+
+  #define TRACE_BEGIN(name)   trace_event("api", (name), 'B')
+  #define TRACE_END(name)     trace_event("api", (name), 'E')
+#else
+  #define TRACE_BEGIN(name)
+  #define TRACE_END(name)
+#endif /* INI_TRACE */
+
 /* Mimic fgets behavior with PSPSDK functions
  * Returns the equivalent to: fgets(...) != NULL
  * Big thanks go to Freakler for his code: https://github.com/Freakler/CheatDeviceRemastered/blob/d537e30f6fb927cc873e5756c7a4afe07c267c93/source/minIni.c#L96
  */
 SceBool psp_read_fgets(char *s, SceSize n, INI_FILETYPE *stream)
 {
+  SceSize len = 0, chunk = 64;
+  char *eol = NULL;
+  int bytes_read;
+
   assert(n != 0 && s != NULL && stream != NULL);
 
-  int bytes_read = sceIoRead(*stream, s, n - 1);
+  /* Read in chunks that double in size, so that the bytes read beyond the
+   * newline (and seeked back over) are at most one chunk: short lines do not
+   * read a full buffer each */
+  while (len < n - 1) {
+    if (chunk > n - 1 - len)
+      chunk = n - 1 - len;
+    bytes_read = sceIoRead(*stream, s + len, chunk);
+    if (bytes_read <= 0)
+      break;
+    eol = (char *)memchr(s + len, INI_LINETERMCHAR, bytes_read);
+    len += bytes_read;
+    if (eol != NULL || (SceSize)bytes_read < chunk)
+      break;
+    chunk = len;
+  }
 
   /* If nothing was read or it errored out, fgets returns NULL */
-  if ( bytes_read <= 0 ) return INI_FALSE;
-
-  /* Read until newline (or until string end if newline isn't found) */
-  int i = 0;
-  while( i < bytes_read )
-  {
-    if( s[i++] == INI_LINETERMCHAR ) break;
-  }
+  if (len == 0)
+    return INI_FALSE;
 
+  /* The line runs up to and including the newline (or up to the data read) */
+  SceSize i = (eol != NULL) ? (SceSize)(eol - s) + 1 : len;
   s[i] = '\0';
 
   /* If string goes beyond newline, seek back */
-  if ( bytes_read > i )
-    sceIoLseek32(*stream, -(bytes_read - i), PSP_SEEK_CUR);
+  if (len > i)
+    sceIoLseek(*stream, -(SceOff)(len - i), PSP_SEEK_CUR);
 
   return INI_TRUE;
 }
@@ -122,6 +378,17 @@ static char *striptrailing(char *str)
   return str;
 }
 
+/* Return the '=' (or ':') between a key and its value, or NULL */
+static char *finddelimiter(const char *str)
+{
+  char *ep = strchr(str, '=');
+#if INI_COLONDELIM
+  if (ep == NULL)
+    ep = strchr(str, ':');
+#endif
+  return ep;
+}
+
 static char *ini_strncpy(char *dest, const char *source, SceSize maxlen, enum quote_option option)
 {
   SceUInt d, s;
@@ -178,7 +445,8 @@ static char *cleanstring(char *string, enum quote_option *quotes)
 
   /* Remove a trailing comment */
   isstring = 0;
-  for (ep = string; *ep != '\0' && ((*ep != ';' && *ep != '#') || isstring); ep++) {
+  for (ep = string; *ep != '\0' && (!is_comment(*ep) || isstring); ep++) {
+#if INI_QUOTES
     if (*ep == '"') {
       if (*(ep + 1) == '"')
         ep++;                 /* skip "" (both quotes) */
@@ -187,23 +455,373 @@ static char *cleanstring(char *string, enum quote_option *quotes)
     } else if (*ep == '\\' && *(ep + 1) == '"') {
       ep++;                   /* skip \" (both quotes */
     }
+#endif
   }
-  assert(ep != NULL && (*ep == '\0' || *ep == ';' || *ep == '#'));
+  assert(ep != NULL && (*ep == '\0' || is_comment(*ep)));
   *ep = '\0';                 /* terminate at a comment */
   striptrailing(string);
   /* Remove double quotes surrounding a value */
   *quotes = QUOTE_NONE;
+#if INI_QUOTES
   if (*string == '"' && (ep = strchr(string, '\0')) != NULL && *(ep - 1) == '"') {
     string++;
     *--ep = '\0';
     *quotes = QUOTE_DEQUOTE;  /* this is a string, so remove escaped characters */
   }
+#endif
   return string;
 }
 
+#if INI_BROWSE || INI_LAZYINDEX || INI_SIDECAR
+#define SWAR_ONES       ((unsigned long)-1 / 0xff)
+#define SWAR_HIGHS      (SWAR_ONES * 0x80)
+#define swar_haszero(w) (((w) - SWAR_ONES) & ~(w) & SWAR_HIGHS)
+
+/* Return the offset of the first line terminator in the buffer (or len if
+ * there is none); the buffer is scanned a word at a time.
+ */
+static SceSize scan_lineterm(const char *buffer, SceSize len)
+{
+  const unsigned long pattern = SWAR_ONES * (unsigned char)INI_LINETERMCHAR;
+  SceSize i = 0;
+
+  while (i + sizeof(unsigned long) <= len) {
+    unsigned long w;
+    memcpy(&w, buffer + i, sizeof(w));  /* no unaligned loads */
+    if (swar_haszero(w ^ pattern))
+      break;
+    i += sizeof(w);
+  }
+  while (i < len && buffer[i] != INI_LINETERMCHAR)
+    i++;
+  return i;
+}
+
+#if INI_BROWSE || INI_LAZYINDEX
+/* Add the next part of a line from the data to the line buffer, which holds
+ * "used" bytes: up to and including the line terminator, or up to a full
+ * buffer, which is where ini_read() splits a line that is too long. Returns
+ * the number of bytes taken; "complete" is set when the line is complete.
+ */
+static SceSize take_line(char *line, SceSize *used, const char *data, SceSize len, SceBool *complete)
+{
+  SceSize room = INI_BUFFERSIZE - 1 - *used;
+  SceSize n = scan_lineterm(data, (len < room) ? len : room);
+
+  *complete = (n < len && n < room);
+  if (*complete)
+    n++;                  /* include the line terminator, like ini_read() */
+  memcpy(line + *used, data, n);
+  *used += n;
+  if (*used == INI_BUFFERSIZE - 1)
+    *complete = INI_TRUE;
+  return n;
+}
+#endif
+#endif
+
+#if INI_LAZYINDEX || INI_SIDECAR || INI_VERSIONS || INI_IMAGE || INI_PROFILE
+/* FNV-1a over the case-folded name, or over the name as is when exact */
+static SceUInt32 ini_hashcase(const char *name, SceSize len, SceBool exact)
+{
+  SceUInt32 hash = 2166136261u;
+  while (len-- > 0) {
+    int c = *name++;
+    if (!exact && 'a' <= c && c <= 'z')
+      c += ('A' - 'a');
+    hash = (hash ^ (SceUInt32)(unsigned char)c) * 16777619u;
+  }
+  return hash;
+}
+
+#define ini_hash(name,len)  ini_hashcase((name), (len), INI_CASESENSITIVE)
+#endif
+
+#if INI_PINGPONG || INI_SIDECAR
+static SceUInt32 adler32(SceUInt32 sum, const unsigned char *data, SceSize len)
+{
+  SceUInt32 a = sum & 0xffff, b = sum >> 16;
+
+  while (len > 0) {
+    SceSize n = (len < 5552) ? len : 5552; /* largest block for which b cannot overflow */
+    len -= n;
+    while (n-- > 0) {
+      a += *data++;
+      b += a;
+    }
+    a %= 65521;
+    b %= 65521;
+  }
+  return (b << 16) | a;
+}
+#endif
+
+#if INI_PINGPONG
+/* Every commit writes the complete INI file to one of two slot files
+ * (Filename.a and Filename.b), alternating between the two. The last line of
+ * a slot file is a comment with the sequence number of the commit and a
+ * checksum over all data before it. A torn write fails the checksum, so the
+ * current slot is the valid one with the highest sequence number.
+ */
+#define SLOT_TAG      ";@slot "
+#define SLOT_TAGLEN   7
+#define SLOT_SIZE     (SLOT_TAGLEN + 17 + sizeof(INI_LINETERM) - 1)  /* tag, 2x 8 hex digits + space, line terminator */
+
+static void slot_name(char *dest, const char *Filename, char slot, SceSize maxlength)
+{
+  char *p;
+
+  assert(maxlength > 2);
+  ini_strncpy(dest, Filename, maxlength - 2, QUOTE_NONE);
+  p = strchr(dest, '\0');
+  assert(p != NULL);
+  *p++ = '.';
+  *p++ = slot;
+  *p = '\0';
+}
+
+/* Calculate the checksum over the first "len" bytes of the file; optionally
+ * return the last of these bytes.
+ */
+static SceBool slot_sum(INI_FILETYPE *fd, INI_FILEPOS len, SceUInt32 *sum, char *last)
+{
+  unsigned char LocalBuffer[INI_BUFFERSIZE];
+  INI_FILEPOS pos = 0;
+
+  *sum = 1;
+  if (last != NULL)
+    *last = INI_LINETERMCHAR;
+  (void)ini_seek(fd, &pos);
+  while (len > 0) {
+    int n = ini_readblock(LocalBuffer, (len < INI_BUFFERSIZE) ? (SceSize)len : INI_BUFFERSIZE, fd);
+    if (n <= 0)
+      return INI_FALSE;
+    *sum = adler32(*sum, LocalBuffer, (SceSize)n);
+    if (last != NULL)
+      *last = (char)LocalBuffer[n - 1];
+    len -= n;
+  }
+  return INI_TRUE;
+}
+
+static SceBool slot_trailer(INI_FILETYPE *fd, SceUInt32 *seq, SceUInt32 *sum, INI_FILEPOS *len)
+{
+  char LocalBuffer[SLOT_SIZE + 1];
+  char *ep;
+
+  if (!ini_seekend(fd, len) || *len < (INI_FILEPOS)SLOT_SIZE)
+    return INI_FALSE;
+  *len -= SLOT_SIZE;
+  (void)ini_seek(fd, len);
+  if (ini_readblock(LocalBuffer, SLOT_SIZE, fd) != (int)SLOT_SIZE)
+    return INI_FALSE;
+  LocalBuffer[SLOT_SIZE] = '\0';
+  if (strncmp(LocalBuffer, SLOT_TAG, SLOT_TAGLEN) != 0)
+    return INI_FALSE;
+  *seq = (SceUInt32)strtoul(LocalBuffer + SLOT_TAGLEN, &ep, 16);
+  if (*ep != ' ')
+    return INI_FALSE;
+  *sum = (SceUInt32)strtoul(ep + 1, &ep, 16);
+  return strcmp(ep, INI_LINETERM) == 0;
+}
+
+/* Open the current slot for reading. Only the trailers of both slots are read
+ * up front; the checksum of the newest slot is verified, and only if that slot
+ * is torn, the other one is verified too.
+ * Returns the slot letter ('a' or 'b'), or '\0' if there is no valid slot.
+ */
+static char slot_openread(const char *Filename, INI_FILETYPE *fd, SceUInt32 *seq)
+{
+  char name[INI_BUFFERSIZE];
+  INI_FILETYPE sfd[2];
+  SceUInt32 seqs[2], sums[2];
+  INI_FILEPOS lens[2], pos;
+  SceBool valid[2];
+  char slot = '\0';
+  int i, idx;
+
+  for (i = 0; i < 2; i++) {
+    slot_name(name, Filename, (char)('a' + i), sizeof(name));
+    valid[i] = ini_openread(name, &sfd[i]);
+    if (valid[i] && !slot_trailer(&sfd[i], &seqs[i], &sums[i], &lens[i])) {
+      (void)ini_close(&sfd[i]);
+      valid[i] = INI_FALSE;
+    }
+  }
+  idx = (valid[1] && (!valid[0] || (SceInt32)(seqs[1] - seqs[0]) > 0)) ? 1 : 0;
+  for (i = 0; i < 2; i++, idx = 1 - idx) {
+    SceUInt32 sum;
+    if (!valid[idx])
+      continue;
+    if (slot == '\0' && slot_sum(&sfd[idx], lens[idx], &sum, NULL) && sum == sums[idx]) {
+      slot = (char)('a' + idx);
+      *fd = sfd[idx];
+      if (seq != NULL)
+        *seq = seqs[idx];
+      pos = 0;
+      (void)ini_seek(fd, &pos);
+    } else {
+      (void)ini_close(&sfd[idx]);
+    }
+  }
+  return slot;
+}
+
+/* The trailer is the last line of a slot file; reading it means reading EOF.
+ * A line that starts like the trailer is only the trailer if it starts at
+ * SLOT_SIZE bytes before the end of the file, so a comment that happens to
+ * look like it is read as a comment.
+ */
+static SceBool slot_readline(char *buffer, SceSize size, INI_FILETYPE *fd)
+{
+  INI_FILEPOS pos, end;
+
+  if (!ini_read(buffer, size, fd))
+    return INI_FALSE;
+  if (strncmp(buffer, SLOT_TAG, SLOT_TAGLEN) != 0)
+    return INI_TRUE;
+  if (!ini_tell(fd, &pos) || !ini_seekend(fd, &end))
+    return INI_FALSE;
+  (void)ini_seek(fd, &pos);
+  return pos - (INI_FILEPOS)strlen(buffer) != end - (INI_FILEPOS)SLOT_SIZE;
+}
+
+#define ini_readsrc(buffer,size,file)   slot_readline((buffer), (size), (file))
+#else
+#define ini_readsrc(buffer,size,file)   ini_read((buffer), (size), (file))
+#endif /* INI_PINGPONG */
+
+#if INI_CONTINUATION
+/* Skip the rest of a line that did not fit in the buffer; returns its last
+ * character (before the line terminator) */
+static char skip_line(INI_FILETYPE *fd)
+{
+  char Peek[16];
+  char last = '\0';
+  SceSize n, len;
+
+  while (ini_readsrc(Peek, sizeof(Peek), fd)) {
+    len = n = (SceSize)strlen(Peek);
+    while (n > 0 && (Peek[n - 1] == INI_LINETERMCHAR || Peek[n - 1] == '\r'))
+      n--;
+    if (n > 0)
+      last = Peek[n - 1];
+    if (len > 0 && Peek[len - 1] == INI_LINETERMCHAR)
+      break;
+  }
+  return last;
+}
+
+/* Whether the next line is indented and holds a value; the read position is
+ * left at the start of the line */
+static SceBool next_indented(INI_FILETYPE *fd)
+{
+  char Peek[16];
+  INI_FILEPOS pos;
+  SceBool indented = INI_FALSE;
+  SceSize len;
+  char *sp;
+
+  if (!ini_tell(fd, &pos))
+    return INI_FALSE;
+  if (ini_readsrc(Peek, sizeof(Peek), fd) && (Peek[0] == ' ' || Peek[0] == '\t')) {
+    for ( ;; ) {
+      sp = skipleading(Peek);
+      if (*sp != '\0') {
+        indented = (*sp != '[' && !is_comment(*sp));
+        break;
+      }
+      len = (SceSize)strlen(Peek);
+      if (len == 0 || Peek[len - 1] == INI_LINETERMCHAR || !ini_readsrc(Peek, sizeof(Peek), fd))
+        break;    /* a blank line */
+    }
+  }
+  (void)ini_seek(fd, &pos);
+  return indented;
+}
+
+/* Read a line; a key line is joined with the lines that continue it. A line
+ * that ends with a backslash goes on with the next line (the backslash and
+ * the line terminator are dropped), and an indented line is added to the
+ * value on a new line (without the indent). The lines are joined in the
+ * buffer itself; a value that does not fit is truncated, and the rest of its
+ * lines are skipped.
+ */
+static SceBool ini_readjoined(char *buffer, SceSize size, INI_FILETYPE *fd)
+{
+  SceSize start, len = 0;
+  SceBool truncated = INI_FALSE, indented = INI_FALSE;
+  char last = '\0', *sp;
+
+  if (!ini_readsrc(buffer, size, fd))
+    return INI_FALSE;
+  sp = skipleading(buffer);
+  if (*sp == '[' || is_comment(*sp) || finddelimiter(sp) == NULL)
+    return INI_TRUE;    /* only a key line is continued */
+  for ( ;; ) {
+    /* take in the line that was read at buffer + start */
+    start = len;
+    len += (SceSize)strlen(buffer + start);
+    if (len + 1 == size && buffer[len - 1] != INI_LINETERMCHAR) {
+      truncated = INI_TRUE;
+      last = skip_line(fd);
+    }
+    if (indented) {
+      sp = skipleading(buffer + start);
+      memmove(buffer + start, sp, strlen(sp) + 1);
+      len = start + (SceSize)strlen(buffer + start);
+    }
+    if (!truncated) {
+      while (len > start && (buffer[len - 1] == INI_LINETERMCHAR || buffer[len - 1] == '\r'))
+        len--;
+      last = (len > start) ? buffer[len - 1] : '\0';
+    }
+    buffer[len] = '\0';
+    /* find the line that continues it; it is skipped if there is no room */
+    for ( ;; ) {
+      if (last == '\\') {
+        if (!truncated)
+          buffer[--len] = '\0';
+        indented = INI_FALSE;
+      } else if (next_indented(fd)) {
+        indented = INI_TRUE;
+      } else {
+        return INI_TRUE;
+      }
+      if (!truncated && len + (indented ? 3 : 2) <= size)
+        break;
+      truncated = INI_TRUE;
+      last = skip_line(fd);
+    }
+    if (indented)
+      buffer[len++] = '\n';
+    if (!ini_readsrc(buffer + len, size - len, fd)) {
+      buffer[indented ? --len : len] = '\0';
+      return INI_TRUE;
+    }
+  }
+}
+
+  #define ini_readline(buffer,size,file)      ini_readjoined((buffer), (size), (file))
+  #define ini_readsrcline(buffer,size,file)   ini_readjoined((buffer), (size), (file))
+#else
+  #define ini_readline(buffer,size,file)      ini_read((buffer), (size), (file))
+  #define ini_readsrcline(buffer,size,file)   ini_readsrc((buffer), (size), (file))
+#endif /* INI_CONTINUATION */
+
+/* Open the INI file for reading; with INI_PINGPONG, this opens the current slot */
+static SceBool ini_opensource(const char *Filename, INI_FILETYPE *fd)
+{
+#if INI_PINGPONG
+  return slot_openread(Filename, fd, NULL) != '\0';
+#else
+  return ini_openread(Filename, fd);
+#endif
+}
+
 static SceBool getkeystring(INI_FILETYPE *fd, const char *Section, const char *Key,
                         int idxSection, int idxKey, char *Buffer, SceSize BufferSize,
-                        INI_FILEPOS *mark)
+                        INI_FILEPOS *mark, enum scan_end *end)
 {
   char *sp, *ep;
   SceSize len;
@@ -212,6 +830,8 @@ static SceBool getkeystring(INI_FILETYPE *fd, const char *Section, const char *K
   char LocalBuffer[INI_BUFFERSIZE];
 
   assert(fd != NULL);
+  if (end != NULL)
+    *end = SCAN_FOUND;
   /* Move through file 1 line at a time until a section is matched or EOF. If
    * parameter Section is NULL, only look at keys above the first section. If
    * idxSection is positive, copy the relevant section name.
@@ -222,8 +842,13 @@ static SceBool getkeystring(INI_FILETYPE *fd, const char *Section, const char *K
     idx = -1;
     do {
       do {
-        if (!ini_read(LocalBuffer, INI_BUFFERSIZE, fd))
+        if (!ini_readline(LocalBuffer, INI_BUFFERSIZE, fd)) {
+          if (mark != NULL)
+            (void)ini_tell(fd, mark); /* the mark is left at EOF */
+          if (end != NULL)
+            *end = SCAN_NOSECTION;
           return INI_FALSE;
+        }
         sp = skipleading(LocalBuffer);
         ep = strrchr(sp, ']');
       } while (*sp != '[' || ep == NULL);
@@ -234,7 +859,7 @@ static SceBool getkeystring(INI_FILETYPE *fd, const char *Section, const char *K
       sp = skipleading(sp + 1);
       assert(ep != NULL && *ep == ']');
       ep = skiptrailing(ep, sp);
-    } while ((((SceUInt)(ep-sp) != len || Section == NULL || strnicmp(sp, Section, len) != 0) && ++idx != idxSection));
+    } while ((((SceUInt)(ep-sp) != len || Section == NULL || namememcmp(sp, Section, len, INI_CASESENSITIVE) != 0) && ++idx != idxSection));
     if (idxSection >= 0) {
       if (idx == idxSection) {
         assert(ep != NULL);
@@ -255,14 +880,20 @@ static SceBool getkeystring(INI_FILETYPE *fd, const char *Section, const char *K
   do {
     if (mark != NULL)
       (void)ini_tell(fd, mark);   /* optionally keep the mark to the start of the line */
-    if (!ini_read(LocalBuffer,INI_BUFFERSIZE,fd) || *(sp = skipleading(LocalBuffer)) == '[')
+    if (!ini_readline(LocalBuffer, INI_BUFFERSIZE, fd)) {
+      if (end != NULL)
+        *end = SCAN_EOF;
+      return INI_FALSE;
+    }
+    if (*(sp = skipleading(LocalBuffer)) == '[') {
+      if (end != NULL)
+        *end = SCAN_NEXTSECTION;
       return INI_FALSE;
+    }
     sp = skipleading(LocalBuffer);
-    ep = strchr(sp, '=');  /* Parse out the equal sign */
-    if (ep == NULL)
-      ep = strchr(sp, ':');
-  } while (*sp == ';' || *sp == '#' || ep == NULL
-           || ((len == 0 || (SceUInt)(skiptrailing(ep,sp)-sp) != len || strnicmp(sp,Key,len) != 0) && ++idx != idxKey));
+    ep = finddelimiter(sp);  /* Parse out the equal sign */
+  } while (is_comment(*sp) || ep == NULL
+           || ((len == 0 || (SceUInt)(skiptrailing(ep,sp)-sp) != len || namememcmp(sp, Key, len, INI_CASESENSITIVE) != 0) && ++idx != idxKey));
   if (idxKey >= 0) {
     if (idx == idxKey) {
       assert(ep != NULL);
@@ -284,48 +915,839 @@ static SceBool getkeystring(INI_FILETYPE *fd, const char *Section, const char *K
   return INI_TRUE;
 }
 
-/** ini_gets()
- * \param Section     the name of the section to search for
- * \param Key         the name of the entry to find the value of
- * \param DefValue    default string in the event of a failed read
- * \param Buffer      a pointer to the buffer to copy into
- * \param BufferSize  the maximum number of characters to copy
- * \param Filename    the name and full path of the .ini file to read from
- *
- * \return            the number of characters copied into the supplied buffer
+#if INI_SIDECAR
+/* The sidecar index (Filename.idx) holds a record for every key in the INI
+ * file, sorted on the hashes of the case-folded section and key names, with
+ * the offsets of the line of the key and of the header of its section. The
+ * hashes only narrow the search: a lookup checks the names in both lines, and
+ * it falls back to scanning the INI file when they do not match. The header
+ * has the size, the modification time and the checksum of the INI file when
+ * the sidecar was last brought up to date. Keys appended by ini_puts() are
+ * added as unsorted overflow records behind the sorted records.
  */
-SceSize ini_gets(const char *Section, const char *Key, const char *DefValue,
-             char *Buffer, SceSize BufferSize, const char *Filename)
+#define SIDECAR_MAGIC     "mIdx"
+#define SIDECAR_VERSION   2
+
+typedef struct {
+  char      magic[4];
+  SceUInt32 version;
+  SceUInt32 count;      /* number of sorted records */
+  SceUInt32 overflow;   /* number of unsorted records that follow */
+  SceOff    size;       /* size of the INI file */
+  INI_FILETIME mtime;   /* modification time of the INI file */
+  SceUInt32 hash;       /* Adler-32 checksum of the INI file */
+  SceUInt32 reserved;
+} SIDECAR_HEADER;
+
+typedef struct {
+  SceUInt32 section;    /* hash of the section name */
+  SceUInt32 key;        /* hash of the key name */
+  SceOff    offset;     /* offset of the line with the key */
+  SceOff    header;     /* offset of the section header, -1 above the first section */
+} SIDECAR_RECORD;
+
+#define SIDECAR_NOHEADER  ((SceOff)-1)
+#define SIDECAR_UNKNOWN   ((SceOff)-2)  /* for ini_puts(): the header is looked up in the sidecar */
+
+static void sidecar_name(char *dest, const char *Filename, SceSize maxlength)
 {
-  INI_FILETYPE fd;
-  SceBool ok = INI_FALSE;
+  assert(maxlength > 4);
+  ini_strncpy(dest, Filename, maxlength - 4, QUOTE_NONE);
+  strcat(dest, ".idx");
+}
 
-  if (Buffer == NULL || BufferSize <= 0 || Key == NULL)
-    return INI_FALSE;
-  if (ini_openread(Filename, &fd)) {
-    ok = getkeystring(&fd, Section, Key, -1, -1, Buffer, BufferSize, NULL);
-    (void)ini_close(&fd);
-  }
-  if (!ok)
-    ini_strncpy(Buffer, (DefValue != NULL) ? DefValue : "", BufferSize, QUOTE_NONE);
-  return (SceSize)strlen(Buffer);
+static int sidecar_compare(const void *a, const void *b)
+{
+  const SIDECAR_RECORD *ra = (const SIDECAR_RECORD *)a;
+  const SIDECAR_RECORD *rb = (const SIDECAR_RECORD *)b;
+  if (ra->section != rb->section)
+    return (ra->section < rb->section) ? -1 : 1;
+  if (ra->key != rb->key)
+    return (ra->key < rb->key) ? -1 : 1;
+  if (ra->offset != rb->offset)
+    return (ra->offset < rb->offset) ? -1 : 1;
+  return 0;
 }
 
-/** ini_geti()
- * \param Section     the name of the section to search for
- * \param Key         the name of the entry to find the value of
- * \param DefValue    the default value in the event of a failed read
- * \param Filename    the name of the .ini file to read from
- *
- * \return            the value located at Key
+typedef struct {
+  SceUInt32 hash;       /* hash of the section name */
+  SceUInt32 name;       /* offset of the section name in the name pool */
+} SIDECAR_SEEN;
+
+typedef struct {
+  SIDECAR_RECORD *records;
+  SceUInt32 count, capacity;
+  SIDECAR_SEEN *seen;   /* the sections found so far */
+  SceUInt32 seencount, seencapacity;
+  SceUInt32 *slots;     /* hash set of seen[]: an index plus 1, or 0 for an empty slot */
+  SceUInt32 slotmask;   /* number of slots minus 1 */
+  char      *names;     /* name pool of the sections found so far */
+  SceSize   namesize, namecapacity;
+  SceUInt32 section;    /* hash of the current section */
+  SceOff    header;     /* offset of the header of the current section */
+  SceBool   insection;  /* false after a '[' line that is not a (first) section */
+} SIDECAR_BUILD;
+
+/* Return the slot of the section with the name, or the empty slot where it
+ * goes; the hash set is never more than half full */
+static SceUInt32 sidecar_seenslot(const SIDECAR_BUILD *build, SceUInt32 hash, const char *name, SceSize len)
+{
+  SceUInt32 slot, i;
+
+  for (slot = hash & build->slotmask; (i = build->slots[slot]) != 0; slot = (slot + 1) & build->slotmask)
+    if (build->seen[i - 1].hash == hash && strlen(build->names + build->seen[i - 1].name) == len
+        && namememcmp(build->names + build->seen[i - 1].name, name, len, INI_CASESENSITIVE) == 0)
+      break;
+  return slot;
+}
+
+/* Only the first section with a name is searched (as in getkeystring()), so
+ * the keys of a repeated section are not recorded. The names are compared,
+ * not only the hashes: another section with the same hash is not a repeat.
+ * Returns 1 for a new section, 0 for a repeated one, and -1 when there is not
+ * enough memory.
  */
-int ini_geti(const char *Section, const char *Key, int DefValue, const char *Filename)
+static int sidecar_newsection(SIDECAR_BUILD *build, const char *name, SceSize len)
 {
-  char LocalBuffer[16];
-  SceSize len = ini_gets(Section, Key, "", LocalBuffer, sizeof(LocalBuffer), Filename);
-  return (len == 0) ? DefValue
-                    : ((len >= 2 && (LocalBuffer[1] == 'x' || LocalBuffer[1] == 'X')) ? (int)strtol(LocalBuffer, NULL, 16)
-                                                                           : (int)strtol(LocalBuffer, NULL, 10));
+  SceUInt32 i, slot, hash = ini_hash(name, len);
+
+  if (build->slots != NULL && build->slots[sidecar_seenslot(build, hash, name, len)] != 0)
+    return 0;
+  if (build->seencount == build->seencapacity) {
+    SceUInt32 capacity = (build->seencapacity > 0) ? 2 * build->seencapacity : 32;
+    SIDECAR_SEEN *seen = (SIDECAR_SEEN *)ini_realloc(build->seen, capacity * sizeof(SIDECAR_SEEN));
+    SceUInt32 *slots;
+    if (seen == NULL)
+      return -1;
+    build->seen = seen;
+    build->seencapacity = capacity;
+    /* rebuild the hash set with twice as many slots as sections */
+    slots = (SceUInt32 *)ini_malloc(2 * capacity * sizeof(SceUInt32));
+    if (slots == NULL)
+      return -1;
+    memset(slots, 0, 2 * capacity * sizeof(SceUInt32));
+    if (build->slots != NULL)
+      ini_free(build->slots);
+    build->slots = slots;
+    build->slotmask = 2 * capacity - 1;
+    for (i = 0; i < build->seencount; i++) {
+      for (slot = build->seen[i].hash & build->slotmask; slots[slot] != 0; slot = (slot + 1) & build->slotmask)
+        /* nothing */;
+      slots[slot] = i + 1;
+    }
+  }
+  if (build->namesize + len + 1 > build->namecapacity) {
+    SceSize capacity = (build->namecapacity > 0) ? 2 * build->namecapacity : 512;
+    char *names;
+    while (build->namesize + len + 1 > capacity)
+      capacity *= 2;
+    names = (char *)ini_realloc(build->names, capacity);
+    if (names == NULL)
+      return -1;
+    build->names = names;
+    build->namecapacity = capacity;
+  }
+  memcpy(build->names + build->namesize, name, len);
+  build->names[build->namesize + len] = '\0';
+  build->seen[build->seencount].hash = hash;
+  build->seen[build->seencount].name = (SceUInt32)build->namesize;
+  slot = sidecar_seenslot(build, hash, name, len);
+  build->slots[slot] = ++build->seencount;
+  build->namesize += len + 1;
+  return 1;
+}
+
+/* Add the line at the given offset to the records, if it is a key */
+static SceBool sidecar_line(SIDECAR_BUILD *build, char *line, INI_FILEPOS offset)
+{
+  SIDECAR_RECORD *rec;
+  char *sp, *ep;
+  int n;
+
+  sp = skipleading(line);
+  if (*sp == '[') {
+    /* any '[' line ends a section, but only a valid one starts a new one */
+    build->insection = INI_FALSE;
+    if ((ep = strrchr(sp, ']')) != NULL) {
+      sp = skipleading(sp + 1);
+      ep = skiptrailing(ep, sp);
+      build->section = ini_hash(sp, (SceSize)(ep - sp));
+      build->header = offset;
+      if ((n = sidecar_newsection(build, sp, (SceSize)(ep - sp))) < 0)
+        return INI_FALSE;   /* out of memory: the sidecar is not built */
+      build->insection = (n > 0);
+    }
+    return INI_TRUE;
+  }
+  if (!build->insection || is_comment(*sp))
+    return INI_TRUE;
+  ep = finddelimiter(sp);
+  if (ep == NULL)
+    return INI_TRUE;
+  if (build->count == build->capacity) {
+    SceUInt32 capacity = (build->capacity > 0) ? 2 * build->capacity : 256;
+    rec = (SIDECAR_RECORD *)ini_realloc(build->records, capacity * sizeof(SIDECAR_RECORD));
+    if (rec == NULL)
+      return INI_FALSE;
+    build->records = rec;
+    build->capacity = capacity;
+  }
+  rec = &build->records[build->count++];
+  rec->section = build->section;
+  rec->key = ini_hash(sp, (SceSize)(skiptrailing(ep, sp) - sp));
+  rec->offset = offset;
+  rec->header = build->header;
+  return INI_TRUE;
+}
+
+/* Scan the INI file and (re-)write the sidecar */
+static SceBool sidecar_build(const char *Filename, const char *name)
+{
+  char Block[INI_SCANSIZE];
+  char LocalBuffer[INI_BUFFERSIZE];
+  SIDECAR_HEADER header;
+  SIDECAR_BUILD build;
+  INI_FILESTAT stat;
+  INI_FILETYPE fd;
+  INI_FILEPOS pos = 0, head = 0;
+  SceSize len = 0;
+  SceBool ok;
+  int n;
+
+  if (!ini_stat(Filename, &stat) || !ini_openread(Filename, &fd))
+    return INI_FALSE;
+  memset(&header, 0, sizeof(header));
+  memset(&build, 0, sizeof(build));
+  build.section = ini_hash("", 0);
+  build.header = SIDECAR_NOHEADER;
+  n = sidecar_newsection(&build, "", 0);
+  build.insection = (n > 0);
+  ok = (n >= 0);
+  header.hash = 1;
+  while (ok && (n = ini_readblock(Block, INI_SCANSIZE, &fd)) > 0) {
+    SceSize i = 0, k;
+    header.hash = adler32(header.hash, (const unsigned char *)Block, (SceSize)n);
+    while (ok && i < (SceSize)n) {
+      k = scan_lineterm(Block + i, n - i);
+      if (len + k >= INI_BUFFERSIZE)
+        k = INI_BUFFERSIZE - 1 - len;
+      memcpy(LocalBuffer + len, Block + i, k);
+      len += k;
+      i += scan_lineterm(Block + i, n - i);
+      if (i < (SceSize)n) {
+        LocalBuffer[len] = '\0';
+        len = 0;
+        ok = sidecar_line(&build, LocalBuffer, head);
+        head = pos + ++i;
+      }
+    }
+    pos += n;
+  }
+  (void)ini_close(&fd);
+  if (ok && len > 0) {
+    LocalBuffer[len] = '\0';
+    ok = sidecar_line(&build, LocalBuffer, head);
+  }
+
+  if (ok) {
+    if (build.count > 0)
+      qsort(build.records, build.count, sizeof(SIDECAR_RECORD), sidecar_compare);
+    memcpy(header.magic, SIDECAR_MAGIC, 4);
+    header.version = SIDECAR_VERSION;
+    header.count = build.count;
+    header.size = pos;
+    header.mtime = ini_statmtime(&stat);
+    ok = ini_openwrite(name, &fd);
+    if (ok) {
+      ok = ini_write((const char *)&header, sizeof(header), &fd)
+           && (build.count == 0 || ini_write((const char *)build.records, build.count * sizeof(SIDECAR_RECORD), &fd));
+      (void)ini_close(&fd);
+      if (!ok)
+        (void)ini_remove(name);
+    }
+  }
+  if (build.records != NULL)
+    ini_free(build.records);
+  if (build.seen != NULL)
+    ini_free(build.seen);
+  if (build.slots != NULL)
+    ini_free(build.slots);
+  if (build.names != NULL)
+    ini_free(build.names);
+  return ok;
+}
+
+/* Check the sidecar against the INI file. When only the modification time
+ * differs, the checksum tells whether the contents really changed; if not,
+ * the header is refreshed instead of rebuilding the sidecar.
+ */
+static SceBool sidecar_fresh(const char *Filename, const char *name, SIDECAR_HEADER *header, INI_FILESTAT *stat)
+{
+  INI_FILETYPE fd;
+  SceUInt32 hash = 1;
+  SceBool ok;
+
+  if (memcmp(header->magic, SIDECAR_MAGIC, 4) != 0 || header->version != SIDECAR_VERSION
+      || header->overflow > INI_SIDECAROVERFLOW || header->size != ini_statsize(stat))
+    return INI_FALSE;
+  if (memcmp(&header->mtime, &ini_statmtime(stat), sizeof(INI_FILETIME)) == 0)
+    return INI_TRUE;
+  if (!ini_openread(Filename, &fd))
+    return INI_FALSE;
+  {
+    char Block[INI_SCANSIZE];
+    int n;
+    while ((n = ini_readblock(Block, INI_SCANSIZE, &fd)) > 0)
+      hash = adler32(hash, (const unsigned char *)Block, (SceSize)n);
+  }
+  (void)ini_close(&fd);
+  if (hash != header->hash)
+    return INI_FALSE;
+  header->mtime = ini_statmtime(stat);
+  ok = ini_openrewrite(name, &fd);
+  if (ok) {
+    ok = ini_write((const char *)header, sizeof(SIDECAR_HEADER), &fd);
+    (void)ini_close(&fd);
+  }
+  return ok;
+}
+
+/* Read the key line at the offset; if it holds the key, copy its value */
+static SceBool sidecar_readkey(INI_FILETYPE *fd, INI_FILEPOS offset, const char *Key, SceSize keylen,
+                               char *Buffer, SceSize BufferSize)
+{
+  char LocalBuffer[INI_BUFFERSIZE];
+  enum quote_option quotes;
+  char *sp, *ep;
+
+  if (!ini_seek(fd, &offset) || !ini_read(LocalBuffer, INI_BUFFERSIZE, fd))
+    return INI_FALSE;
+  sp = skipleading(LocalBuffer);
+  ep = finddelimiter(sp);
+  if (ep == NULL || (SceSize)(skiptrailing(ep, sp) - sp) != keylen || namememcmp(sp, Key, keylen, INI_CASESENSITIVE) != 0)
+    return INI_FALSE;
+  sp = cleanstring(skipleading(ep + 1), &quotes);
+  ini_strncpy(Buffer, sp, BufferSize, quotes);
+  return INI_TRUE;
+}
+
+/* Read the section header at the offset, and check that it is the section;
+ * the keys above the first section have no header */
+static SceBool sidecar_readsection(INI_FILETYPE *fd, INI_FILEPOS offset, const char *Section, SceSize len)
+{
+  char LocalBuffer[INI_BUFFERSIZE];
+  char *sp, *ep;
+
+  if (offset == SIDECAR_NOHEADER)
+    return len == 0;
+  if (len == 0 || !ini_seek(fd, &offset) || !ini_read(LocalBuffer, INI_BUFFERSIZE, fd))
+    return INI_FALSE;
+  sp = skipleading(LocalBuffer);
+  if (*sp != '[' || (ep = strrchr(sp, ']')) == NULL)
+    return INI_FALSE;
+  sp = skipleading(sp + 1);
+  ep = skiptrailing(ep, sp);
+  return (SceSize)(ep - sp) == len && namememcmp(sp, Section, len, INI_CASESENSITIVE) == 0;
+}
+
+/* Read record "idx" of the sidecar */
+static SceBool sidecar_record(INI_FILETYPE *xfd, SceUInt32 idx, SIDECAR_RECORD *rec)
+{
+  INI_FILEPOS pos = (INI_FILEPOS)(sizeof(SIDECAR_HEADER) + (INI_FILEPOS)idx * sizeof(SIDECAR_RECORD));
+  return ini_seek(xfd, &pos) && ini_readblock(rec, sizeof(SIDECAR_RECORD), xfd) == (int)sizeof(SIDECAR_RECORD);
+}
+
+/* Binary search in the sorted records for the first record with these
+ * hashes (or with higher ones); returns false on a read error */
+static SceBool sidecar_search(INI_FILETYPE *xfd, const SIDECAR_HEADER *header, SceUInt32 section, SceUInt32 key,
+                              SceUInt32 *idx)
+{
+  SIDECAR_RECORD rec;
+  SceUInt32 lo = 0, hi = header->count;
+
+  while (lo < hi) {
+    SceUInt32 mid = lo + (hi - lo) / 2;
+    if (!sidecar_record(xfd, mid, &rec))
+      return INI_FALSE;
+    if (rec.section < section || (rec.section == section && rec.key < key))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  *idx = lo;
+  return INI_TRUE;
+}
+
+/* Look up a key through the sidecar, building or rebuilding the sidecar when
+ * it is missing or stale. Returns 1 if the key was found, 0 if it was not
+ * found, and -1 if the sidecar cannot be used (the caller must then scan the
+ * INI file). A record whose lines do not hold the names that it was found
+ * on means that the hashes collide or that the sidecar is stale, so the
+ * sidecar cannot tell that the key is missing.
+ */
+static int sidecar_lookup(const char *Section, const char *Key, char *Buffer, SceSize BufferSize, const char *Filename)
+{
+  char name[INI_BUFFERSIZE];
+  SIDECAR_HEADER header;
+  SIDECAR_RECORD rec;
+  INI_FILESTAT stat;
+  INI_FILETYPE xfd, fd;
+  SceUInt32 section, key, idx;
+  SceSize seclen = (Section != NULL) ? (SceSize)strlen(Section) : 0;
+  SceSize keylen = (SceSize)strlen(Key);
+  SceBool fresh = INI_FALSE, mismatch = INI_FALSE;
+  int found = 0;
+
+  if (keylen == 0)
+    return 0;   /* like getkeystring(), an empty key never matches */
+  if (!ini_stat(Filename, &stat))
+    return -1;
+  sidecar_name(name, Filename, sizeof(name));
+  if (ini_openread(name, &xfd)) {
+    fresh = ini_readblock(&header, sizeof(header), &xfd) == (int)sizeof(header)
+            && sidecar_fresh(Filename, name, &header, &stat);
+    if (!fresh)
+      (void)ini_close(&xfd);
+  }
+  if (!fresh) {
+    if (!sidecar_build(Filename, name) || !ini_openread(name, &xfd))
+      return -1;
+    if (ini_readblock(&header, sizeof(header), &xfd) != (int)sizeof(header)) {
+      (void)ini_close(&xfd);
+      return -1;
+    }
+  }
+  if (!ini_openread(Filename, &fd)) {
+    (void)ini_close(&xfd);
+    return -1;
+  }
+
+  section = ini_hash((Section != NULL) ? Section : "", seclen);
+  key = ini_hash(Key, keylen);
+  if (!sidecar_search(&xfd, &header, section, key, &idx))
+    found = -1;
+  /* check the matching sorted records, then the overflow records */
+  for ( ; found == 0 && idx < header.count + header.overflow; idx++) {
+    if (!sidecar_record(&xfd, idx, &rec)) {
+      found = -1;
+      break;
+    }
+    if (rec.section == section && rec.key == key) {
+      if (sidecar_readsection(&fd, rec.header, Section, seclen))
+        found = sidecar_readkey(&fd, rec.offset, Key, keylen, Buffer, BufferSize);
+      if (found == 0)
+        mismatch = INI_TRUE;
+    } else if (idx < header.count) {
+      idx = header.count - 1;   /* no more matches in the sorted part, skip to the overflow */
+    }
+  }
+  (void)ini_close(&fd);
+  (void)ini_close(&xfd);
+  return (found == 0 && mismatch) ? -1 : found;
+}
+#endif /* INI_SIDECAR */
+
+#if INI_PROFILE
+/* The profile is a fixed open-addressing table, keyed on the hashes of the
+ * file, section and key names. It is not protected against concurrent use.
+ */
+static INI_PROFILE_ENTRY profile_table[INI_PROFILESIZE];
+static SceUInt32 profile_hashes[INI_PROFILESIZE];
+static SceUInt32 profile_dropped;
+
+static void profile_name(char *dest, const char *source)
+{
+  SceSize len = (source != NULL) ? (SceSize)strlen(source) : 0;
+  if (len >= INI_PROFILENAME)
+    len = INI_PROFILENAME - 1;
+  memcpy(dest, source, len);
+  dest[len] = '\0';
+}
+
+/* Count a lookup that started at "start"; "hit" is set when the value was
+ * looked up without reading the INI file */
+static void profile_record(const char *Filename, const char *Section, const char *Key,
+                           SceUInt64 start, int path, SceBool hit, SceBool found)
+{
+  SceUInt64 elapsed = ini_clock() - start;
+  SceUInt32 hash;
+  INI_PROFILE_ENTRY *entry;
+  int i, n;
+
+  if (Filename == NULL)
+    Filename = "";
+  if (Section == NULL)
+    Section = "";
+  hash = ini_hash(Filename, (SceSize)strlen(Filename));
+  hash = (hash * 16777619u) ^ ini_hash(Section, (SceSize)strlen(Section));
+  hash = (hash * 16777619u) ^ ini_hash(Key, (SceSize)strlen(Key));
+  for (n = 0, i = (int)(hash % INI_PROFILESIZE); n < INI_PROFILESIZE; n++, i = (i + 1) % INI_PROFILESIZE) {
+    entry = &profile_table[i];
+    if (entry->calls == 0) {
+      profile_name(entry->file, Filename);
+      profile_name(entry->section, Section);
+      profile_name(entry->key, Key);
+      profile_hashes[i] = hash;
+      break;
+    }
+    if (profile_hashes[i] == hash && strncmp(entry->file, Filename, INI_PROFILENAME - 1) == 0
+        && namencmp(entry->section, Section, INI_PROFILENAME - 1) == 0
+        && namencmp(entry->key, Key, INI_PROFILENAME - 1) == 0)
+      break;
+  }
+  if (n == INI_PROFILESIZE) {
+    profile_dropped++;  /* the table is full */
+    return;
+  }
+  entry->calls++;
+  if (hit)
+    entry->hits++;
+  if (found)
+    entry->found++;
+  entry->time += elapsed;
+  entry->paths |= path;
+}
+
+static int profile_compare(const void *a, const void *b)
+{
+  SceUInt64 ta = profile_table[*(const int *)a].time;
+  SceUInt64 tb = profile_table[*(const int *)b].time;
+  return (ta > tb) ? -1 : (ta < tb);
+}
+
+/** ini_profile_top()
+ * \param entries     an array that receives the entries
+ * \param count       the number of entries in the array
+ *
+ * Copies the profiled (file, section, key) entries with the highest total
+ * time, most expensive first. The average cost of a lookup is the time
+ * divided by the number of calls.
+ *
+ * \return            the number of entries copied
+ */
+int ini_profile_top(INI_PROFILE_ENTRY *entries, int count)
+{
+  int order[INI_PROFILESIZE];
+  int i, n;
+
+  assert(entries != NULL || count == 0);
+  for (i = n = 0; i < INI_PROFILESIZE; i++)
+    if (profile_table[i].calls > 0)
+      order[n++] = i;
+  qsort(order, n, sizeof(int), profile_compare);
+  if (count > n)
+    count = n;
+  for (i = 0; i < count; i++)
+    entries[i] = profile_table[order[i]];
+  return count;
+}
+
+/** ini_profile_dropped()
+ *
+ * \return            the number of lookups that were not counted, because
+ *                    the profile table was full
+ */
+SceUInt32 ini_profile_dropped(void)
+{
+  return profile_dropped;
+}
+
+/** ini_profile_reset()
+ * Clears all profile entries.
+ */
+void ini_profile_reset(void)
+{
+  memset(profile_table, 0, sizeof(profile_table));
+  memset(profile_hashes, 0, sizeof(profile_hashes));
+  profile_dropped = 0;
+}
+
+static void profile_field(char *line, SceSize *len, const char *text)
+{
+  SceSize n = (SceSize)strlen(text);
+  memcpy(line + *len, text, n);
+  line[*len + n] = '\t';
+  *len += n + 1;
+}
+
+/** ini_profile_dump()
+ * \param count       the maximum number of entries to write
+ * \param Filename    the name and full path of the report file to write
+ *
+ * Writes the most expensive entries (see ini_profile_top()) as a text
+ * report, one line per entry with tab-separated fields: calls, hits, found,
+ * the average time per lookup in microseconds, the paths (C = classic,
+ * S = sidecar, I = section index, D = document, M = image), the file, the
+ * section and the key.
+ *
+ * \return            1 on success, 0 on failure
+ */
+SceBool ini_profile_dump(int count, const char *Filename)
+{
+  static const char header[] = "; calls\thits\tfound\tavg(us)\tpaths\tfile\tsection\tkey" INI_LINETERM;
+  static const char pathnames[] = "CSIDM";
+  INI_PROFILE_ENTRY entries[INI_PROFILESIZE];
+  char line[3 * INI_PROFILENAME + 64];
+  char number[16];
+  INI_FILETYPE fd;
+  SceBool ok;
+  int i, p;
+
+  assert(Filename != NULL);
+  if (count > INI_PROFILESIZE)
+    count = INI_PROFILESIZE;
+  count = ini_profile_top(entries, count);
+  if (!ini_openwrite(Filename, &fd))
+    return INI_FALSE;
+  ok = ini_write(header, sizeof(header) - 1, &fd);
+  for (i = 0; ok && i < count; i++) {
+    SceSize len = 0;
+    ini_utoa(number, sizeof(number), entries[i].calls);
+    profile_field(line, &len, number);
+    ini_utoa(number, sizeof(number), entries[i].hits);
+    profile_field(line, &len, number);
+    ini_utoa(number, sizeof(number), entries[i].found);
+    profile_field(line, &len, number);
+    ini_utoa(number, sizeof(number), (SceUInt32)(entries[i].time / entries[i].calls));
+    profile_field(line, &len, number);
+    for (p = 0; pathnames[p] != '\0'; p++)
+      if (entries[i].paths & (1 << p))
+        line[len++] = pathnames[p];
+    line[len++] = '\t';
+    profile_field(line, &len, entries[i].file);
+    profile_field(line, &len, entries[i].section);
+    profile_field(line, &len, entries[i].key);
+    memcpy(line + len - 1, INI_LINETERM, sizeof(INI_LINETERM) - 1);
+    len += sizeof(INI_LINETERM) - 2;
+    ok = ini_write(line, len, &fd);
+  }
+  return ini_close(&fd) && ok;
+}
+#endif /* INI_PROFILE */
+
+/* Look up the value of the key; returns whether it was found (Buffer is
+ * left undefined if it was not) */
+static SceBool gets_value(const char *Section, const char *Key, char *Buffer, SceSize BufferSize,
+                          const char *Filename)
+{
+  INI_FILETYPE fd;
+  SceBool ok = INI_FALSE;
+#if INI_SIDECAR
+  int found;
+#endif
+#if INI_PROFILE
+  SceUInt64 start = ini_clock();
+#endif
+
+  TRACE_BEGIN("ini_gets");
+#if INI_SIDECAR
+  if ((found = sidecar_lookup(Section, Key, Buffer, BufferSize, Filename)) >= 0)
+    ok = (found > 0);
+  else
+#endif
+  if (ini_opensource(Filename, &fd)) {
+    ok = getkeystring(&fd, Section, Key, -1, -1, Buffer, BufferSize, NULL, NULL);
+    (void)ini_close(&fd);
+  }
+  TRACE_END("ini_gets");
+#if INI_PROFILE && INI_SIDECAR
+  profile_record(Filename, Section, Key, start, (found >= 0) ? INI_PATH_SIDECAR : INI_PATH_CLASSIC, found >= 0, ok);
+#elif INI_PROFILE
+  profile_record(Filename, Section, Key, start, INI_PATH_CLASSIC, INI_FALSE, ok);
+#endif
+  return ok;
+}
+
+/** ini_gets()
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find the value of
+ * \param DefValue    default string in the event of a failed read
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy
+ * \param Filename    the name and full path of the .ini file to read from
+ *
+ * \return            the number of characters copied into the supplied buffer
+ */
+SceSize ini_gets(const char *Section, const char *Key, const char *DefValue,
+             char *Buffer, SceSize BufferSize, const char *Filename)
+{
+  if (Buffer == NULL || BufferSize <= 0 || Key == NULL)
+    return INI_FALSE;
+  if (!gets_value(Section, Key, Buffer, BufferSize, Filename))
+    ini_strncpy(Buffer, (DefValue != NULL) ? DefValue : "", BufferSize, QUOTE_NONE);
+  return (SceSize)strlen(Buffer);
+}
+
+/** ini_gets_len()
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find the value of
+ * \param DefValue    default string in the event of a failed read
+ * \param Buffer      a pointer to the buffer to copy into, may be NULL
+ * \param BufferSize  the maximum number of characters to copy, may be 0
+ * \param Filename    the name and full path of the .ini file to read from
+ *
+ * Like ini_gets(), but the return value is the full length of the value (or
+ * of the default), also when it was truncated to fit in the buffer. A value
+ * was truncated when the return value is BufferSize or more; as with
+ * snprintf(), the buffer size that is needed is the return value plus one.
+ *
+ * \return            the length of the value, excluding the terminating zero
+ */
+SceSize ini_gets_len(const char *Section, const char *Key, const char *DefValue,
+                     char *Buffer, SceSize BufferSize, const char *Filename)
+{
+  char LocalBuffer[INI_BUFFERSIZE];  /* holds any value, because lines are read in this size */
+  const char *value;
+
+  if (Key != NULL && gets_value(Section, Key, LocalBuffer, sizeof(LocalBuffer), Filename))
+    value = LocalBuffer;
+  else
+    value = (DefValue != NULL) ? DefValue : "";
+  if (Buffer != NULL && BufferSize > 0)
+    ini_strncpy(Buffer, value, BufferSize, QUOTE_NONE);
+  return (SceSize)strlen(value);
+}
+
+/* Collect the values of a key from one pass over the file: the scan stops at
+ * the end of the section. The values are stored one after the other, each
+ * zero-terminated, and the list ends with an empty string; a value that does
+ * not fit is truncated and ends the list. BufferSize must be at least 2.
+ */
+static int getkeyvalues(INI_FILETYPE *fd, const char *Section, const char *Key, int Policy,
+                        char *Buffer, SceSize BufferSize)
+{
+  SceSize used = 0;
+  int count = 0;
+
+  assert(BufferSize >= 2);
+  /* after the first match, the scan goes on in the same section */
+  while (used + 1 < BufferSize
+         && getkeystring(fd, (count == 0) ? Section : NULL, Key, -1, -1, Buffer + used, BufferSize - used - 1, NULL, NULL)) {
+    count++;
+    if (Policy == INI_DUP_ALL)
+      used += (SceSize)strlen(Buffer + used) + 1;
+    else if (Policy == INI_DUP_FIRST)
+      break;
+  }
+  if (Policy != INI_DUP_ALL && count > 0) {
+    used = (SceSize)strlen(Buffer) + 1;
+    count = 1;
+  }
+  Buffer[used] = '\0';
+  if (used == 0)
+    Buffer[1] = '\0';  /* an empty list also ends with two zero bytes */
+  return count;
+}
+
+/** ini_getdups()
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find the values of
+ * \param Policy      INI_DUP_FIRST or INI_DUP_LAST for the first or the last
+ *                    occurrence of a key that appears more than once in the
+ *                    section, or INI_DUP_ALL for all occurrences in file order
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy, at least 2
+ * \param Filename    the name and full path of the .ini file to read from
+ *
+ * The values are stored one after the other, each zero-terminated, and the
+ * list ends with an empty string (so it ends with two zero bytes). A value
+ * that does not fit is truncated and ends the list. The section is read only
+ * once, whatever the number of occurrences.
+ *
+ * \return            the number of values copied into the buffer, 0 if the
+ *                    key is not found
+ */
+int ini_getdups(const char *Section, const char *Key, int Policy,
+                char *Buffer, SceSize BufferSize, const char *Filename)
+{
+  INI_FILETYPE fd;
+  int count = 0;
+
+  if (Buffer == NULL || BufferSize < 2 || Key == NULL)
+    return 0;
+  TRACE_BEGIN("ini_getdups");
+  if (ini_opensource(Filename, &fd)) {
+    count = getkeyvalues(&fd, Section, Key, Policy, Buffer, BufferSize);
+    (void)ini_close(&fd);
+  } else {
+    Buffer[0] = Buffer[1] = '\0';
+  }
+  TRACE_END("ini_getdups");
+  return count;
+}
+
+/** ini_arena_init()
+ * \param arena       the arena to set up
+ * \param Memory      the memory that the arena hands out
+ * \param Size        the size of the memory
+ */
+void ini_arena_init(INI_ARENA *arena, void *Memory, SceSize Size)
+{
+  assert(arena != NULL && (Memory != NULL || Size == 0));
+  arena->base = (char *)Memory;
+  arena->size = Size;
+  arena->used = 0;
+}
+
+/** ini_arena_reset()
+ * \param arena       the arena to empty; all strings that were allocated in
+ *                    it become invalid
+ */
+void ini_arena_reset(INI_ARENA *arena)
+{
+  assert(arena != NULL);
+  arena->used = 0;
+}
+
+/** ini_gets_alloc()
+ * \param arena       the arena to allocate the string in
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find the value of
+ * \param DefValue    default string in the event of a failed read
+ * \param Filename    the name and full path of the .ini file to read from
+ *
+ * The value (or the default) is copied into the arena, taking exactly the
+ * length of the value plus the terminating zero.
+ *
+ * \return            the value in the arena, or NULL if it does not fit
+ */
+const char *ini_gets_alloc(INI_ARENA *arena, const char *Section, const char *Key, const char *DefValue,
+                           const char *Filename)
+{
+  char LocalBuffer[INI_BUFFERSIZE];
+  const char *value;
+  SceSize len;
+  char *p;
+
+  assert(arena != NULL);
+  if (Key != NULL && gets_value(Section, Key, LocalBuffer, sizeof(LocalBuffer), Filename))
+    value = LocalBuffer;
+  else
+    value = (DefValue != NULL) ? DefValue : "";
+  len = (SceSize)strlen(value);
+  if (len >= arena->size - arena->used)
+    return NULL;
+  p = arena->base + arena->used;
+  memcpy(p, value, len + 1);
+  arena->used += len + 1;
+  return p;
+}
+
+/** ini_geti()
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find the value of
+ * \param DefValue    the default value in the event of a failed read
+ * \param Filename    the name of the .ini file to read from
+ *
+ * \return            the value located at Key
+ */
+int ini_geti(const char *Section, const char *Key, int DefValue, const char *Filename)
+{
+  char LocalBuffer[16];
+  SceSize len = ini_gets(Section, Key, "", LocalBuffer, sizeof(LocalBuffer), Filename);
+  return (len == 0) ? DefValue
+                    : ((len >= 2 && (LocalBuffer[1] == 'x' || LocalBuffer[1] == 'X')) ? (int)strtol(LocalBuffer, NULL, 16)
+                                                                           : (int)strtol(LocalBuffer, NULL, 10));
 }
 
 /** ini_getu()
@@ -395,166 +1817,2626 @@ SceBool ini_getbool(const char *Section, const char *Key, SceBool DefValue, cons
   return(ret);
 }
 
-/** ini_getsection()
- * \param idx         the zero-based sequence number of the section to return
+#if INI_ENUMCURSOR
+/* The enumeration cursor remembers where the last ini_getsection() or
+ * ini_getkey() call stopped, so that a call for the next index resumes there
+ * instead of scanning from the start of the file; enumerating all sections or
+ * keys is then linear in the size of the file. The cursor is only used while
+ * the file is unchanged: the same size and time stamp (or the same slot, with
+ * INI_PINGPONG), and no write through this library in between. As an edit by
+ * another program can keep the size and fall within the resolution of the
+ * time stamp, the bytes in front of the position must also be the same as
+ * when the cursor was set. All threads share the cursor; a thread that finds
+ * it locked scans from the start.
+ */
+#define ENUM_TAILSIZE 32
+
+typedef struct {
+  SceOff    size;
+  INI_FILETIME mtime;
+  char      slot;       /* INI_PINGPONG: the slot and its sequence number */
+  SceUInt32 seq;
+  SceUInt32 writes;
+} ENUM_STAMP;
+
+static struct {
+  ENUM_STAMP  stamp;
+  SceBool     valid;
+  SceBool     keys;     /* enumerating keys, or sections */
+  int         idx;      /* the index of the entry that was returned last */
+  INI_FILEPOS pos;      /* the position behind that entry */
+  char        tail[ENUM_TAILSIZE];  /* the bytes in front of pos */
+  int         taillen;
+  char        filename[INI_BUFFERSIZE];
+  char        section[INI_BUFFERSIZE];
+} enum_cursor;
+static volatile int enum_lock;
+static volatile SceUInt32 enum_writes;  /* incremented after every write */
+
+/* Open the INI file for reading, and get the stamp to validate the cursor */
+static SceBool enum_open(const char *Filename, INI_FILETYPE *fd, ENUM_STAMP *stamp)
+{
+#if !INI_PINGPONG
+  INI_FILESTAT stat;
+#endif
+
+  memset(stamp, 0, sizeof(ENUM_STAMP));
+  stamp->writes = enum_writes;
+#if INI_PINGPONG
+  stamp->slot = slot_openread(Filename, fd, &stamp->seq);
+  return stamp->slot != '\0';
+#else
+  if (!ini_stat(Filename, &stat))
+    return INI_FALSE;
+  stamp->size = ini_statsize(&stat);
+  stamp->mtime = ini_statmtime(&stat);
+  return ini_openread(Filename, fd);
+#endif
+}
+
+/* Read the bytes in front of pos, which leaves the file at pos */
+static int enum_readtail(INI_FILETYPE *fd, INI_FILEPOS pos, char *tail)
+{
+  INI_FILEPOS start = (pos > ENUM_TAILSIZE) ? pos - ENUM_TAILSIZE : 0;
+  int len = (int)(pos - start);
+
+  if (!ini_seek(fd, &start) || ini_readblock(tail, len, fd) != len)
+    return -1;
+  return len;
+}
+
+/* Move the file to the position to resume at for entry idx, if the cursor
+ * applies; otherwise the file stays where it is */
+static SceBool enum_resume(SceBool keys, const char *Filename, const char *Section, int idx,
+                           const ENUM_STAMP *stamp, INI_FILETYPE *fd)
+{
+  char tail[ENUM_TAILSIZE], check[ENUM_TAILSIZE];
+  INI_FILEPOS pos = 0, start;
+  SceBool ok = INI_FALSE;
+  int len = 0;
+
+  if (ini_trylock(&enum_lock)) {
+    ok = enum_cursor.valid && enum_cursor.keys == keys && enum_cursor.idx + 1 == idx
+         && memcmp(&enum_cursor.stamp, stamp, sizeof(ENUM_STAMP)) == 0
+         && strcmp(enum_cursor.filename, Filename) == 0
+         && (!keys || namencmp(enum_cursor.section, (Section != NULL) ? Section : "", INI_BUFFERSIZE) == 0);
+    if (ok) {
+      pos = enum_cursor.pos;
+      len = enum_cursor.taillen;
+      memcpy(tail, enum_cursor.tail, len);
+    }
+    ini_unlock(&enum_lock);
+  }
+  if (!ok || !ini_tell(fd, &start))
+    return INI_FALSE;
+  if (enum_readtail(fd, pos, check) == len && memcmp(check, tail, len) == 0)
+    return INI_TRUE;
+  (void)ini_seek(fd, &start);
+  return INI_FALSE;
+}
+
+/* Set the cursor behind entry idx, at the current position of the file */
+static void enum_save(SceBool keys, const char *Filename, const char *Section, int idx,
+                      const ENUM_STAMP *stamp, INI_FILETYPE *fd)
+{
+  char tail[ENUM_TAILSIZE];
+  INI_FILEPOS pos;
+  int len;
+
+  if (Section == NULL)
+    Section = "";
+  if (strlen(Filename) >= INI_BUFFERSIZE || strlen(Section) >= INI_BUFFERSIZE)
+    return;
+  if (!ini_tell(fd, &pos) || (len = enum_readtail(fd, pos, tail)) < 0)
+    return;
+  if (ini_trylock(&enum_lock)) {
+    enum_cursor.stamp = *stamp;
+    enum_cursor.keys = keys;
+    enum_cursor.idx = idx;
+    enum_cursor.pos = pos;
+    memcpy(enum_cursor.tail, tail, len);
+    enum_cursor.taillen = len;
+    strcpy(enum_cursor.filename, Filename);
+    strcpy(enum_cursor.section, Section);
+    enum_cursor.valid = INI_TRUE;
+    ini_unlock(&enum_lock);
+  }
+}
+#endif /* INI_ENUMCURSOR */
+
+/** ini_getsection()
+ * \param idx         the zero-based sequence number of the section to return
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy
+ * \param Filename    the name and full path of the .ini file to read from
+ *
+ * Each call scans the file from the start (unless INI_ENUMCURSOR is set), so
+ * enumerating all sections takes quadratic time; ini_browse() and the pull
+ * parser (ini_next()) visit them in a single pass.
+ *
+ * \return            the number of characters copied into the supplied buffer
+ */
+SceSize ini_getsection(int idx, char *Buffer, SceSize BufferSize, const char *Filename)
+{
+  INI_FILETYPE fd;
+  SceBool ok = INI_FALSE;
+#if INI_ENUMCURSOR
+  ENUM_STAMP stamp;
+#endif
+
+  if (Buffer == NULL || BufferSize <= 0 || idx < 0)
+    return INI_FALSE;
+  TRACE_BEGIN("ini_getsection");
+#if INI_ENUMCURSOR
+  if (enum_open(Filename, &fd, &stamp)) {
+    if (enum_resume(INI_FALSE, Filename, NULL, idx, &stamp, &fd))
+      ok = getkeystring(&fd, NULL, NULL, 0, -1, Buffer, BufferSize, NULL, NULL);
+    else
+      ok = getkeystring(&fd, NULL, NULL, idx, -1, Buffer, BufferSize, NULL, NULL);
+    if (ok)
+      enum_save(INI_FALSE, Filename, NULL, idx, &stamp, &fd);
+    (void)ini_close(&fd);
+  }
+#else
+  if (ini_opensource(Filename, &fd)) {
+    ok = getkeystring(&fd, NULL, NULL, idx, -1, Buffer, BufferSize, NULL, NULL);
+    (void)ini_close(&fd);
+  }
+#endif
+  TRACE_END("ini_getsection");
+  if (!ok)
+    *Buffer = '\0';
+  return (SceSize)strlen(Buffer);
+}
+
+/** ini_getkey()
+ * \param Section     the name of the section to browse through, or NULL to
+ *                    browse through the keys outside any section
+ * \param idx         the zero-based sequence number of the key to return
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy
+ * \param Filename    the name and full path of the .ini file to read from
+ *
+ * Each call scans the file from the start (unless INI_ENUMCURSOR is set), so
+ * enumerating all keys takes quadratic time; ini_browse() and the pull
+ * parser (ini_next()) visit them in a single pass.
+ *
+ * \return            the number of characters copied into the supplied buffer
+ */
+SceSize ini_getkey(const char *Section, int idx, char *Buffer, SceSize BufferSize, const char *Filename)
+{
+  INI_FILETYPE fd;
+  SceBool ok = INI_FALSE;
+#if INI_ENUMCURSOR
+  ENUM_STAMP stamp;
+#endif
+
+  if (Buffer == NULL || BufferSize <= 0 || idx < 0)
+    return INI_FALSE;
+  TRACE_BEGIN("ini_getkey");
+#if INI_ENUMCURSOR
+  if (enum_open(Filename, &fd, &stamp)) {
+    if (enum_resume(INI_TRUE, Filename, Section, idx, &stamp, &fd))
+      ok = getkeystring(&fd, NULL, NULL, -1, 0, Buffer, BufferSize, NULL, NULL);
+    else
+      ok = getkeystring(&fd, Section, NULL, -1, idx, Buffer, BufferSize, NULL, NULL);
+    if (ok)
+      enum_save(INI_TRUE, Filename, Section, idx, &stamp, &fd);
+    (void)ini_close(&fd);
+  }
+#else
+  if (ini_opensource(Filename, &fd)) {
+    ok = getkeystring(&fd, Section, NULL, -1, idx, Buffer, BufferSize, NULL, NULL);
+    (void)ini_close(&fd);
+  }
+#endif
+  TRACE_END("ini_getkey");
+  if (!ok)
+    *Buffer = '\0';
+  return (SceSize)strlen(Buffer);
+}
+
+/** ini_hassection()
+ * \param Section     the name of the section to search for
+ * \param Filename    the name of the .ini file to read from
+ *
+ * \return            1 if the section is found, 0 if not found
+ */
+SceBool ini_hassection(const char *Section, const char *Filename)
+{
+  char LocalBuffer[8];  /* dummy buffer */
+  INI_FILETYPE fd;
+  SceBool ok = INI_FALSE;
+
+  TRACE_BEGIN("ini_hassection");
+  if (ini_opensource(Filename, &fd)) {
+    ok = getkeystring(&fd, Section, NULL, -1, 0, LocalBuffer, sizeof(LocalBuffer), NULL, NULL);
+    (void)ini_close(&fd);
+  }
+  TRACE_END("ini_hassection");
+  return ok;
+}
+
+/** ini_haskey()
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find the value of
+ * \param Filename    the name of the .ini file to read from
+ *
+ * \return            1 if the key is found, 0 if not found
+ */
+SceBool ini_haskey(const char *Section, const char *Key, const char *Filename)
+{
+  char LocalBuffer[8];  /* dummy buffer */
+  INI_FILETYPE fd;
+  SceBool ok = INI_FALSE;
+#if INI_SIDECAR
+  int found = -1;
+#endif
+
+  TRACE_BEGIN("ini_haskey");
+#if INI_SIDECAR
+  if (Key != NULL && (found = sidecar_lookup(Section, Key, LocalBuffer, sizeof(LocalBuffer), Filename)) >= 0)
+    ok = (found > 0);
+  else
+#endif
+  if (ini_opensource(Filename, &fd)) {
+    ok = getkeystring(&fd, Section, Key, -1, -1, LocalBuffer, sizeof(LocalBuffer), NULL, NULL);
+    (void)ini_close(&fd);
+  }
+  TRACE_END("ini_haskey");
+  return ok;
+}
+
+
+#if INI_BROWSE
+/** ini_reader_open()
+ * \param reader      the reader to initialize
+ * \param Filename    the name and full path of the .ini file to read from
+ *
+ * \return            1 on success, 0 on failure (INI file not found)
+ */
+SceBool ini_reader_open(INI_READER *reader, const char *Filename)
+{
+  assert(reader != NULL);
+  reader->section[0] = '\0';
+  reader->sectionlen = 0;
+  return ini_opensource(Filename, &reader->fd);
+}
+
+/** ini_reader_close()
+ * \param reader      a reader opened with ini_reader_open()
+ */
+void ini_reader_close(INI_READER *reader)
+{
+  assert(reader != NULL);
+  (void)ini_close(&reader->fd);
+}
+
+static void setspan(INI_SPAN *span, const char *ptr, SceSize len)
+{
+  span->ptr = ptr;
+  span->len = len;
+}
+
+/* Classify a line and split it into its parts (in place); returns -1 for an
+ * invalid line. A new section name is copied into the section buffer.
+ */
+static int parseline(char *line, char *section, SceSize *sectionlen, INI_EVENT *event)
+{
+  enum quote_option quotes;
+  char *sp, *ep;
+
+  setspan(&event->key, "", 0);
+  setspan(&event->value, "", 0);
+  sp = skipleading(line);
+  if (*sp == '\0')
+    return event->type = INI_EVENT_BLANK;
+  if (is_comment(*sp)) {
+    sp = skipleading(sp + 1);
+    striptrailing(sp);
+    setspan(&event->value, sp, (SceSize)strlen(sp));
+    return event->type = INI_EVENT_COMMENT;
+  }
+  /* see whether we reached a new section */
+  ep = strrchr(sp, ']');
+  if (*sp == '[' && ep != NULL) {
+    sp = skipleading(sp + 1);
+    ep = skiptrailing(ep, sp);
+    *ep = '\0';
+    ini_strncpy(section, sp, INI_BUFFERSIZE, QUOTE_NONE);
+    *sectionlen = (SceSize)strlen(section);
+    return event->type = INI_EVENT_SECTION;
+  }
+  /* not a new section, test for a key/value pair */
+  ep = finddelimiter(sp);    /* test for the equal sign or colon */
+  if (ep == NULL)
+    return -1;              /* invalid line */
+  *ep++ = '\0';             /* split the key from the value */
+  striptrailing(sp);
+  setspan(&event->key, sp, (SceSize)strlen(sp));
+  /* clean up the value, dequoting it in place */
+  sp = skipleading(ep);
+  sp = cleanstring(sp, &quotes);  /* Remove a trailing comment */
+  ini_strncpy(sp, sp, (SceSize)strlen(sp) + 1, quotes);
+  setspan(&event->value, sp, (SceSize)strlen(sp));
+  return event->type = INI_EVENT_KEY;
+}
+
+/** ini_next()
+ * \param reader      a reader opened with ini_reader_open()
+ * \param event       the event to fill in
+ *
+ * Reads the next line of the INI file. All strings in the event point into
+ * the reader (no copies are made), and they are valid until the next call.
+ * Lines that are neither a section, a setting, a comment nor blank, are
+ * skipped.
+ *
+ * \return            the event type, INI_EVENT_EOF at the end of the file
+ */
+int ini_next(INI_READER *reader, INI_EVENT *event)
+{
+  assert(reader != NULL && event != NULL);
+  do {
+    if (!ini_readsrcline(reader->line, INI_BUFFERSIZE, &reader->fd)) {
+      setspan(&event->key, "", 0);
+      setspan(&event->value, "", 0);
+      event->type = INI_EVENT_EOF;
+      break;
+    }
+  } while (parseline(reader->line, reader->section, &reader->sectionlen, event) < 0);
+  setspan(&event->section, reader->section, reader->sectionlen);
+  return event->type;
+}
+
+/* Handle a complete line in the parser's line buffer */
+static SceBool feed_line(INI_PARSER *parser)
+{
+  INI_EVENT event;
+
+  parser->line[parser->len] = '\0';
+  parser->len = 0;
+  if (parseline(parser->line, parser->section, &parser->sectionlen, &event) == INI_EVENT_KEY)
+    parser->stopped = !parser->callback(parser->section, event.key.ptr, event.value.ptr, parser->userdata);
+  return !parser->stopped;
+}
+
+/** ini_parser_init()
+ * \param parser      the push parser to initialize
+ * \param Callback    a pointer to a function that will be called for every
+ *                    setting, like with ini_browse()
+ * \param UserData    arbitrary data, which the function passes on the
+ *                    \c Callback function
+ */
+void ini_parser_init(INI_PARSER *parser, INI_CALLBACK Callback, void *UserData)
+{
+  assert(parser != NULL && Callback != NULL);
+  parser->callback = Callback;
+  parser->userdata = UserData;
+  parser->len = 0;
+  parser->section[0] = '\0';
+  parser->sectionlen = 0;
+  parser->stopped = INI_FALSE;
+}
+
+/** ini_feed()
+ * \param parser      a parser set up with ini_parser_init()
+ * \param data        the next chunk of the INI file
+ * \param len         the size of the chunk in bytes
+ *
+ * The chunks may be split at any position, also in the middle of a line. Every
+ * byte is copied once, into the line buffer of the parser; a line that is
+ * longer than the buffer is split in the same way that ini_read() splits it.
+ *
+ * \return            1 to continue, 0 when the callback has stopped parsing
+ */
+SceBool ini_feed(INI_PARSER *parser, const char *data, SceSize len)
+{
+  assert(parser != NULL);
+  assert(data != NULL || len == 0);
+  while (len > 0 && !parser->stopped) {
+    SceBool complete;
+    SceSize n = take_line(parser->line, &parser->len, data, len, &complete);
+    data += n;
+    len -= n;
+    if (complete)
+      (void)feed_line(parser);
+  }
+  return !parser->stopped;
+}
+
+/** ini_feed_end()
+ * \param parser      a parser set up with ini_parser_init()
+ *
+ * Handles the last line, if it has no line terminator.
+ *
+ * \return            1 if parsing ran to the end, 0 if the callback stopped it
+ */
+SceBool ini_feed_end(INI_PARSER *parser)
+{
+  assert(parser != NULL);
+  if (parser->len > 0 && !parser->stopped)
+    (void)feed_line(parser);
+  return !parser->stopped;
+}
+
+/** ini_browse()
+ * \param Callback    a pointer to a function that will be called for every
+ *                    setting in the INI file.
+ * \param UserData    arbitrary data, which the function passes on the
+ *                    \c Callback function
+ * \param Filename    the name and full path of the .ini file to read from
+ *
+ * \return            1 on success, 0 on failure (INI file not found)
+ *
+ * \note              The \c Callback function must return 1 to continue
+ *                    browsing through the INI file, or 0 to stop. Even when the
+ *                    callback stops the browsing, this function will return 1
+ *                    (for success).
+ */
+SceBool ini_browse(INI_CALLBACK Callback, void *UserData, const char *Filename)
+{
+  INI_READER reader;
+  INI_EVENT event;
+  int type;
+
+  if (Callback == NULL)
+    return INI_FALSE;
+  TRACE_BEGIN("ini_browse");
+  if (!ini_reader_open(&reader, Filename)) {
+    TRACE_END("ini_browse");
+    return INI_FALSE;
+  }
+  while ((type = ini_next(&reader, &event)) != INI_EVENT_EOF)
+    if (type == INI_EVENT_KEY && !Callback(event.section.ptr, event.key.ptr, event.value.ptr, UserData))
+      break;
+  ini_reader_close(&reader);
+  TRACE_END("ini_browse");
+  return INI_TRUE;
+}
+#endif /* INI_BROWSE */
+
+#if INI_LAZYINDEX || INI_VERSIONS || INI_IMAGE
+/* Split a key/value line (same rules as getkeystring()) in place; the value
+ * is dequoted. Returns false for a line that holds no key, or an empty key
+ * (which getkeystring() never matches).
+ */
+static SceBool splitkey(char *line, char **key, SceSize *keylen, char **value)
+{
+  enum quote_option quotes;
+  char *sp, *ep, *vp;
+
+  sp = skipleading(line);
+  if (is_comment(*sp))
+    return INI_FALSE;
+  ep = finddelimiter(sp);
+  if (ep == NULL)
+    return INI_FALSE;
+  *key = sp;
+  *keylen = (SceSize)(skiptrailing(ep, sp) - sp);
+  if (*keylen == 0)
+    return INI_FALSE;
+  vp = cleanstring(skipleading(ep + 1), &quotes);
+  ini_strncpy(vp, vp, (SceSize)strlen(vp) + 1, quotes);
+  *value = vp;
+  return INI_TRUE;
+}
+#endif
+
+#if INI_LAZYINDEX || INI_VERSIONS
+/* A parsed section is a single block: a header followed by variable-length
+ * records, each holding the hash of the key, the key and the (dequoted) value.
+ * The block holds no pointers, so it can be moved or reallocated freely.
+ */
+typedef struct {
+  SceSize size;       /* bytes in use, including this header */
+  SceSize capacity;   /* bytes allocated */
+  int     count;      /* number of records */
+} INI_BLOCK;
+
+typedef struct {
+  SceUInt32 hash;     /* hash of the key, case-folded unless names are case-sensitive */
+  SceUShort16 keylen;
+  SceUShort16 vallen;
+  /* followed by the key and the value, both zero-terminated */
+} INI_RECORD;
+
+#define RECORD_SIZE(keylen,vallen)  ((sizeof(INI_RECORD) + (keylen) + (vallen) + 2 + 3) & ~(SceSize)3)
+#define record_key(rec)             ((const char *)(rec) + sizeof(INI_RECORD))
+#define record_value(rec)           (record_key(rec) + (rec)->keylen + 1)
+#define record_next(rec)            ((const INI_RECORD *)((const char *)(rec) + RECORD_SIZE((rec)->keylen, (rec)->vallen)))
+#if INI_CASESENSITIVE
+  #define exact_names(handle)       INI_TRUE
+#else
+  #define exact_names(handle)       ((handle)->casesensitive)
+#endif
+#define block_first(block)          ((const INI_RECORD *)((const char *)(block) + sizeof(INI_BLOCK)))
+
+/* Add a record at the end of the block; the block must have room for it */
+static void block_store(INI_BLOCK *block, const char *key, SceSize keylen, const char *value, SceSize vallen,
+                        SceBool exact)
+{
+  INI_RECORD *rec = (INI_RECORD *)((char *)block + block->size);
+
+  assert(block->size + RECORD_SIZE(keylen, vallen) <= block->capacity);
+  rec->hash = ini_hashcase(key, keylen, exact);
+  rec->keylen = (SceUShort16)keylen;
+  rec->vallen = (SceUShort16)vallen;
+  memcpy((char *)rec + sizeof(INI_RECORD), key, keylen);
+  *((char *)rec + sizeof(INI_RECORD) + keylen) = '\0';
+  memcpy((char *)rec + sizeof(INI_RECORD) + keylen + 1, value, vallen);
+  *((char *)rec + sizeof(INI_RECORD) + keylen + 1 + vallen) = '\0';
+  block->size += RECORD_SIZE(keylen, vallen);
+  block->count++;
+}
+
+/* Return the first record for the key, or NULL */
+static const INI_RECORD *block_find(const INI_BLOCK *block, const char *key, SceSize keylen, SceBool exact)
+{
+  SceUInt32 hash = ini_hashcase(key, keylen, exact);
+  const INI_RECORD *rec;
+  int i;
+
+  for (i = 0, rec = block_first(block); i < block->count; i++, rec = record_next(rec))
+    if (rec->hash == hash && (SceSize)rec->keylen == keylen && namememcmp(record_key(rec), key, keylen, exact) == 0)
+      return rec;
+  return NULL;
+}
+
+/* Collect the values of a key from a parsed section, like getkeyvalues() */
+static int block_values(const INI_BLOCK *block, const char *Key, SceBool exact, int Policy,
+                        char *Buffer, SceSize BufferSize)
+{
+  SceSize keylen = (SceSize)strlen(Key), used = 0;
+  SceUInt32 hash = ini_hashcase(Key, keylen, exact);
+  const INI_RECORD *rec, *match = NULL;
+  int i, count = 0;
+
+  assert(BufferSize >= 2);
+  for (i = 0, rec = block_first(block); i < block->count && used + 1 < BufferSize; i++, rec = record_next(rec)) {
+    if (rec->hash != hash || (SceSize)rec->keylen != keylen || namememcmp(record_key(rec), Key, keylen, exact) != 0)
+      continue;
+    if (Policy == INI_DUP_ALL) {
+      ini_strncpy(Buffer + used, record_value(rec), BufferSize - used - 1, QUOTE_NONE);
+      used += (SceSize)strlen(Buffer + used) + 1;
+      count++;
+    } else {
+      match = rec;
+      if (Policy == INI_DUP_FIRST)
+        break;
+    }
+  }
+  if (match != NULL) {
+    ini_strncpy(Buffer, record_value(match), BufferSize - 1, QUOTE_NONE);
+    used = (SceSize)strlen(Buffer) + 1;
+    count = 1;
+  }
+  Buffer[used] = '\0';
+  if (used == 0)
+    Buffer[1] = '\0';  /* an empty list also ends with two zero bytes */
+  return count;
+}
+
+/* The memory of an index or a document comes from its allocator, or from
+ * ini_malloc() when the allocator has no functions. A block from an allocator
+ * starts with a header that holds its size, for the sized free and for
+ * mem_realloc().
+ */
+typedef union {
+  SceSize   size;
+  SceUInt64 align;
+  double    falign;
+} MEM_HEADER;
+
+static void *mem_alloc(const INI_ALLOCATOR *allocator, SceSize size)
+{
+  MEM_HEADER *head;
+
+  if (allocator->alloc == NULL)
+    return ini_malloc(size);
+  head = (MEM_HEADER *)allocator->alloc(allocator->context, sizeof(MEM_HEADER) + size);
+  if (head == NULL)
+    return NULL;
+  head->size = size;
+  return head + 1;
+}
+
+static void mem_free(const INI_ALLOCATOR *allocator, void *ptr)
+{
+  MEM_HEADER *head;
+
+  if (allocator->alloc == NULL) {
+    ini_free(ptr);
+    return;
+  }
+  if (ptr == NULL)
+    return;
+  head = (MEM_HEADER *)ptr - 1;
+  if (allocator->free != NULL)
+    allocator->free(allocator->context, head, sizeof(MEM_HEADER) + head->size);
+}
+
+static void *mem_realloc(const INI_ALLOCATOR *allocator, void *ptr, SceSize size)
+{
+  void *grown;
+
+  if (allocator->alloc == NULL)
+    return ini_realloc(ptr, size);
+  if ((grown = mem_alloc(allocator, size)) != NULL && ptr != NULL) {
+    SceSize oldsize = ((MEM_HEADER *)ptr - 1)->size;
+    memcpy(grown, ptr, (oldsize < size) ? oldsize : size);
+    mem_free(allocator, ptr);
+  }
+  return grown;
+}
+#endif /* INI_LAZYINDEX || INI_VERSIONS */
+
+#if INI_LAZYINDEX
+/* Drop the section tree (see index_tree()) after the sections changed */
+static void index_droptree(INI_INDEX *index)
+{
+  if (index->tree != NULL)
+    mem_free(&index->allocator, index->tree);
+  index->tree = NULL;
+}
+
+/* Handle a line starting with '[' (the text after the bracket is in "line").
+ * Any such line ends the current section; it only starts a new section if it
+ * has a closing bracket.
+ */
+static SceBool index_addsection(INI_INDEX *index, char *line, INI_FILEPOS head, INI_FILEPOS next)
+{
+  INI_SECTIONSPAN *span;
+  char *sp, *ep;
+  SceSize len;
+
+  assert(index->count > 0);
+  if (index->sections[index->count - 1].end < 0)
+    index->sections[index->count - 1].end = head;
+  if ((ep = strrchr(line, ']')) == NULL)
+    return INI_TRUE;
+  sp = skipleading(line);
+  ep = skiptrailing(ep, sp);
+  len = (SceSize)(ep - sp);
+
+  if (index->count == index->capacity) {
+    int capacity = 2 * index->capacity;
+    span = (INI_SECTIONSPAN *)mem_realloc(&index->allocator, index->sections, capacity * sizeof(INI_SECTIONSPAN));
+    if (span == NULL)
+      return INI_FALSE;
+    index->sections = span;
+    index->capacity = capacity;
+  }
+  if (index->namesize + len + 1 > index->namecapacity) {
+    SceSize capacity = 2 * index->namecapacity + len + 1;
+    char *names = (char *)mem_realloc(&index->allocator, index->names, capacity);
+    if (names == NULL)
+      return INI_FALSE;
+    index->names = names;
+    index->namecapacity = capacity;
+  }
+  index_droptree(index);
+  span = &index->sections[index->count++];
+  span->start = next;
+  span->end = -1;   /* still open */
+  span->hash = ini_hashcase(sp, len, exact_names(index));
+  span->name = index->namesize;
+  span->parsed = NULL;
+  span->newer = span->older = -1;
+  span->oversize = INI_FALSE;
+  memcpy(index->names + index->namesize, sp, len);
+  index->names[index->namesize + len] = '\0';
+  index->namesize += len + 1;
+  return INI_TRUE;
+}
+
+/** ini_index_open()
+ * \param index       the index to initialize
+ * \param Filename    the name and full path of the .ini file to index
+ *
+ * Only the section headers are read when the index is opened; the keys in a
+ * section are parsed when the section is first looked up.
+ *
+ * \return            1 on success, 0 on failure (file not found, or out of
+ *                    memory)
+ */
+SceBool ini_index_open(INI_INDEX *index, const char *Filename)
+{
+  return ini_index_open_alloc(index, Filename, NULL);
+}
+
+/** ini_index_open_alloc()
+ * \param index       the index to initialize
+ * \param Filename    the name and full path of the .ini file to index
+ * \param Allocator   the functions that all memory of the index comes from,
+ *                    or NULL for ini_malloc() and ini_free(); the functions
+ *                    are copied, the context must stay valid until
+ *                    ini_index_close()
+ *
+ * \return            1 on success, 0 on failure (file not found, or out of
+ *                    memory)
+ */
+SceBool ini_index_open_alloc(INI_INDEX *index, const char *Filename, const INI_ALLOCATOR *Allocator)
+{
+  enum { LINE_START, LINE_SKIP, LINE_HEADER } state = LINE_START;
+  char Block[INI_SCANSIZE];
+  char LocalBuffer[INI_BUFFERSIZE];
+  INI_FILETYPE fd;
+  INI_FILEPOS pos, head;
+  SceSize len = 0, col = 0;
+  SceBool ok = INI_TRUE;
+  int n;
+
+  assert(index != NULL && Filename != NULL);
+  TRACE_BEGIN("ini_index_open");
+  memset(index, 0, sizeof(INI_INDEX));
+  if (Allocator != NULL)
+    index->allocator = *Allocator;
+  index->filename = (char *)mem_alloc(&index->allocator, strlen(Filename) + 1);
+  index->capacity = 16;
+  index->sections = (INI_SECTIONSPAN *)mem_alloc(&index->allocator, index->capacity * sizeof(INI_SECTIONSPAN));
+  if (index->filename == NULL || index->sections == NULL || !ini_opensource(Filename, &fd)) {
+    ini_index_close(index);
+    TRACE_END("ini_index_open");
+    return INI_FALSE;
+  }
+  strcpy(index->filename, Filename);
+  /* the keys above the first section form a section without a name */
+  memset(&index->sections[0], 0, sizeof(INI_SECTIONSPAN));
+  index->sections[0].end = -1;
+  index->sections[0].newer = index->sections[0].older = -1;
+  index->count = 1;
+  index->mru = index->lru = -1;
+  index->cache.budget = INI_CACHEBUDGET;
+
+  /* lines are split like ini_read() splits them, when they are too long for
+   * the buffer; "col" counts the bytes of the current line */
+  pos = head = 0;
+  while (ok && (n = ini_readblock(Block, INI_SCANSIZE, &fd)) > 0) {
+    SceSize i = 0, k, room;
+    SceBool eol;
+    while (ok && i < (SceSize)n) {
+      switch (state) {
+      case LINE_START:
+        if (Block[i] == INI_LINETERMCHAR) {
+          col = 0;
+          head = pos + i + 1;
+        } else if (Block[i] == '[') {
+          state = LINE_HEADER;
+          len = 0;
+          col++;
+        } else if ('\0' < Block[i] && Block[i] <= ' ') {
+          col++;
+        } else {
+          state = LINE_SKIP;
+          break;
+        }
+        i++;
+        if (state == LINE_START && col == INI_BUFFERSIZE - 1) {
+          col = 0;
+          head = pos + i;
+        }
+        break;
+      case LINE_SKIP:
+      case LINE_HEADER:
+        room = INI_BUFFERSIZE - 1 - col;
+        k = scan_lineterm(Block + i, (n - i < room) ? n - i : room);
+        eol = (k < n - i && k < room);
+        if (state == LINE_HEADER) {
+          memcpy(LocalBuffer + len, Block + i, k);
+          len += k;
+        }
+        i += k;
+        col += k;
+        if (eol || col == INI_BUFFERSIZE - 1) {
+          if (eol)
+            i++;
+          if (state == LINE_HEADER) {
+            LocalBuffer[len] = '\0';
+            ok = index_addsection(index, LocalBuffer, head, pos + i);
+          }
+          head = pos + i;
+          col = 0;
+          state = LINE_START;
+        }
+        break;
+      }
+    }
+    pos += n;
+  }
+  if (ok && state == LINE_HEADER) {
+    LocalBuffer[len] = '\0';
+    ok = index_addsection(index, LocalBuffer, head, pos);
+  }
+  if (index->sections[index->count - 1].end < 0)
+    index->sections[index->count - 1].end = pos;
+  (void)ini_close(&fd);
+  if (!ok)
+    ini_index_close(index);
+  TRACE_END("ini_index_open");
+  return ok;
+}
+
+/** ini_index_close()
+ * \param index       the index to release
+ */
+void ini_index_close(INI_INDEX *index)
+{
+  int i;
+
+  assert(index != NULL);
+  for (i = 0; i < index->count; i++)
+    if (index->sections[i].parsed != NULL)
+      mem_free(&index->allocator, index->sections[i].parsed);
+  if (index->sections != NULL)
+    mem_free(&index->allocator, index->sections);
+  if (index->names != NULL)
+    mem_free(&index->allocator, index->names);
+  if (index->filename != NULL)
+    mem_free(&index->allocator, index->filename);
+  if (index->tree != NULL)
+    mem_free(&index->allocator, index->tree);
+  memset(index, 0, sizeof(INI_INDEX));
+}
+
+/* Unlink a parsed section from the LRU list */
+static void lru_unlink(INI_INDEX *index, int i)
+{
+  INI_SECTIONSPAN *span = &index->sections[i];
+
+  if (span->newer >= 0)
+    index->sections[span->newer].older = span->older;
+  else
+    index->mru = span->older;
+  if (span->older >= 0)
+    index->sections[span->older].newer = span->newer;
+  else
+    index->lru = span->newer;
+  span->newer = span->older = -1;
+}
+
+/* Insert a parsed section at the head (most recently used end) of the LRU list */
+static void lru_push(INI_INDEX *index, int i)
+{
+  INI_SECTIONSPAN *span = &index->sections[i];
+
+  span->newer = -1;
+  span->older = index->mru;
+  if (index->mru >= 0)
+    index->sections[index->mru].newer = i;
+  else
+    index->lru = i;
+  index->mru = i;
+}
+
+/* Drop the least recently used parsed section; its byte range is kept, so it
+ * is parsed again on its next access.
+ */
+static void index_evict(INI_INDEX *index)
+{
+  int i = index->lru;
+  INI_BLOCK *block;
+
+  assert(i >= 0);
+  block = (INI_BLOCK *)index->sections[i].parsed;
+  assert(block != NULL);
+  lru_unlink(index, i);
+  index->cache.used -= block->capacity;
+  index->cache.evictions++;
+  mem_free(&index->allocator, block);
+  index->sections[i].parsed = NULL;
+}
+
+#if !INI_READONLY || !INI_CASESENSITIVE
+/* Drop the parsed keys of a section whose contents (or the way they are looked up) changed */
+static void index_drop(INI_INDEX *index, int i)
+{
+  INI_SECTIONSPAN *span = &index->sections[i];
+
+  if (span->parsed != NULL) {
+    lru_unlink(index, i);
+    index->cache.used -= ((INI_BLOCK *)span->parsed)->capacity;
+    mem_free(&index->allocator, span->parsed);
+    span->parsed = NULL;
+  }
+  span->oversize = INI_FALSE;
+}
+#endif
+
+/* Evict parsed sections until a block of "size" bytes fits in the budget */
+static SceBool index_reserve(INI_INDEX *index, SceSize size)
+{
+  if (index->cache.budget == 0)
+    return INI_TRUE;
+  while (index->cache.used + size > index->cache.budget && index->lru >= 0)
+    index_evict(index);
+  return index->cache.used + size <= index->cache.budget;
+}
+
+/* Parse a key/value line (same rules as getkeystring()) and add it to the block */
+static SceBool block_addline(INI_INDEX *index, INI_BLOCK **block, char *line)
+{
+  char *sp, *vp;
+  SceSize keylen, vallen, size;
+
+  if (!splitkey(line, &sp, &keylen, &vp))
+    return INI_TRUE;
+  vallen = (SceSize)strlen(vp);
+
+  size = RECORD_SIZE(keylen, vallen);
+  if ((*block)->size + size > (*block)->capacity) {
+    SceSize capacity = 2 * (*block)->capacity + size;
+    INI_BLOCK *grown;
+    if (index->cache.budget > 0 && capacity > index->cache.budget)
+      capacity = index->cache.budget;
+    if (capacity < (*block)->size + size || !index_reserve(index, capacity))
+      return INI_FALSE;
+    grown = (INI_BLOCK *)mem_realloc(&index->allocator, *block, capacity);
+    if (grown == NULL)
+      return INI_FALSE;
+    grown->capacity = capacity;
+    *block = grown;
+  }
+  block_store(*block, sp, keylen, vp, vallen, exact_names(index));
+  return INI_TRUE;
+}
+
+/* Read the byte range of the section and parse all keys in it. Returns NULL
+ * if the section cannot be held in the cache (it is too big for the budget,
+ * or memory ran out); the section must then be read from the file.
+ */
+static const INI_BLOCK *index_parse(INI_INDEX *index, INI_SECTIONSPAN *span)
+{
+  char Block[INI_SCANSIZE];
+  char LocalBuffer[INI_BUFFERSIZE];
+  INI_BLOCK *block;
+  INI_FILETYPE fd;
+  INI_FILEPOS pos;
+  SceSize len = 0;
+  SceBool ok = INI_TRUE;
+
+  if (span->parsed != NULL) {
+    index->cache.hits++;
+    lru_unlink(index, (int)(span - index->sections));
+    lru_push(index, (int)(span - index->sections));
+    return (const INI_BLOCK *)span->parsed;
+  }
+  index->cache.misses++;
+  if (span->oversize || !index_reserve(index, sizeof(INI_BLOCK) + 64))
+    return NULL;
+  block = (INI_BLOCK *)mem_alloc(&index->allocator, sizeof(INI_BLOCK) + 64);
+  if (block == NULL)
+    return NULL;
+  block->size = sizeof(INI_BLOCK);
+  block->capacity = sizeof(INI_BLOCK) + 64;
+  block->count = 0;
+  if (!ini_opensource(index->filename, &fd)) {
+    mem_free(&index->allocator, block);
+    return NULL;
+  }
+  pos = span->start;
+  if (!ini_seek(&fd, &pos)) {
+    (void)ini_close(&fd);
+    mem_free(&index->allocator, block);
+    return NULL;
+  }
+  while (ok && pos < span->end) {
+    SceSize i = 0;
+    int n = ini_readblock(Block, (span->end - pos < INI_SCANSIZE) ? (SceSize)(span->end - pos) : INI_SCANSIZE, &fd);
+    if (n <= 0)
+      break;
+    pos += n;
+    while (ok && i < (SceSize)n) {
+      SceBool complete;
+      i += take_line(LocalBuffer, &len, Block + i, n - i, &complete);
+      if (complete) {
+        LocalBuffer[len] = '\0';
+        ok = block_addline(index, &block, LocalBuffer);
+        len = 0;
+      }
+    }
+  }
+  (void)ini_close(&fd);
+  if (ok && len > 0) {
+    LocalBuffer[len] = '\0';
+    ok = block_addline(index, &block, LocalBuffer);
+  }
+  if (!ok) {
+    mem_free(&index->allocator, block);
+    span->oversize = INI_TRUE;
+    return NULL;
+  }
+  if (block->size < block->capacity) {
+    INI_BLOCK *shrunk = (INI_BLOCK *)mem_realloc(&index->allocator, block, block->size);
+    if (shrunk != NULL) {
+      block = shrunk;
+      block->capacity = block->size;
+    }
+  }
+  span->parsed = block;
+  index->cache.used += block->capacity;
+  lru_push(index, (int)(span - index->sections));
+  return block;
+}
+
+/* The section tree is built on the first lookup of a section by name, or on
+ * the first query on the hierarchy of dotted section names ([a.b.c] is a
+ * child of [a.b]). It has a node for every section name and for every prefix
+ * of a name that ends before a dot, even when there is no section with that
+ * name. A hash table on the full name of a node finds it without walking the
+ * tree (the node of a name has its first section), and the named sections in
+ * every subtree are a run in the "order" table. The tree is a single block
+ * with no pointers, and it is dropped when sections are added, removed, or
+ * looked up differently.
+ */
+typedef struct {
+  SceUInt32 hash;     /* hash of the name of the node, like the section hashes */
+  int       span;     /* a section whose name starts with the name of the node */
+  int       len;      /* length of the name of the node */
+  int       section;  /* the first section with the name, or -1 for a prefix */
+  int       parent, child, sibling;
+  int       first, last;  /* the named sections in the subtree: order[first..last-1] */
+} TREE_NODE;
+
+typedef struct {
+  int       count;    /* number of nodes */
+  int       mask;     /* number of hash slots minus 1 */
+  int       named;    /* number of nodes with a section, in order[] */
+  /* followed by the nodes, the order table and the hash slots */
+} TREE_HEADER;
+
+#define tree_nodes(tree)    ((TREE_NODE *)((TREE_HEADER *)(tree) + 1))
+#define tree_order(tree)    ((int *)(tree_nodes(tree) + (tree)->count))
+#define tree_slots(tree)    (tree_order(tree) + (tree)->count)
+
+/* Return the node with the name (of "len" characters), or -1 */
+static int tree_find(const INI_INDEX *index, const TREE_HEADER *tree, const char *name, int len, SceUInt32 hash)
+{
+  const TREE_NODE *nodes = tree_nodes(tree);
+  const int *slots = tree_slots(tree);
+  int slot, n;
+
+  for (slot = (int)(hash & tree->mask); (n = slots[slot]) >= 0; slot = (slot + 1) & tree->mask)
+    if (nodes[n].hash == hash && nodes[n].len == len
+        && namememcmp(index->names + index->sections[nodes[n].span].name, name, len, exact_names(index)) == 0)
+      return n;
+  return -1;
+}
+
+static TREE_HEADER *index_tree(INI_INDEX *index)
+{
+  TREE_HEADER header, *tree;
+  TREE_NODE *nodes;
+  int *order, *slots;
+  int i, n, len, parent, slots_count, roots = -1;
+
+  if (index->tree != NULL)
+    return (TREE_HEADER *)index->tree;
+  /* every dot adds at most one node */
+  header.count = 0;
+  for (i = 1; i < index->count; i++) {
+    const char *name = index->names + index->sections[i].name;
+    if (*name != '\0')
+      for (header.count++; *name != '\0'; name++)
+        header.count += (*name == '.');
+  }
+  slots_count = 16;
+  while (slots_count < 2 * header.count)
+    slots_count *= 2;
+  header.mask = slots_count - 1;
+  header.named = 0;
+  tree = (TREE_HEADER *)mem_alloc(&index->allocator, sizeof(TREE_HEADER)
+                                  + header.count * (sizeof(TREE_NODE) + sizeof(int)) + slots_count * sizeof(int));
+  if (tree == NULL)
+    return NULL;
+  *tree = header;
+  tree->count = 0;    /* counts the nodes that are made */
+  nodes = tree_nodes(tree);
+  slots = (int *)((char *)nodes + header.count * (sizeof(TREE_NODE) + sizeof(int)));
+  for (n = 0; n < slots_count; n++)
+    slots[n] = -1;
+
+  for (i = 1; i < index->count; i++) {
+    const char *name = index->names + index->sections[i].name;
+    if (*name == '\0')
+      continue;
+    parent = -1;
+    for (len = 0; ; len++) {
+      if (name[len] != '.' && name[len] != '\0')
+        continue;
+      {
+        SceUInt32 hash = ini_hashcase(name, (SceSize)len, exact_names(index));
+        int slot = (int)(hash & tree->mask);
+        for (n = slots[slot]; n >= 0; n = slots[slot = (slot + 1) & tree->mask])
+          if (nodes[n].hash == hash && nodes[n].len == len
+              && namememcmp(index->names + index->sections[nodes[n].span].name, name, len, exact_names(index)) == 0)
+            break;
+        if (n < 0) {
+          n = tree->count++;
+          slots[slot] = n;
+          nodes[n].hash = hash;
+          nodes[n].span = i;
+          nodes[n].len = len;
+          nodes[n].section = -1;
+          nodes[n].parent = parent;
+          nodes[n].child = nodes[n].sibling = -1;
+        }
+      }
+      if (name[len] == '\0') {
+        if (nodes[n].section < 0)
+          nodes[n].section = i;
+        break;
+      }
+      parent = n;
+    }
+  }
+
+  /* link the children in the order in which they were made (that is, in
+   * file order) by prepending them in reverse */
+  for (n = tree->count - 1; n >= 0; n--) {
+    int *head = (nodes[n].parent >= 0) ? &nodes[nodes[n].parent].child : &roots;
+    nodes[n].sibling = *head;
+    *head = n;
+  }
+  /* walk the tree in pre-order, so that each subtree is a run in order[] */
+  order = (int *)(nodes + tree->count);
+  memmove(order + tree->count, slots, slots_count * sizeof(int));
+  n = roots;
+  while (n >= 0) {
+    nodes[n].first = tree->named;
+    if (nodes[n].section >= 0)
+      order[tree->named++] = n;
+    if (nodes[n].child >= 0) {
+      n = nodes[n].child;
+      continue;
+    }
+    while (n >= 0) {
+      nodes[n].last = tree->named;
+      if (nodes[n].sibling >= 0) {
+        n = nodes[n].sibling;
+        break;
+      }
+      n = nodes[n].parent;
+    }
+  }
+  index->tree = tree;
+  return tree;
+}
+
+/* Return the first section with the name; the keys above the first section
+ * have an empty name. The section is found through the hash table of the
+ * section tree, or by a scan over all sections if the tree cannot be built.
+ */
+static INI_SECTIONSPAN *index_section(INI_INDEX *index, const char *Section)
+{
+  SceSize len = (Section != NULL) ? (SceSize)strlen(Section) : 0;
+  const TREE_HEADER *tree;
+  SceUInt32 hash;
+  int i;
+
+  assert(index != NULL);
+  if (index->count == 0)
+    return NULL;
+  if (len == 0)
+    return &index->sections[0];
+  hash = ini_hashcase(Section, len, exact_names(index));
+  if ((tree = index_tree(index)) != NULL) {
+    i = tree_find(index, tree, Section, (int)len, hash);
+    return (i >= 0 && tree_nodes(tree)[i].section >= 0) ? &index->sections[tree_nodes(tree)[i].section] : NULL;
+  }
+  for (i = 1; i < index->count; i++) {
+    const char *name = index->names + index->sections[i].name;
+    if (index->sections[i].hash == hash && namecasecmp(name, Section, len, exact_names(index)) == 0 && name[len] == '\0')
+      return &index->sections[i];
+  }
+  return NULL;
+}
+
+/* Look up the value of a key (or with Key == NULL, the name of the key with
+ * index idxKey) in a section and copy it into the buffer. Sections that
+ * cannot be cached are read from the file directly.
+ */
+static SceBool index_lookupspan(INI_INDEX *index, INI_SECTIONSPAN *span, const char *Key, int idxKey,
+                                char *Buffer, SceSize BufferSize)
+{
+  const INI_BLOCK *block;
+  const INI_RECORD *rec;
+
+  assert(Key != NULL || idxKey >= 0);
+  if ((block = index_parse(index, span)) == NULL) {
+    INI_FILETYPE fd;
+    INI_FILEPOS pos = span->start;
+    SceBool ok = INI_FALSE;
+    if (ini_opensource(index->filename, &fd)) {
+      if (ini_seek(&fd, &pos))
+        ok = getkeystring(&fd, NULL, Key, -1, (Key != NULL) ? -1 : idxKey, Buffer, BufferSize, NULL, NULL);
+      (void)ini_close(&fd);
+    }
+    return ok;
+  }
+
+  if (Key == NULL) {
+    if (idxKey >= block->count)
+      return INI_FALSE;
+    for (rec = block_first(block); idxKey > 0; idxKey--)
+      rec = record_next(rec);
+    ini_strncpy(Buffer, record_key(rec), BufferSize, QUOTE_NONE);
+    return INI_TRUE;
+  }
+  if ((rec = block_find(block, Key, (SceSize)strlen(Key), exact_names(index))) == NULL)
+    return INI_FALSE;
+  ini_strncpy(Buffer, record_value(rec), BufferSize, QUOTE_NONE);
+  return INI_TRUE;
+}
+
+static SceBool index_lookup(INI_INDEX *index, const char *Section, const char *Key, int idxKey,
+                            char *Buffer, SceSize BufferSize)
+{
+  INI_SECTIONSPAN *span = index_section(index, Section);
+  return span != NULL && index_lookupspan(index, span, Key, idxKey, Buffer, BufferSize);
+}
+
+/** ini_index_gets()
+ * \param index       an index opened with ini_index_open()
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find the value of
+ * \param DefValue    default string in the event of a failed read
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy
+ *
+ * \return            the number of characters copied into the supplied buffer
+ */
+SceSize ini_index_gets(INI_INDEX *index, const char *Section, const char *Key, const char *DefValue,
+                       char *Buffer, SceSize BufferSize)
+{
+  SceBool ok;
+#if INI_PROFILE
+  SceUInt64 start = ini_clock();
+  SceUInt32 hits = index->cache.hits;
+#endif
+
+  if (Buffer == NULL || BufferSize <= 0 || Key == NULL)
+    return 0;
+  TRACE_BEGIN("ini_index_gets");
+  ok = index_lookup(index, Section, Key, -1, Buffer, BufferSize);
+  TRACE_END("ini_index_gets");
+#if INI_PROFILE
+  profile_record(index->filename, Section, Key, start, INI_PATH_INDEX, index->cache.hits != hits, ok);
+#endif
+  if (!ok)
+    ini_strncpy(Buffer, (DefValue != NULL) ? DefValue : "", BufferSize, QUOTE_NONE);
+  return (SceSize)strlen(Buffer);
+}
+
+/** ini_index_getdups()
+ * \param index       an index opened with ini_index_open()
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find the values of
+ * \param Policy      INI_DUP_FIRST, INI_DUP_LAST or INI_DUP_ALL, see
+ *                    ini_getdups()
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy, at least 2
+ *
+ * Like ini_getdups(), but the values come from the parsed section: one walk
+ * over its keys.
+ *
+ * \return            the number of values copied into the buffer, 0 if the
+ *                    key is not found
+ */
+int ini_index_getdups(INI_INDEX *index, const char *Section, const char *Key, int Policy,
+                      char *Buffer, SceSize BufferSize)
+{
+  INI_SECTIONSPAN *span;
+  const INI_BLOCK *block;
+  INI_FILETYPE fd;
+  INI_FILEPOS pos;
+  int count = 0;
+
+  if (Buffer == NULL || BufferSize < 2 || Key == NULL)
+    return 0;
+  Buffer[0] = Buffer[1] = '\0';
+  if ((span = index_section(index, Section)) == NULL)
+    return 0;
+  if ((block = index_parse(index, span)) != NULL)
+    return block_values(block, Key, exact_names(index), Policy, Buffer, BufferSize);
+  /* a section that cannot be cached is read from the file */
+  pos = span->start;
+  if (ini_opensource(index->filename, &fd)) {
+    if (ini_seek(&fd, &pos))
+      count = getkeyvalues(&fd, NULL, Key, Policy, Buffer, BufferSize);
+    (void)ini_close(&fd);
+  }
+  return count;
+}
+
+/** ini_index_haskey()
+ * \param index       an index opened with ini_index_open()
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find
+ *
+ * \return            1 if the key is found, 0 if not found
+ */
+SceBool ini_index_haskey(INI_INDEX *index, const char *Section, const char *Key)
+{
+  char LocalBuffer[8];  /* dummy buffer */
+  return Key != NULL && index_lookup(index, Section, Key, -1, LocalBuffer, sizeof(LocalBuffer));
+}
+
+/** ini_index_getsection()
+ * \param index       an index opened with ini_index_open()
+ * \param idx         the zero-based sequence number of the section to return
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy
+ *
+ * \return            the number of characters copied into the supplied buffer
+ */
+SceSize ini_index_getsection(INI_INDEX *index, int idx, char *Buffer, SceSize BufferSize)
+{
+  if (Buffer == NULL || BufferSize <= 0 || idx < 0)
+    return 0;
+  if (idx + 1 < index->count)
+    ini_strncpy(Buffer, index->names + index->sections[idx + 1].name, BufferSize, QUOTE_NONE);
+  else
+    *Buffer = '\0';
+  return (SceSize)strlen(Buffer);
+}
+
+/** ini_index_getkey()
+ * \param index       an index opened with ini_index_open()
+ * \param Section     the name of the section to browse through, or NULL to
+ *                    browse through the keys outside any section
+ * \param idx         the zero-based sequence number of the key to return
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy
+ *
+ * \return            the number of characters copied into the supplied buffer
+ */
+SceSize ini_index_getkey(INI_INDEX *index, const char *Section, int idx, char *Buffer, SceSize BufferSize)
+{
+  if (Buffer == NULL || BufferSize <= 0 || idx < 0)
+    return 0;
+  if (!index_lookup(index, Section, NULL, idx, Buffer, BufferSize))
+    *Buffer = '\0';
+  return (SceSize)strlen(Buffer);
+}
+
+/** ini_index_setbudget()
+ * \param index       an index opened with ini_index_open()
+ * \param Budget      the maximum number of bytes for parsed sections, or 0
+ *                    for no limit
+ *
+ * Parsed sections are evicted (least recently used first) until the index is
+ * within the new budget. The hit/miss/eviction counters are in index->cache.
+ */
+void ini_index_setbudget(INI_INDEX *index, SceSize Budget)
+{
+  int i;
+
+  assert(index != NULL);
+  index->cache.budget = Budget;
+  (void)index_reserve(index, 0);
+  for (i = 0; i < index->count; i++)
+    index->sections[i].oversize = INI_FALSE;  /* may fit in the new budget */
+}
+
+/* Return the node for the section, or for the nearest prefix of its name
+ * that is in the tree; -1 if there is none */
+static int tree_section(INI_INDEX *index, const TREE_HEADER *tree, const char *Section)
+{
+  int len = (int)strlen(Section), n;
+
+  while ((n = tree_find(index, tree, Section, len, ini_hashcase(Section, (SceSize)len, exact_names(index)))) < 0) {
+    while (len > 0 && Section[len - 1] != '.')
+      len--;
+    if (len-- <= 1)
+      return -1;
+  }
+  return n;
+}
+
+/** ini_index_getsubsection()
+ * \param index       an index opened with ini_index_open()
+ * \param Section     the section that is the top of the subtree, e.g.
+ *                    "Render.Shadows" for [Render.Shadows.Cascade0]; NULL or
+ *                    "" for all sections
+ * \param idx         the zero-based sequence number of the section to return
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy
+ *
+ * The sections in the subtree are the section itself (when it exists) and
+ * all sections whose names start with the name of the section and a dot.
+ * They come in the order of a walk over the tree (a section is followed by
+ * its subtree); sections with the same name are only returned once. The
+ * subtree is found through a hash table, so it does not depend on the number
+ * of sections in the file.
+ *
+ * \return            the number of characters copied into the supplied buffer
+ */
+SceSize ini_index_getsubsection(INI_INDEX *index, const char *Section, int idx, char *Buffer, SceSize BufferSize)
+{
+  TREE_HEADER *tree;
+  const TREE_NODE *nodes;
+  int first, last, n;
+
+  if (Buffer == NULL || BufferSize <= 0)
+    return 0;
+  *Buffer = '\0';
+  if (idx < 0 || (tree = index_tree(index)) == NULL)
+    return 0;
+  nodes = tree_nodes(tree);
+  if (Section == NULL || *Section == '\0') {
+    first = 0;
+    last = tree->named;
+  } else {
+    n = tree_find(index, tree, Section, (int)strlen(Section),
+                  ini_hashcase(Section, (SceSize)strlen(Section), exact_names(index)));
+    if (n < 0)
+      return 0;
+    first = nodes[n].first;
+    last = nodes[n].last;
+  }
+  if (idx >= last - first)
+    return 0;
+  n = tree_order(tree)[first + idx];
+  ini_strncpy(Buffer, index->names + index->sections[nodes[n].section].name, BufferSize, QUOTE_NONE);
+  return (SceSize)strlen(Buffer);
+}
+
+/** ini_index_gets_inherit()
+ * \param index       an index opened with ini_index_open()
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find the value of
+ * \param DefValue    default string in the event of a failed read
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy
+ *
+ * Like ini_index_gets(), but when the key is not in the section, it is
+ * looked up in the parent section (for [a.b.c], this is [a.b], or [a] if
+ * there is no [a.b]), and so on up to the top of the hierarchy. The keys
+ * above the first section are not part of the hierarchy.
+ *
+ * \return            the number of characters copied into the supplied buffer
+ */
+SceSize ini_index_gets_inherit(INI_INDEX *index, const char *Section, const char *Key, const char *DefValue,
+                               char *Buffer, SceSize BufferSize)
+{
+  TREE_HEADER *tree;
+  SceBool ok = INI_FALSE;
+  int n;
+
+  if (Buffer == NULL || BufferSize <= 0 || Key == NULL)
+    return 0;
+  TRACE_BEGIN("ini_index_gets_inherit");
+  if (Section == NULL || *Section == '\0' || (tree = index_tree(index)) == NULL) {
+    ok = index_lookup(index, Section, Key, -1, Buffer, BufferSize);
+  } else {
+    const TREE_NODE *nodes = tree_nodes(tree);
+    for (n = tree_section(index, tree, Section); n >= 0 && !ok; n = nodes[n].parent)
+      if (nodes[n].section >= 0)
+        ok = index_lookupspan(index, &index->sections[nodes[n].section], Key, -1, Buffer, BufferSize);
+  }
+  TRACE_END("ini_index_gets_inherit");
+  if (!ok)
+    ini_strncpy(Buffer, (DefValue != NULL) ? DefValue : "", BufferSize, QUOTE_NONE);
+  return (SceSize)strlen(Buffer);
+}
+
+/** ini_index_setcase()
+ * \param index       an index opened with ini_index_open()
+ * \param CaseSensitive whether the section and key names must match exactly;
+ *                    an index that is opened is not case-sensitive
+ *
+ * Case-sensitive names are compared with memcmp(), without folding the case
+ * of either name. The section names are hashed again and the parsed sections
+ * are dropped, so the keys are hashed again on their next access. With
+ * INI_CASESENSITIVE, all names are case-sensitive and this function does
+ * nothing.
+ */
+void ini_index_setcase(INI_INDEX *index, SceBool CaseSensitive)
+{
+#if INI_CASESENSITIVE
+  (void)index;
+  (void)CaseSensitive;
+#else
+  int i;
+
+  assert(index != NULL);
+  if (!index->casesensitive == !CaseSensitive)
+    return;
+  index->casesensitive = (CaseSensitive != INI_FALSE);
+  index_droptree(index);
+  for (i = 0; i < index->count; i++) {
+    if (i > 0) {  /* the section without a name is never looked up by name */
+      const char *name = index->names + index->sections[i].name;
+      index->sections[i].hash = ini_hashcase(name, (SceSize)strlen(name), index->casesensitive);
+    }
+    index_drop(index, i);
+  }
+#endif
+}
+#endif /* INI_LAZYINDEX */
+
+#if INI_VERSIONS
+/* A document version is a table of sections. A section never changes once it
+ * is in a version, so it is shared (with a reference count) by all versions
+ * in which it was not edited; an edit copies the table of sections and the
+ * one section that it changes. The history is a list of versions, and undo
+ * and redo only move the index of the current version.
+ */
+typedef struct {
+  int       refs;       /* number of versions that hold the section */
+  SceUInt32 hash;       /* hash of the section name, case-folded like the keys */
+  INI_BLOCK *keys;      /* the keys and their (dequoted) values */
+  /* followed by the name, zero-terminated */
+} DOC_SECTION;
+
+typedef struct {
+  int       refs;       /* held by the history and/or as the base of the document */
+  int       count;      /* sections[0] holds the keys above the first section */
+  DOC_SECTION *sections[1];
+} DOC_VERSION;
+
+#define section_name(sect)  ((const char *)(sect) + sizeof(DOC_SECTION))
+
+static DOC_SECTION *section_new(const INI_ALLOCATOR *allocator, const char *name, SceSize namelen, SceSize capacity,
+                                SceBool exact)
+{
+  DOC_SECTION *sect = (DOC_SECTION *)mem_alloc(allocator, sizeof(DOC_SECTION) + namelen + 1);
+  INI_BLOCK *keys = (INI_BLOCK *)mem_alloc(allocator, capacity);
+
+  assert(capacity >= sizeof(INI_BLOCK));
+  if (sect == NULL || keys == NULL) {
+    if (sect != NULL)
+      mem_free(allocator, sect);
+    if (keys != NULL)
+      mem_free(allocator, keys);
+    return NULL;
+  }
+  sect->refs = 0;
+  sect->hash = ini_hashcase(name, namelen, exact);
+  sect->keys = keys;
+  keys->size = sizeof(INI_BLOCK);
+  keys->capacity = capacity;
+  keys->count = 0;
+  memcpy((char *)sect + sizeof(DOC_SECTION), name, namelen);
+  *((char *)sect + sizeof(DOC_SECTION) + namelen) = '\0';
+  return sect;
+}
+
+static void section_release(const INI_ALLOCATOR *allocator, DOC_SECTION *sect)
+{
+  assert(sect->refs > 0);
+  if (--sect->refs == 0) {
+    mem_free(allocator, sect->keys);
+    mem_free(allocator, sect);
+  }
+}
+
+/* Add a key to a section that is still being built */
+static SceBool section_addkey(const INI_ALLOCATOR *allocator, DOC_SECTION *sect, const char *key, SceSize keylen,
+                              const char *value, SceSize vallen, SceBool exact)
+{
+  SceSize size = RECORD_SIZE(keylen, vallen);
+
+  if (sect->keys->size + size > sect->keys->capacity) {
+    SceSize capacity = 2 * sect->keys->capacity + size;
+    INI_BLOCK *grown = (INI_BLOCK *)mem_realloc(allocator, sect->keys, capacity);
+    if (grown == NULL)
+      return INI_FALSE;
+    grown->capacity = capacity;
+    sect->keys = grown;
+  }
+  block_store(sect->keys, key, keylen, value, vallen, exact);
+  return INI_TRUE;
+}
+
+static DOC_VERSION *version_new(const INI_ALLOCATOR *allocator, int count)
+{
+  DOC_VERSION *ver;
+
+  assert(count > 0);
+  ver = (DOC_VERSION *)mem_alloc(allocator, sizeof(DOC_VERSION) + (count - 1) * sizeof(DOC_SECTION *));
+  if (ver != NULL) {
+    ver->refs = 0;
+    ver->count = count;
+  }
+  return ver;
+}
+
+static void version_release(const INI_ALLOCATOR *allocator, DOC_VERSION *ver)
+{
+  int i;
+
+  assert(ver->refs > 0);
+  if (--ver->refs == 0) {
+    for (i = 0; i < ver->count; i++)
+      section_release(allocator, ver->sections[i]);
+    mem_free(allocator, ver);
+  }
+}
+
+/* Return the index of the nth section with the (non-empty) name, or -1; the
+ * number of sections with that name is stored in total (if not NULL) */
+static int doc_nth(DOC_SECTION *const *sections, int count, const char *name, SceSize len, int nth, int *total,
+                   SceBool exact)
+{
+  SceUInt32 hash = ini_hashcase(name, len, exact);
+  int i, found = -1, n = 0;
+
+  assert(len > 0);
+  for (i = 1; i < count; i++) {
+    if (sections[i]->hash == hash && namecasecmp(section_name(sections[i]), name, len, exact) == 0
+        && section_name(sections[i])[len] == '\0') {
+      if (n++ == nth) {
+        found = i;
+        if (total == NULL)
+          break;
+      }
+    }
+  }
+  if (total != NULL)
+    *total = n;
+  return found;
+}
+
+/* Return the index of the (first) section with the name, or -1; the keys
+ * above the first section have an empty name */
+static int doc_find(DOC_SECTION *const *sections, int count, const char *name, SceSize len, SceBool exact)
+{
+  return (len == 0) ? 0 : doc_nth(sections, count, name, len, 0, NULL, exact);
+}
+
+/* Make the version the current one; versions that could be redone are
+ * dropped from the history */
+static SceBool doc_push(INI_DOC *doc, DOC_VERSION *ver)
+{
+  int i;
+
+  for (i = doc->current + 1; i < doc->count; i++)
+    version_release(&doc->allocator, (DOC_VERSION *)doc->versions[i]);
+  doc->count = doc->current + 1;
+  if (doc->count == doc->capacity) {
+    int capacity = 2 * doc->capacity;
+    void **versions = (void **)mem_realloc(&doc->allocator, doc->versions, capacity * sizeof(void *));
+    if (versions == NULL)
+      return INI_FALSE;
+    doc->versions = versions;
+    doc->capacity = capacity;
+  }
+  ver->refs++;
+  doc->versions[doc->count] = ver;
+  doc->current = doc->count++;
+  return INI_TRUE;
+}
+
+/** ini_doc_open()
+ * \param doc         the document to initialize
+ * \param Filename    the name and full path of the .ini file to read
+ *
+ * The file is parsed into memory; a file that does not exist gives an empty
+ * document. As in the file, only the first of the sections with the same name
+ * is read and edited; erasing it makes the next one visible.
+ *
+ * \return            1 on success, 0 when out of memory
+ */
+SceBool ini_doc_open(INI_DOC *doc, const char *Filename)
+{
+  return ini_doc_open_alloc(doc, Filename, NULL);
+}
+
+/** ini_doc_open_alloc()
+ * \param doc         the document to initialize
+ * \param Filename    the name and full path of the .ini file to read
+ * \param Allocator   the functions that all memory of the document (and of
+ *                    all its versions) comes from, or NULL for ini_malloc()
+ *                    and ini_free(); the functions are copied, the context
+ *                    must stay valid until ini_doc_close()
+ *
+ * \return            1 on success, 0 when out of memory
+ */
+SceBool ini_doc_open_alloc(INI_DOC *doc, const char *Filename, const INI_ALLOCATOR *Allocator)
+{
+  char LocalBuffer[INI_BUFFERSIZE];
+  DOC_SECTION **list, *sect = NULL;
+  DOC_VERSION *ver = NULL;
+  INI_FILETYPE fd;
+  int count = 0, capacity = 16;
+  SceBool ok;
+
+  assert(doc != NULL && Filename != NULL);
+  TRACE_BEGIN("ini_doc_open");
+  memset(doc, 0, sizeof(INI_DOC));
+  if (Allocator != NULL)
+    doc->allocator = *Allocator;
+  doc->filename = (char *)mem_alloc(&doc->allocator, strlen(Filename) + 1);
+  doc->capacity = 8;
+  doc->versions = (void **)mem_alloc(&doc->allocator, doc->capacity * sizeof(void *));
+  list = (DOC_SECTION **)mem_alloc(&doc->allocator, capacity * sizeof(DOC_SECTION *));
+  ok = (doc->filename != NULL && doc->versions != NULL && list != NULL);
+  if (ok) {
+    strcpy(doc->filename, Filename);
+    if ((sect = section_new(&doc->allocator, "", 0, sizeof(INI_BLOCK) + 64, exact_names(doc))) != NULL)
+      list[count++] = sect;
+    ok = (sect != NULL);
+  }
+  if (ok && ini_opensource(Filename, &fd)) {
+    while (ok && ini_readline(LocalBuffer, INI_BUFFERSIZE, &fd)) {
+      char *sp = skipleading(LocalBuffer), *ep, *vp;
+      SceSize len;
+      if (*sp == '[') {
+        /* any '[' line ends a section, only a valid one starts a section */
+        sect = NULL;
+        if ((ep = strrchr(sp, ']')) != NULL) {
+          sp = skipleading(sp + 1);
+          ep = skiptrailing(ep, sp);
+          len = (SceSize)(ep - sp);
+          if (count == capacity) {
+            DOC_SECTION **grown = (DOC_SECTION **)mem_realloc(&doc->allocator, list, 2 * capacity * sizeof(DOC_SECTION *));
+            if ((ok = (grown != NULL)) == INI_FALSE)
+              break;
+            list = grown;
+            capacity *= 2;
+          }
+          ok = ((sect = section_new(&doc->allocator, sp, len, sizeof(INI_BLOCK) + 64, exact_names(doc))) != NULL);
+          if (ok)
+            list[count++] = sect;
+        }
+      } else if (sect != NULL && splitkey(LocalBuffer, &sp, &len, &vp)) {
+        ok = section_addkey(&doc->allocator, sect, sp, len, vp, (SceSize)strlen(vp), exact_names(doc));
+      }
+    }
+    (void)ini_close(&fd);
+  }
+  if (ok)
+    ver = version_new(&doc->allocator, count);
+  if (ver != NULL) {
+    memcpy(ver->sections, list, count * sizeof(DOC_SECTION *));
+    while (count > 0)
+      list[--count]->refs = 1;
+    ver->refs = 2;          /* the history and the base */
+    doc->versions[0] = ver;
+    doc->count = 1;
+    doc->base = ver;
+  }
+  while (count > 0) {
+    sect = list[--count];
+    mem_free(&doc->allocator, sect->keys);
+    mem_free(&doc->allocator, sect);
+  }
+  if (list != NULL)
+    mem_free(&doc->allocator, list);
+  TRACE_END("ini_doc_open");
+  if (ver == NULL) {
+    ini_doc_close(doc);
+    return INI_FALSE;
+  }
+  return INI_TRUE;
+}
+
+/** ini_doc_close()
+ * \param doc         the document to release, with all its versions
+ */
+void ini_doc_close(INI_DOC *doc)
+{
+  int i;
+
+  assert(doc != NULL);
+  for (i = 0; i < doc->count; i++)
+    version_release(&doc->allocator, (DOC_VERSION *)doc->versions[i]);
+  if (doc->base != NULL)
+    version_release(&doc->allocator, (DOC_VERSION *)doc->base);
+  if (doc->versions != NULL)
+    mem_free(&doc->allocator, doc->versions);
+  if (doc->filename != NULL)
+    mem_free(&doc->allocator, doc->filename);
+  memset(doc, 0, sizeof(INI_DOC));
+}
+
+/* Return the section in the current version, or NULL */
+static const DOC_SECTION *doc_section(const INI_DOC *doc, const char *Section)
+{
+  const DOC_VERSION *ver = (const DOC_VERSION *)doc->versions[doc->current];
+  int i = doc_find(ver->sections, ver->count, Section, (Section != NULL) ? (SceSize)strlen(Section) : 0,
+                   exact_names(doc));
+  return (i >= 0) ? ver->sections[i] : NULL;
+}
+
+/** ini_doc_gets()
+ * \param doc         a document opened with ini_doc_open()
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find the value of
+ * \param DefValue    default string in the event of a failed read
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy
+ *
+ * \return            the number of characters copied into the supplied buffer
+ */
+SceSize ini_doc_gets(INI_DOC *doc, const char *Section, const char *Key, const char *DefValue,
+                     char *Buffer, SceSize BufferSize)
+{
+  const DOC_SECTION *sect;
+  const INI_RECORD *rec = NULL;
+#if INI_PROFILE
+  SceUInt64 start = ini_clock();
+#endif
+
+  if (Buffer == NULL || BufferSize <= 0 || Key == NULL)
+    return 0;
+  if ((sect = doc_section(doc, Section)) != NULL)
+    rec = block_find(sect->keys, Key, (SceSize)strlen(Key), exact_names(doc));
+#if INI_PROFILE
+  profile_record(doc->filename, Section, Key, start, INI_PATH_DOC, INI_TRUE, rec != NULL);
+#endif
+  if (rec != NULL)
+    ini_strncpy(Buffer, record_value(rec), BufferSize, QUOTE_NONE);
+  else
+    ini_strncpy(Buffer, (DefValue != NULL) ? DefValue : "", BufferSize, QUOTE_NONE);
+  return (SceSize)strlen(Buffer);
+}
+
+/** ini_doc_getdups()
+ * \param doc         a document opened with ini_doc_open()
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find the values of
+ * \param Policy      INI_DUP_FIRST, INI_DUP_LAST or INI_DUP_ALL, see
+ *                    ini_getdups()
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy, at least 2
+ *
+ * \return            the number of values copied into the buffer, 0 if the
+ *                    key is not found
+ */
+int ini_doc_getdups(INI_DOC *doc, const char *Section, const char *Key, int Policy,
+                    char *Buffer, SceSize BufferSize)
+{
+  const DOC_SECTION *sect;
+
+  if (Buffer == NULL || BufferSize < 2 || Key == NULL)
+    return 0;
+  if ((sect = doc_section(doc, Section)) == NULL) {
+    Buffer[0] = Buffer[1] = '\0';
+    return 0;
+  }
+  return block_values(sect->keys, Key, exact_names(doc), Policy, Buffer, BufferSize);
+}
+
+/** ini_doc_getsection()
+ * \param doc         a document opened with ini_doc_open()
+ * \param idx         the zero-based sequence number of the section to return
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy
+ *
+ * \return            the number of characters copied into the supplied buffer
+ */
+SceSize ini_doc_getsection(INI_DOC *doc, int idx, char *Buffer, SceSize BufferSize)
+{
+  const DOC_VERSION *ver = (const DOC_VERSION *)doc->versions[doc->current];
+
+  if (Buffer == NULL || BufferSize <= 0 || idx < 0)
+    return 0;
+  if (idx + 1 < ver->count)
+    ini_strncpy(Buffer, section_name(ver->sections[idx + 1]), BufferSize, QUOTE_NONE);
+  else
+    *Buffer = '\0';
+  return (SceSize)strlen(Buffer);
+}
+
+/** ini_doc_getkey()
+ * \param doc         a document opened with ini_doc_open()
+ * \param Section     the name of the section to browse through, or NULL to
+ *                    browse through the keys outside any section
+ * \param idx         the zero-based sequence number of the key to return
+ * \param Buffer      a pointer to the buffer to copy into
+ * \param BufferSize  the maximum number of characters to copy
+ *
+ * \return            the number of characters copied into the supplied buffer
+ */
+SceSize ini_doc_getkey(INI_DOC *doc, const char *Section, int idx, char *Buffer, SceSize BufferSize)
+{
+  const DOC_SECTION *sect;
+  const INI_RECORD *rec;
+
+  if (Buffer == NULL || BufferSize <= 0 || idx < 0)
+    return 0;
+  *Buffer = '\0';
+  if ((sect = doc_section(doc, Section)) != NULL && idx < sect->keys->count) {
+    for (rec = block_first(sect->keys); idx > 0; idx--)
+      rec = record_next(rec);
+    ini_strncpy(Buffer, record_key(rec), BufferSize, QUOTE_NONE);
+  }
+  return (SceSize)strlen(Buffer);
+}
+
+/** ini_doc_puts()
+ * \param doc         a document opened with ini_doc_open()
+ * \param Section     the name of the section to write the string in
+ * \param Key         the name of the entry to write, or NULL to erase all keys in the section
+ * \param Value       a pointer to the buffer the string, or NULL to erase the key
+ *
+ * The change is made in a new version of the document, which becomes the
+ * current version; the file is not changed until ini_doc_save() is called.
+ * Versions that were undone are dropped. An edit that changes nothing does
+ * not make a new version.
+ *
+ * \return            1 if successful, 0 when out of memory
+ */
+SceBool ini_doc_puts(INI_DOC *doc, const char *Section, const char *Key, const char *Value)
+{
+  DOC_VERSION *cur = (DOC_VERSION *)doc->versions[doc->current], *ver;
+  DOC_SECTION *old, *sect = NULL;
+  const INI_RECORD *rec, *match = NULL;
+  SceSize len = (Section != NULL) ? (SceSize)strlen(Section) : 0;
+  SceSize keylen = 0, vallen = 0;
+  int i, j, k, count = cur->count;
+
+  i = doc_find(cur->sections, cur->count, Section, len, exact_names(doc));
+  old = (i >= 0) ? cur->sections[i] : NULL;
+  if (Key == NULL) {
+    /* erase the section; the keys above the first section are only cleared */
+    if (old == NULL || (i == 0 && old->keys->count == 0))
+      return INI_TRUE;
+    if (i > 0)
+      count--;
+    else if ((sect = section_new(&doc->allocator, "", 0, sizeof(INI_BLOCK), exact_names(doc))) == NULL)
+      return INI_FALSE;
+  } else {
+    keylen = (SceSize)strlen(Key);
+    if (keylen >= INI_BUFFERSIZE)
+      keylen = INI_BUFFERSIZE - 1;
+    if (old != NULL)
+      match = block_find(old->keys, Key, keylen, exact_names(doc));
+    if ((Value == NULL && match == NULL) || (Value != NULL && match != NULL && strcmp(record_value(match), Value) == 0))
+      return INI_TRUE;  /* nothing changes */
+    if (Value != NULL) {
+      vallen = (SceSize)strlen(Value);
+      if (vallen >= INI_BUFFERSIZE)
+        vallen = INI_BUFFERSIZE - 1;
+    }
+    /* copy the section, replacing or dropping the key (or adding it at the end) */
+    sect = section_new(&doc->allocator, (old != NULL) ? section_name(old) : Section, (old != NULL) ? strlen(section_name(old)) : len,
+                       ((old != NULL) ? old->keys->size : sizeof(INI_BLOCK)) + RECORD_SIZE(keylen, vallen), exact_names(doc));
+    if (sect == NULL)
+      return INI_FALSE;
+    for (k = 0, rec = (old != NULL) ? block_first(old->keys) : NULL; old != NULL && k < old->keys->count; k++, rec = record_next(rec)) {
+      if (rec != match)
+        block_store(sect->keys, record_key(rec), rec->keylen, record_value(rec), rec->vallen, exact_names(doc));
+      else if (Value != NULL)
+        block_store(sect->keys, Key, keylen, Value, vallen, exact_names(doc));
+    }
+    if (match == NULL)
+      block_store(sect->keys, Key, keylen, Value, vallen, exact_names(doc));
+    if (old == NULL)
+      i = count++;      /* a new section goes at the end */
+  }
+
+  if ((ver = version_new(&doc->allocator, count)) == NULL) {
+    if (sect != NULL) {
+      sect->refs = 1;
+      section_release(&doc->allocator, sect);
+    }
+    return INI_FALSE;
+  }
+  for (j = k = 0; j < cur->count; j++) {
+    if (j != i)
+      ver->sections[k++] = cur->sections[j];
+    else if (sect != NULL)
+      ver->sections[k++] = sect;
+  }
+  if (k < count)
+    ver->sections[k++] = sect;
+  assert(k == count);
+  for (j = 0; j < count; j++)
+    ver->sections[j]->refs++;
+  if (!doc_push(doc, ver)) {
+    ver->refs = 1;
+    version_release(&doc->allocator, ver);
+    return INI_FALSE;
+  }
+  return INI_TRUE;
+}
+
+/** ini_doc_undo()
+ * \param doc         a document opened with ini_doc_open()
+ *
+ * \return            1 if the previous version is now current, 0 if there
+ *                    was nothing to undo
+ */
+SceBool ini_doc_undo(INI_DOC *doc)
+{
+  return ini_doc_setversion(doc, doc->current - 1);
+}
+
+/** ini_doc_redo()
+ * \param doc         a document opened with ini_doc_open()
+ *
+ * \return            1 if the next version is now current, 0 if there was
+ *                    nothing to redo
+ */
+SceBool ini_doc_redo(INI_DOC *doc)
+{
+  return ini_doc_setversion(doc, doc->current + 1);
+}
+
+/** ini_doc_setversion()
+ * \param doc         a document opened with ini_doc_open()
+ * \param version     the zero-based sequence number of the version in the
+ *                    history (version 0 is the file as it was opened)
+ *
+ * \return            1 on success, 0 if there is no such version
+ */
+SceBool ini_doc_setversion(INI_DOC *doc, int version)
+{
+  assert(doc != NULL);
+  if (version < 0 || version >= doc->count)
+    return INI_FALSE;
+  doc->current = version;
+  return INI_TRUE;
+}
+
+#if !INI_CASESENSITIVE
+/* Hash the section names and the keys of a version again; the sections that
+ * it shares with other versions are simply hashed more than once */
+static void version_rehash(DOC_VERSION *ver, SceBool exact)
+{
+  const INI_RECORD *rec;
+  int i, k;
+
+  for (i = 0; i < ver->count; i++) {
+    DOC_SECTION *sect = ver->sections[i];
+    sect->hash = ini_hashcase(section_name(sect), (SceSize)strlen(section_name(sect)), exact);
+    for (k = 0, rec = block_first(sect->keys); k < sect->keys->count; k++, rec = record_next(rec))
+      ((INI_RECORD *)rec)->hash = ini_hashcase(record_key(rec), rec->keylen, exact);
+  }
+}
+#endif
+
+/** ini_doc_setcase()
+ * \param doc         a document opened with ini_doc_open()
+ * \param CaseSensitive whether the section and key names must match exactly;
+ *                    a document that is opened is not case-sensitive
+ *
+ * Case-sensitive names are compared with memcmp(), without folding the case
+ * of either name. All versions in the history are hashed again. With
+ * INI_CASESENSITIVE, all names are case-sensitive and this function does
+ * nothing.
+ */
+void ini_doc_setcase(INI_DOC *doc, SceBool CaseSensitive)
+{
+#if INI_CASESENSITIVE
+  (void)doc;
+  (void)CaseSensitive;
+#else
+  int i;
+
+  assert(doc != NULL);
+  if (!doc->casesensitive == !CaseSensitive)
+    return;
+  doc->casesensitive = (CaseSensitive != INI_FALSE);
+  for (i = 0; i < doc->count; i++)
+    version_rehash((DOC_VERSION *)doc->versions[i], doc->casesensitive);
+  if (doc->base != NULL)
+    version_rehash((DOC_VERSION *)doc->base, doc->casesensitive);
+#endif
+}
+#endif /* INI_VERSIONS */
+
+#if INI_IMAGE
+/* A published image is position independent: all references in it are byte
+ * offsets from the start of the image. It starts with a header, followed by
+ * the table of sections (sorted on the hash of the name), the tables of keys
+ * (one per section, sorted on the hash of the key) and the strings. Readers
+ * use the generation in the header as a sequence lock: it is odd while the
+ * image is being written, and it changes with every publication.
+ */
+#define IMAGE_MAGIC   "mImg"
+
+typedef struct {
+  char      magic[4];
+  volatile SceUInt32 generation;
+  SceUInt32 size;       /* bytes in use */
+  SceUInt32 count;      /* number of sections */
+} IMAGE_HEADER;
+
+typedef struct {
+  SceUInt32 hash;       /* hash of the case-folded name */
+  SceUInt32 name;       /* offset of the name */
+  SceUInt32 keys;       /* offset of the first IMAGE_KEY of the section */
+  SceUInt32 count;      /* number of keys */
+} IMAGE_SECTION;
+
+typedef struct {
+  SceUInt32 hash;       /* hash of the case-folded key */
+  SceUInt32 key;        /* offset of the key */
+  SceUInt32 value;      /* offset of the (dequoted) value */
+} IMAGE_KEY;
+
+/* The image is first built in these growing tables; string offsets are
+ * relative to the start of the string pool until the image is laid out.
+ */
+typedef struct {
+  IMAGE_SECTION *sections;
+  int       count, capacity;
+  struct BUILD_KEY {
+    SceUInt32 section;  /* index in the section table */
+    SceUInt32 order;    /* keeps the first of duplicate keys in front */
+    IMAGE_KEY key;
+  } *keys;
+  int       keycount, keycapacity;
+  char      *strings;
+  SceSize   size, stringcapacity;
+} IMAGE_BUILD;
+
+static SceBool image_grow(void **table, int *capacity, SceSize itemsize)
+{
+  int grown = (*capacity > 0) ? 2 * *capacity : 32;
+  void *p = ini_realloc(*table, grown * itemsize);
+  if (p == NULL)
+    return INI_FALSE;
+  *table = p;
+  *capacity = grown;
+  return INI_TRUE;
+}
+
+/* Add a string to the pool; returns its offset, or (SceUInt32)-1 */
+static SceUInt32 image_string(IMAGE_BUILD *build, const char *string, SceSize len)
+{
+  SceUInt32 offset = (SceUInt32)build->size;
+  if (build->size + len + 1 > build->stringcapacity) {
+    SceSize capacity = 2 * build->stringcapacity + len + 1;
+    char *strings = (char *)ini_realloc(build->strings, capacity);
+    if (strings == NULL)
+      return (SceUInt32)-1;
+    build->strings = strings;
+    build->stringcapacity = capacity;
+  }
+  memcpy(build->strings + build->size, string, len);
+  build->strings[build->size + len] = '\0';
+  build->size += len + 1;
+  return offset;
+}
+
+static SceBool image_addsection(IMAGE_BUILD *build, const char *name, SceSize len)
+{
+  IMAGE_SECTION *sect;
+
+  if (build->count == build->capacity
+      && !image_grow((void **)&build->sections, &build->capacity, sizeof(IMAGE_SECTION)))
+    return INI_FALSE;
+  sect = &build->sections[build->count];
+  sect->hash = ini_hash(name, len);
+  if ((sect->name = image_string(build, name, len)) == (SceUInt32)-1)
+    return INI_FALSE;
+  sect->keys = sect->count = 0;
+  build->count++;
+  return INI_TRUE;
+}
+
+static SceBool image_addkey(IMAGE_BUILD *build, const char *key, SceSize keylen, const char *value)
+{
+  struct BUILD_KEY *item;
+
+  if (build->keycount == build->keycapacity
+      && !image_grow((void **)&build->keys, &build->keycapacity, sizeof(struct BUILD_KEY)))
+    return INI_FALSE;
+  item = &build->keys[build->keycount];
+  item->section = (SceUInt32)(build->count - 1);
+  item->order = (SceUInt32)build->keycount;
+  item->key.hash = ini_hash(key, keylen);
+  if ((item->key.key = image_string(build, key, keylen)) == (SceUInt32)-1
+      || (item->key.value = image_string(build, value, (SceSize)strlen(value))) == (SceUInt32)-1)
+    return INI_FALSE;
+  build->keycount++;
+  return INI_TRUE;
+}
+
+static int image_comparekeys(const void *a, const void *b)
+{
+  const struct BUILD_KEY *ka = (const struct BUILD_KEY *)a;
+  const struct BUILD_KEY *kb = (const struct BUILD_KEY *)b;
+  if (ka->section != kb->section)
+    return (ka->section < kb->section) ? -1 : 1;
+  if (ka->key.hash != kb->key.hash)
+    return (ka->key.hash < kb->key.hash) ? -1 : 1;
+  return (ka->order < kb->order) ? -1 : (ka->order > kb->order);
+}
+
+static int image_comparesections(const void *a, const void *b)
+{
+  const IMAGE_SECTION *sa = (const IMAGE_SECTION *)a;
+  const IMAGE_SECTION *sb = (const IMAGE_SECTION *)b;
+  return (sa->hash < sb->hash) ? -1 : (sa->hash > sb->hash);
+}
+
+/* Parse the INI file into the tables; the keys of a section that occurs
+ * more than once are taken from its first occurrence (as in ini_gets()) */
+static SceBool image_parse(IMAGE_BUILD *build, const char *Filename)
+{
+  char LocalBuffer[INI_BUFFERSIZE];
+  INI_FILETYPE fd;
+  SceBool ok, insection = INI_TRUE;
+  int i;
+
+  if (!ini_opensource(Filename, &fd))
+    return INI_FALSE;
+  ok = image_addsection(build, "", 0);
+  while (ok && ini_readline(LocalBuffer, INI_BUFFERSIZE, &fd)) {
+    char *sp = skipleading(LocalBuffer), *ep;
+    SceSize len;
+    if (*sp == '[') {
+      insection = INI_FALSE;
+      if ((ep = strrchr(sp, ']')) != NULL) {
+        SceUInt32 hash;
+        sp = skipleading(sp + 1);
+        ep = skiptrailing(ep, sp);
+        len = (SceSize)(ep - sp);
+        hash = ini_hash(sp, len);
+        for (i = 0; i < build->count; i++)
+          if (build->sections[i].hash == hash && namencmp(build->strings + build->sections[i].name, sp, len) == 0
+              && build->strings[build->sections[i].name + len] == '\0')
+            break;
+        if (i == build->count)
+          ok = insection = image_addsection(build, sp, len);
+      }
+    } else if (insection && splitkey(LocalBuffer, &sp, &len, &ep)) {
+      ok = image_addkey(build, sp, len, ep);
+    }
+  }
+  (void)ini_close(&fd);
+  return ok;
+}
+
+/** ini_image_publish()
+ * \param Image       the memory to publish the image in, for example a block
+ *                    that is shared with other threads or modules; it must
+ *                    be 4-byte aligned
+ * \param ImageSize   the size of the memory
+ * \param Filename    the name and full path of the .ini file to read
+ *
+ * The file is parsed once, into a position-independent image that readers
+ * look up with ini_image_gets(), without parsing. A previous image in the
+ * memory is replaced; readers that run at the same time retry their lookup.
+ * Only one thread may publish in the same memory at a time.
+ *
+ * \return            the number of bytes that the image takes, or 0 on
+ *                    failure (file not found, out of memory, or the image
+ *                    does not fit, in which case the memory is not touched)
+ */
+SceSize ini_image_publish(void *Image, SceSize ImageSize, const char *Filename)
+{
+  IMAGE_HEADER *header = (IMAGE_HEADER *)Image;
+  IMAGE_BUILD build;
+  SceUInt32 generation, keybase, stringbase, size = 0;
+  SceBool ok;
+  int i, k;
+
+  assert(Image != NULL && Filename != NULL);
+  TRACE_BEGIN("ini_image_publish");
+  memset(&build, 0, sizeof(build));
+  ok = image_parse(&build, Filename);
+  if (ok) {
+    /* sort the keys per section, set the key range of each section, then sort the sections */
+    if (build.keycount > 0)
+      qsort(build.keys, build.keycount, sizeof(struct BUILD_KEY), image_comparekeys);
+    keybase = sizeof(IMAGE_HEADER) + build.count * sizeof(IMAGE_SECTION);
+    stringbase = keybase + build.keycount * sizeof(IMAGE_KEY);
+    for (i = k = 0; i < build.count; i++) {
+      build.sections[i].keys = keybase + k * sizeof(IMAGE_KEY);
+      build.sections[i].name += stringbase;
+      while (k < build.keycount && build.keys[k].section == (SceUInt32)i) {
+        build.sections[i].count++;
+        k++;
+      }
+    }
+    qsort(build.sections, build.count, sizeof(IMAGE_SECTION), image_comparesections);
+    size = stringbase + (SceUInt32)build.size;
+    ok = (size <= ImageSize);
+  }
+  if (ok) {
+    generation = (memcmp(header->magic, IMAGE_MAGIC, 4) == 0) ? header->generation & ~1u : 0;
+    header->generation = generation + 1;  /* odd: being written */
+    ini_barrier();
+    memcpy(header->magic, IMAGE_MAGIC, 4);
+    header->size = size;
+    header->count = (SceUInt32)build.count;
+    memcpy((char *)Image + sizeof(IMAGE_HEADER), build.sections, build.count * sizeof(IMAGE_SECTION));
+    for (k = 0; k < build.keycount; k++) {
+      IMAGE_KEY *key = (IMAGE_KEY *)((char *)Image + keybase) + k;
+      key->hash = build.keys[k].key.hash;
+      key->key = build.keys[k].key.key + stringbase;
+      key->value = build.keys[k].key.value + stringbase;
+    }
+    memcpy((char *)Image + stringbase, build.strings, build.size);
+    ini_barrier();
+    header->generation = generation + 2;
+  }
+  if (build.sections != NULL)
+    ini_free(build.sections);
+  if (build.keys != NULL)
+    ini_free(build.keys);
+  if (build.strings != NULL)
+    ini_free(build.strings);
+  TRACE_END("ini_image_publish");
+  return ok ? size : 0;
+}
+
+/* Compare a zero-terminated string in the image (that ends before limit)
+ * with a name, ignoring case */
+static SceBool image_match(const char *image, SceUInt32 offset, SceUInt32 limit, const char *name, SceSize len)
+{
+  return offset < limit && limit - offset > len && namememcmp(image + offset, name, len, INI_CASESENSITIVE) == 0 && image[offset + len] == '\0';
+}
+
+/* Look up the value in the image, and get its offset and length; every
+ * offset is checked against the limit, because the image may be overwritten
+ * while it is read */
+static SceBool image_lookup(const char *image, SceUInt32 limit, const char *Section, const char *Key,
+                            SceUInt32 *Offset, SceSize *Length)
+{
+  const IMAGE_HEADER *header = (const IMAGE_HEADER *)image;
+  const IMAGE_SECTION *sect;
+  const IMAGE_KEY *key;
+  SceSize len = (Section != NULL) ? (SceSize)strlen(Section) : 0;
+  SceUInt32 hash = ini_hash((Section != NULL) ? Section : "", len), lo, hi, count;
+
+  count = header->count;
+  if (count > (limit - sizeof(IMAGE_HEADER)) / sizeof(IMAGE_SECTION))
+    return INI_FALSE;
+  sect = (const IMAGE_SECTION *)(image + sizeof(IMAGE_HEADER));
+  for (lo = 0, hi = count; lo < hi; ) {
+    SceUInt32 mid = lo + (hi - lo) / 2;
+    if (sect[mid].hash < hash)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  for ( ; lo < count && sect[lo].hash == hash; lo++)
+    if (image_match(image, sect[lo].name, limit, (Section != NULL) ? Section : "", len))
+      break;
+  if (lo >= count || sect[lo].hash != hash)
+    return INI_FALSE;
+  sect += lo;
+
+  if (sect->keys > limit || sect->count > (limit - sect->keys) / sizeof(IMAGE_KEY))
+    return INI_FALSE;
+  key = (const IMAGE_KEY *)(image + sect->keys);
+  len = (SceSize)strlen(Key);
+  hash = ini_hash(Key, len);
+  for (lo = 0, hi = sect->count; lo < hi; ) {
+    SceUInt32 mid = lo + (hi - lo) / 2;
+    if (key[mid].hash < hash)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  for ( ; lo < sect->count && key[lo].hash == hash; lo++) {
+    if (image_match(image, key[lo].key, limit, Key, len)) {
+      SceUInt32 offset = key[lo].value;
+      SceSize n = 0;
+      while (offset + n < limit && image[offset + n] != '\0')
+        n++;
+      if (offset + n >= limit)
+        return INI_FALSE;   /* no terminator, the image was overwritten */
+      *Offset = offset;
+      *Length = n;
+      return INI_TRUE;
+    }
+  }
+  return INI_FALSE;
+}
+
+/** ini_image_gets()
+ * \param Image       the memory with an image made by ini_image_publish()
+ * \param ImageSize   the size of the memory
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find the value of
+ * \param DefValue    default string in the event of a failed read
  * \param Buffer      a pointer to the buffer to copy into
  * \param BufferSize  the maximum number of characters to copy
- * \param Filename    the name and full path of the .ini file to read from
+ *
+ * The lookup is a binary search in the image; when the image is published
+ * again during the lookup, the lookup is repeated.
  *
  * \return            the number of characters copied into the supplied buffer
  */
-SceSize ini_getsection(int idx, char *Buffer, SceSize BufferSize, const char *Filename)
+SceSize ini_image_gets(const void *Image, SceSize ImageSize, const char *Section, const char *Key,
+                       const char *DefValue, char *Buffer, SceSize BufferSize)
 {
-  INI_FILETYPE fd;
-  SceBool ok = INI_FALSE;
+  const IMAGE_HEADER *header = (const IMAGE_HEADER *)Image;
+  SceUInt32 generation, limit, offset;
+  SceSize len;
+  SceBool ok;
+#if INI_PROFILE
+  SceUInt64 start = ini_clock();
+#endif
 
-  if (Buffer == NULL || BufferSize <= 0 || idx < 0)
-    return INI_FALSE;
-  if (ini_openread(Filename, &fd)) {
-    ok = getkeystring(&fd, NULL, NULL, idx, -1, Buffer, BufferSize, NULL);
-    (void)ini_close(&fd);
+  if (Buffer == NULL || BufferSize <= 0 || Key == NULL)
+    return 0;
+  TRACE_BEGIN("ini_image_gets");
+  if (Image == NULL || ImageSize < sizeof(IMAGE_HEADER) || memcmp(header->magic, IMAGE_MAGIC, 4) != 0) {
+    ok = INI_FALSE;
+  } else {
+    for ( ;; ) {
+      generation = header->generation;
+      ini_barrier();
+      if ((generation & 1) != 0) {
+        ini_yield();  /* the image is being written */
+        continue;
+      }
+      limit = (header->size < ImageSize) ? header->size : (SceUInt32)ImageSize;
+      ok = image_lookup((const char *)Image, limit, Section, Key, &offset, &len);
+      if (ok) {
+        if (len >= BufferSize)
+          len = BufferSize - 1;
+        memcpy(Buffer, (const char *)Image + offset, len);
+        Buffer[len] = '\0';
+      }
+      ini_barrier();
+      if (header->generation == generation)
+        break;
+    }
   }
+  TRACE_END("ini_image_gets");
+#if INI_PROFILE
+  profile_record(NULL, Section, Key, start, INI_PATH_IMAGE, INI_TRUE, ok);
+#endif
   if (!ok)
-    *Buffer = '\0';
+    ini_strncpy(Buffer, (DefValue != NULL) ? DefValue : "", BufferSize, QUOTE_NONE);
   return (SceSize)strlen(Buffer);
 }
 
-/** ini_getkey()
- * \param Section     the name of the section to browse through, or NULL to
- *                    browse through the keys outside any section
- * \param idx         the zero-based sequence number of the key to return
- * \param Buffer      a pointer to the buffer to copy into
- * \param BufferSize  the maximum number of characters to copy
- * \param Filename    the name and full path of the .ini file to read from
+/** ini_image_find()
+ * \param Image       the memory with an image made by ini_image_publish()
+ * \param ImageSize   the size of the memory
+ * \param Section     the name of the section to search for
+ * \param Key         the name of the entry to find the value of
+ * \param Length      set to the length of the value (may be NULL)
+ * \param Generation  set to the generation of the image in which the value
+ *                    was found (may be NULL)
  *
- * \return            the number of characters copied into the supplied buffer
+ * Looks up a value like ini_image_gets(), without copying it: the value is
+ * returned where it is in the image (it is zero-terminated). It stays valid
+ * until the image is published again; a reader that may run at the same time
+ * as a publisher checks that ini_image_generation() still returns the
+ * generation after it used the value, and looks it up again otherwise.
+ *
+ * \return            the value in the image, or NULL if the key was not found
  */
-SceSize ini_getkey(const char *Section, int idx, char *Buffer, SceSize BufferSize, const char *Filename)
+const char *ini_image_find(const void *Image, SceSize ImageSize, const char *Section, const char *Key,
+                           SceSize *Length, SceUInt32 *Generation)
 {
-  INI_FILETYPE fd;
-  SceBool ok = INI_FALSE;
+  const IMAGE_HEADER *header = (const IMAGE_HEADER *)Image;
+  SceUInt32 generation, limit, offset;
+  SceSize len;
+  SceBool ok;
+#if INI_PROFILE
+  SceUInt64 start = ini_clock();
+#endif
 
-  if (Buffer == NULL || BufferSize <= 0 || idx < 0)
-    return INI_FALSE;
-  if (ini_openread(Filename, &fd)) {
-    ok = getkeystring(&fd, Section, NULL, -1, idx, Buffer, BufferSize, NULL);
-    (void)ini_close(&fd);
+  if (Image == NULL || Key == NULL || ImageSize < sizeof(IMAGE_HEADER) || memcmp(header->magic, IMAGE_MAGIC, 4) != 0)
+    return NULL;
+  TRACE_BEGIN("ini_image_find");
+  for ( ;; ) {
+    generation = header->generation;
+    ini_barrier();
+    if ((generation & 1) != 0) {
+      ini_yield();    /* the image is being written */
+      continue;
+    }
+    limit = (header->size < ImageSize) ? header->size : (SceUInt32)ImageSize;
+    ok = image_lookup((const char *)Image, limit, Section, Key, &offset, &len);
+    ini_barrier();
+    if (header->generation == generation)
+      break;
   }
+  TRACE_END("ini_image_find");
+#if INI_PROFILE
+  profile_record(NULL, Section, Key, start, INI_PATH_IMAGE, INI_TRUE, ok);
+#endif
   if (!ok)
-    *Buffer = '\0';
-  return (SceSize)strlen(Buffer);
+    return NULL;
+  if (Length != NULL)
+    *Length = len;
+  if (Generation != NULL)
+    *Generation = generation;
+  return (const char *)Image + offset;
 }
 
-/** ini_hassection()
- * \param Section     the name of the section to search for
- * \param Filename    the name of the .ini file to read from
+/** ini_image_generation()
+ * \param Image       the memory with an image made by ini_image_publish()
  *
- * \return            1 if the section is found, 0 if not found
+ * \return            the generation of the image, which changes each time
+ *                    that the image is published (0 if there is no image)
  */
-SceBool ini_hassection(const char *Section, const char *Filename)
+SceUInt32 ini_image_generation(const void *Image)
 {
-  char LocalBuffer[8];  /* dummy buffer */
-  INI_FILETYPE fd;
-  SceBool ok = INI_FALSE;
-
-  if (ini_openread(Filename, &fd)) {
-    ok = getkeystring(&fd, Section, NULL, -1, 0, LocalBuffer, sizeof(LocalBuffer), NULL);
-    (void)ini_close(&fd);
-  }
-  return ok;
+  const IMAGE_HEADER *header = (const IMAGE_HEADER *)Image;
+  return (memcmp(header->magic, IMAGE_MAGIC, 4) == 0) ? header->generation : 0;
 }
 
-/** ini_haskey()
- * \param Section     the name of the section to search for
- * \param Key         the name of the entry to find the value of
- * \param Filename    the name of the .ini file to read from
+#if defined(MININI_SHAREDIMAGE)
+/** ini_image_create()
+ * \param Name        the name of the shared memory object, like "/app.ini"
+ * \param ImageSize   the size of the memory for the image
  *
- * \return            1 if the key is found, 0 if not found
+ * Creates a shared memory object (or opens an existing one) and maps it for
+ * writing, for a process that publishes images in it with
+ * ini_image_publish(). An existing object that is smaller is enlarged; one
+ * that is larger keeps its size, because other processes may map all of it.
+ *
+ * \return            the memory, or NULL on failure; release it with
+ *                    ini_image_detach()
  */
-SceBool ini_haskey(const char *Section, const char *Key, const char *Filename)
+void *ini_image_create(const char *Name, SceSize ImageSize)
 {
-  char LocalBuffer[8];  /* dummy buffer */
-  INI_FILETYPE fd;
-  SceBool ok = INI_FALSE;
+  INI_SHMTYPE shm;
+  INI_SHMSTAT stat;
+  void *image = NULL;
+  SceBool ok;
 
-  if (ini_openread(Filename, &fd)) {
-    ok = getkeystring(&fd, Section, Key, -1, -1, LocalBuffer, sizeof(LocalBuffer), NULL);
-    (void)ini_close(&fd);
-  }
-  return ok;
+  assert(Name != NULL && ImageSize >= sizeof(IMAGE_HEADER));
+  if (!ini_shmcreate(Name, &shm))
+    return NULL;
+  ok = ini_shmstat(&shm, &stat)
+       && (ini_shmstatsize(&stat) >= ImageSize || ini_shmresize(&shm, ImageSize))
+       && ini_shmmap(&shm, ImageSize, INI_TRUE, &image);
+  (void)ini_shmclose(&shm);
+  return ok ? image : NULL;
 }
 
-
-#if INI_BROWSE
-/** ini_browse()
- * \param Callback    a pointer to a function that will be called for every
- *                    setting in the INI file.
- * \param UserData    arbitrary data, which the function passes on the
- *                    \c Callback function
- * \param Filename    the name and full path of the .ini file to read from
+/** ini_image_attach()
+ * \param Name        the name of the shared memory object
+ * \param ImageSize   set to the size of the memory
  *
- * \return            1 on success, 0 on failure (INI file not found)
+ * Maps a shared memory object that ini_image_create() made, read-only, for
+ * a process that looks up values with ini_image_gets() or ini_image_find().
+ * The mapping shows every image that is published in the object later on.
  *
- * \note              The \c Callback function must return 1 to continue
- *                    browsing through the INI file, or 0 to stop. Even when the
- *                    callback stops the browsing, this function will return 1
- *                    (for success).
+ * \return            the memory, or NULL on failure; release it with
+ *                    ini_image_detach()
  */
-SceBool ini_browse(INI_CALLBACK Callback, void *UserData, const char *Filename)
+const void *ini_image_attach(const char *Name, SceSize *ImageSize)
 {
-  char LocalBuffer[INI_BUFFERSIZE];
-  SceSize lenSec, lenKey;
-  enum quote_option quotes;
-  INI_FILETYPE fd;
-
-  if (Callback == NULL)
-    return INI_FALSE;
-  if (!ini_openread(Filename, &fd))
-    return INI_FALSE;
+  INI_SHMTYPE shm;
+  INI_SHMSTAT stat;
+  void *image = NULL;
+  SceBool ok;
 
-  LocalBuffer[0] = '\0';   /* copy an empty section in the buffer */
-  lenSec = (SceSize)strlen(LocalBuffer) + 1;
-  for ( ;; ) {
-    char *sp, *ep;
-    if (!ini_read(LocalBuffer + lenSec, INI_BUFFERSIZE - lenSec, &fd))
-      break;
-    sp = skipleading(LocalBuffer + lenSec);
-    /* ignore empty strings and comments */
-    if (*sp == '\0' || *sp == ';' || *sp == '#')
-      continue;
-    /* see whether we reached a new section */
-    ep = strrchr(sp, ']');
-    if (*sp == '[' && ep != NULL) {
-      sp = skipleading(sp + 1);
-      ep = skiptrailing(ep, sp);
-      *ep = '\0';
-      ini_strncpy(LocalBuffer, sp, INI_BUFFERSIZE, QUOTE_NONE);
-      lenSec = (SceSize)strlen(LocalBuffer) + 1;
-      continue;
-    }
-    /* not a new section, test for a key/value pair */
-    ep = strchr(sp, '=');    /* test for the equal sign or colon */
-    if (ep == NULL)
-      ep = strchr(sp, ':');
-    if (ep == NULL)
-      continue;               /* invalid line, ignore */
-    *ep++ = '\0';             /* split the key from the value */
-    striptrailing(sp);
-    ini_strncpy(LocalBuffer + lenSec, sp, INI_BUFFERSIZE - lenSec, QUOTE_NONE);
-    lenKey = (SceSize)strlen(LocalBuffer + lenSec) + 1;
-    /* clean up the value */
-    sp = skipleading(ep);
-    sp = cleanstring(sp, &quotes);  /* Remove a trailing comment */
-    ini_strncpy(LocalBuffer + lenSec + lenKey, sp, INI_BUFFERSIZE - lenSec - lenKey, quotes);
-    /* call the callback */
-    if (!Callback(LocalBuffer, LocalBuffer + lenSec, LocalBuffer + lenSec + lenKey, UserData))
-      break;
+  assert(Name != NULL && ImageSize != NULL);
+  if (!ini_shmopen(Name, &shm))
+    return NULL;
+  ok = ini_shmstat(&shm, &stat) && ini_shmstatsize(&stat) >= sizeof(IMAGE_HEADER);
+  if (ok) {
+    *ImageSize = ini_shmstatsize(&stat);
+    ok = ini_shmmap(&shm, *ImageSize, INI_FALSE, &image);
   }
+  (void)ini_shmclose(&shm);
+  return ok ? image : NULL;
+}
 
-  (void)ini_close(&fd);
-  return INI_TRUE;
+/** ini_image_detach()
+ * \param Image       the memory from ini_image_create() or ini_image_attach()
+ * \param ImageSize   the size of the memory
+ */
+void ini_image_detach(const void *Image, SceSize ImageSize)
+{
+  if (Image != NULL)
+    (void)ini_shmunmap(Image, ImageSize);
 }
-#endif /* INI_BROWSE */
+
+/** ini_image_remove()
+ * \param Name        the name of the shared memory object
+ *
+ * Removes the name of the object; processes that mapped it keep the memory
+ * until they detach it.
+ *
+ * \return            1 if successful, otherwise 0
+ */
+SceBool ini_image_remove(const char *Name)
+{
+  assert(Name != NULL);
+  return ini_shmremove(Name);
+}
+#endif /* MININI_SHAREDIMAGE */
+#endif /* INI_IMAGE */
 
 #if !INI_READONLY
 static void ini_tempname(char *dest, const char *source, SceSize maxlength)
@@ -572,12 +4454,24 @@ static enum quote_option check_enquote(const char *Value)
   const char *p;
 
   /* run through the value, if it has trailing spaces, or '"', ';' or '#'
-   * characters, enquote it
+   * characters, enquote it; a dialect without quotes writes it as is
    */
   assert(Value != NULL);
-  for (p = Value; *p != '\0' && *p != '"' && *p != ';' && *p != '#'; p++)
+#if INI_QUOTES
+  for (p = Value; *p != '\0' && *p != '"' && !is_comment(*p); p++)
     /* nothing */;
+#if INI_CONTINUATION
+  /* a folded value can have new lines at its start or its end, which the
+   * reader would trim (with any other white space) from an unquoted value */
+  return (*p != '\0' || (p > Value && ((unsigned char)*Value <= ' ' || (unsigned char)*(p - 1) <= ' '))) ? QUOTE_ENQUOTE : QUOTE_NONE;
+#else
   return (*p != '\0' || (p > Value && *(p - 1) == ' ')) ? QUOTE_ENQUOTE : QUOTE_NONE;
+#endif
+#else
+  (void)p;
+  (void)Value;
+  return QUOTE_NONE;
+#endif
 }
 
 static void writesection(char *LocalBuffer, const char *Section, INI_FILETYPE *fd)
@@ -595,16 +4489,90 @@ static void writesection(char *LocalBuffer, const char *Section, INI_FILETYPE *f
   }
 }
 
+#if INI_CONTINUATION
+/* Fold a key line (the value starts at "start") in place: the value goes on
+ * over lines that end with a backslash after INI_FOLDWIDTH characters, and
+ * every new line in the value starts an indented line. An indented line
+ * that would not be read back as it is (a blank line, or one that starts
+ * with white space, a comment or a '[') is only a backslash, which joins
+ * the text on the next line as is. A backslash in front of a new line is
+ * followed by a join with an empty line, so that it does not join the
+ * indented line. Returns false if the folded line (with a line terminator)
+ * does not fit in the buffer.
+ */
+static SceBool foldline(char *line, SceSize start)
+{
+  char Folded[INI_BUFFERSIZE];
+  SceSize termlen = (SceSize)strlen(INI_LINETERM);
+  SceSize i, d = start, col = start;
+  SceBool backslash, verbatim;
+  char c;
+
+  memcpy(Folded, line, start);
+  for (i = start; line[i] != '\0'; i++) {
+    if (line[i] == '\n') {
+      c = line[i + 1];
+      backslash = (d > start && Folded[d - 1] == '\\');
+      verbatim = (c == '\0' || c == '\n' || c == '\r' || c == ' ' || c == '\t' || c == '[' || is_comment(c));
+      if (d + (backslash ? termlen + 1 : 0) + termlen + 1 + (verbatim ? termlen + 1 : 0) >= INI_BUFFERSIZE)
+        return INI_FALSE;
+      if (backslash) {
+        Folded[d++] = '\\';
+        memcpy(Folded + d, INI_LINETERM, termlen);
+        d += termlen;
+      }
+      memcpy(Folded + d, INI_LINETERM, termlen);
+      d += termlen;
+      Folded[d++] = ' ';
+      col = 1;
+      if (verbatim) {
+        Folded[d++] = '\\';
+        memcpy(Folded + d, INI_LINETERM, termlen);
+        d += termlen;
+        col = 0;
+      }
+      continue;
+    }
+    if (col >= INI_FOLDWIDTH) {
+      if (d + 1 + termlen >= INI_BUFFERSIZE)
+        return INI_FALSE;
+      Folded[d++] = '\\';
+      memcpy(Folded + d, INI_LINETERM, termlen);
+      d += termlen;
+      col = 0;
+    }
+    if (d + 1 >= INI_BUFFERSIZE)
+      return INI_FALSE;
+    Folded[d++] = line[i];
+    col++;
+  }
+  if (d > start && Folded[d - 1] == '\\' && d + 1 < INI_BUFFERSIZE)
+    Folded[d++] = ' ';  /* a value that ends with a backslash must not continue the line */
+  if (d + termlen + 1 > INI_BUFFERSIZE)
+    return INI_FALSE;
+  memcpy(line, Folded, d);
+  line[d] = '\0';
+  return INI_TRUE;
+}
+#endif
+
 static void writekey(char *LocalBuffer, const char *Key, const char *Value, INI_FILETYPE *fd)
 {
   char *p;
   enum quote_option option = check_enquote(Value);
+  SceSize maxlen;
   ini_strncpy(LocalBuffer, Key, INI_BUFFERSIZE - 4, QUOTE_NONE);  /* -2 for formatting, -1 for '=', -1 for '\n' */
   p = strchr(LocalBuffer, '\0');
   assert(p != NULL);
   /* Put spaces before and after the equal sign (for formatting) */
   *p++ = ' '; *p++ = '='; *p++ = ' ';
-  ini_strncpy(p, Value, INI_BUFFERSIZE - (p - LocalBuffer) - 1, option); /* -1 for '\n' */
+  maxlen = INI_BUFFERSIZE - (SceSize)(p - LocalBuffer) - 1;   /* -1 for '\n' */
+  ini_strncpy(p, Value, maxlen, option);
+#if INI_CONTINUATION
+  /* a value that is too long to be folded in the buffer is cut shorter */
+  while (!foldline(LocalBuffer, (SceSize)(p - LocalBuffer)) && maxlen > 1)
+    ini_strncpy(p, Value, --maxlen, option);
+#endif
   p = strchr(LocalBuffer, '\0');
   assert(p != NULL);
   strcpy(p, INI_LINETERM); /* copy line terminator (typically "\n") */
@@ -612,54 +4580,429 @@ static void writekey(char *LocalBuffer, const char *Key, const char *Value, INI_
     (void)ini_write(LocalBuffer, strlen(LocalBuffer), fd);
 }
 
-static SceBool cache_accum(const char *string, SceSize *size, SceUInt max)
-{
-  SceSize len = (SceSize)strlen(string);
-  if (*size + len >= max)
+/* Copy the part of the source file from "mark" up to "end" to the output, in
+ * blocks (so that the copy does not depend on the line structure or on zero
+ * bytes in the file); the mark is moved to the end, and the read position is
+ * restored. Returns whether the source data before "end" ends with a line
+ * termination.
+ */
+static SceBool cache_flush(char *buffer, INI_FILETYPE *rfd, INI_FILETYPE *wfd,
+                           INI_FILEPOS *mark, INI_FILEPOS end)
+{
+  SceSize terminator_len = (SceSize)strlen(INI_LINETERM);
+  SceBool terminated = INI_FALSE;
+  INI_FILEPOS pos;
+  int n;
+
+  assert(buffer != NULL);
+  assert(*mark <= end);
+  (void)ini_tell(rfd, &pos);
+  (void)ini_seek(rfd, mark);
+  while (*mark < end) {
+    n = ini_readblock(buffer, (end - *mark < INI_BUFFERSIZE) ? (SceSize)(end - *mark) : INI_BUFFERSIZE, rfd);
+    if (n <= 0)
+      break;
+    (void)ini_write(buffer, (SceSize)n, wfd);
+    *mark += n;
+  }
+  *mark = end;
+  if (end >= (INI_FILEPOS)terminator_len) {
+    INI_FILEPOS tail = end - terminator_len;
+    terminated = ini_seek(rfd, &tail) && ini_readblock(buffer, terminator_len, rfd) == (int)terminator_len
+                 && memcmp(buffer, INI_LINETERM, terminator_len) == 0;
+  }
+  (void)ini_seek(rfd, &pos);
+  return terminated;
+}
+
+/* Get the end of the data in the source file, which is before the slot
+ * trailer with INI_PINGPONG */
+static SceBool ini_sourceend(INI_FILETYPE *fd, INI_FILEPOS *end)
+{
+  if (!ini_seekend(fd, end))
+    return INI_FALSE;
+#if INI_PINGPONG
+  *end -= SLOT_SIZE;
+#endif
+  return INI_TRUE;
+}
+
+static SceBool close_rename(INI_FILETYPE *rfd, INI_FILETYPE *wfd, const char *filename, char *buffer)
+{
+  (void)ini_close(rfd);
+  (void)ini_close(wfd);
+  (void)ini_tempname(buffer, filename, INI_BUFFERSIZE);
+  (void)ini_remove(filename);
+  (void)ini_rename(buffer, filename);
+  return INI_TRUE;
+}
+
+/* Complete the splice for copy_update(): the output matches the input up to
+ * splice->offset, the input resumes at "mark", and the output is at the end
+ * of the inserted text.
+ */
+static void splice_end(INI_SPLICE *splice, INI_FILEPOS mark, INI_FILETYPE *wfd)
+{
+  INI_FILEPOS pos;
+
+  splice->removed = mark - splice->offset;
+  splice->inserted = ini_tell(wfd, &pos) ? pos - splice->offset : 0;
+}
+
+/* Find occurrence "nth" (from 0) of a key in a section; the scans after the
+ * first match go on in the same section, as in getkeyvalues(). The mark and
+ * the end are those of the last scan, so when there are fewer occurrences,
+ * they are where the key would be added.
+ */
+static SceBool getnthkey(INI_FILETYPE *fd, const char *Section, const char *Key, int nth,
+                         char *Buffer, SceSize BufferSize, INI_FILEPOS *mark, enum scan_end *end)
+{
+  int count = 0;
+  SceBool match;
+
+  while ((match = getkeystring(fd, (count == 0) ? Section : NULL, Key, -1, -1, Buffer, BufferSize, mark, end))
+         && count < nth)
+    count++;
+  return match;
+}
+
+/* Copy the INI file from rfd to wfd, while updating (or removing) the key or
+ * the section on the way. Occurrence "nth" (from 0) of the key is the one
+ * that changes; with fewer occurrences, the key is added at the end of the
+ * section. Both files are left open. The part of the file that changed is
+ * returned in splice.
+ * The lines that are kept are not copied one by one: the part of the source
+ * from "mark" up to the line that changes is copied in one go by cache_flush(),
+ * so every byte of the file is read at most twice.
+ */
+static void copy_update(INI_FILETYPE *rfd, INI_FILETYPE *wfd, const char *Section, const char *Key,
+                        int nth, const char *Value, char *LocalBuffer, INI_SPLICE *splice)
+{
+  INI_FILEPOS mark, line, pos;
+  char *sp, *ep;
+  SceSize len;
+  SceBool match, flag;
+
+  (void)ini_tell(rfd, &mark);
+
+  /* Move through the file one line at a time until a section is
+   * matched or until EOF.
+   */
+  len = (Section != NULL) ? (SceSize)strlen(Section) : 0;
+  if (len > 0) {
+    do {
+      (void)ini_tell(rfd, &line);
+      if (!ini_readsrcline(LocalBuffer, INI_BUFFERSIZE, rfd)) {
+        /* Failed to find section, so add one to the end */
+        flag = cache_flush(LocalBuffer, rfd, wfd, &mark, line);
+        (void)ini_tell(wfd, &splice->offset);
+        if (Key!=NULL && Value!=NULL) {
+          if (!flag)
+            (void)ini_write(INI_LINETERM, 1, wfd);  /* force a new line behind the last line of the INI file */
+          writesection(LocalBuffer, Section, wfd);
+          writekey(LocalBuffer, Key, Value, wfd);
+        }
+        splice_end(splice, mark, wfd);
+        return;
+      }
+      /* Check whether this line is a section */
+      sp = skipleading(LocalBuffer);
+      ep = strrchr(sp, ']');
+      match = (*sp == '[' && ep != NULL);
+      if (match) {
+        /* A section was found, skip leading and trailing whitespace */
+        assert(sp != NULL && *sp == '[');
+        sp = skipleading(sp + 1);
+        assert(ep != NULL && *ep == ']');
+        ep = skiptrailing(ep, sp);
+        match = ((SceUInt)(ep-sp) == len && namememcmp(sp, Section, len, INI_CASESENSITIVE) == 0);
+      }
+    } while (!match);
+    /* Copy everything up to the section head; the section head itself is
+     * copied too, unless the section must be removed
+     */
+    (void)ini_tell(rfd, &pos);
+    cache_flush(LocalBuffer, rfd, wfd, &mark, (Key != NULL) ? pos : line);
+    mark = pos;
+  }
+
+  /* Now that the section has been found, find the entry. Stop searching
+   * upon leaving the section's area. Create an entry if one is not found.
+   */
+  len = (Key != NULL) ? (SceSize)strlen(Key) : 0;
+  for( ;; ) {
+    (void)ini_tell(rfd, &line);
+    if (!ini_readsrcline(LocalBuffer, INI_BUFFERSIZE, rfd)) {
+      /* EOF without an entry so make one */
+      flag = cache_flush(LocalBuffer, rfd, wfd, &mark, line);
+      (void)ini_tell(wfd, &splice->offset);
+      if (Key!=NULL && Value!=NULL) {
+        if (!flag)
+          (void)ini_write(INI_LINETERM, 1, wfd);  /* force a new line behind the last line of the INI file */
+        writekey(LocalBuffer, Key, Value, wfd);
+      }
+      splice_end(splice, mark, wfd);
+      return;
+    }
+    sp = skipleading(LocalBuffer);
+    ep = finddelimiter(sp); /* Parse out the equal sign */
+    match = (ep != NULL && len > 0 && (SceUInt)(skiptrailing(ep,sp)-sp) == len && namememcmp(sp, Key, len, INI_CASESENSITIVE) == 0);
+    if ((Key != NULL && match && nth-- == 0) || *sp == '[')
+      break;  /* found the key, or found a new section */
+    if (Key == NULL)
+      (void)ini_tell(rfd, &mark);  /* we are deleting the entire section, so skip the line */
+  }
+  /* the key was found, or we just dropped on the next section (meaning that it
+   * wasn't found); in both cases we need to write the key, but in the latter
+   * case, the line starting the new section must be kept
+   */
+  flag = (*sp == '[');
+  cache_flush(LocalBuffer, rfd, wfd, &mark, line);
+  (void)ini_tell(wfd, &splice->offset);
+  if (Key != NULL && Value != NULL)
+    writekey(LocalBuffer, Key, Value, wfd);
+  if (!flag)
+    (void)ini_tell(rfd, &mark);   /* forget the old key line */
+  splice_end(splice, mark, wfd);
+  /* Copy the rest of the INI file */
+  if (ini_sourceend(rfd, &pos))
+    cache_flush(LocalBuffer, rfd, wfd, &mark, pos);
+}
+
+#if INI_SIDECAR
+/* Find the offset of the header of an existing section, through the records
+ * of its keys */
+static SceBool sidecar_findheader(INI_FILETYPE *xfd, const SIDECAR_HEADER *header, const char *Filename,
+                                  const char *Section, SceUInt32 section, INI_FILEPOS *offset)
+{
+  SIDECAR_RECORD rec;
+  INI_FILETYPE fd;
+  INI_FILEPOS tried = SIDECAR_NOHEADER;
+  SceSize len = (SceSize)strlen(Section);
+  SceUInt32 idx;
+  SceBool found = INI_FALSE;
+
+  if (!sidecar_search(xfd, header, section, 0, &idx) || !ini_openread(Filename, &fd))
+    return INI_FALSE;
+  for ( ; !found && idx < header->count + header->overflow; idx++) {
+    if (!sidecar_record(xfd, idx, &rec))
+      break;
+    if (rec.section == section && rec.header != tried && rec.header >= 0) {
+      tried = rec.header;
+      found = sidecar_readsection(&fd, rec.header, Section, len);
+    } else if (rec.section != section && idx < header->count) {
+      idx = header->count - 1;  /* no more matches in the sorted part, skip to the overflow */
+    }
+  }
+  (void)ini_close(&fd);
+  if (found)
+    *offset = tried;
+  return found;
+}
+
+/* Bring the sidecar up to date after ini_puts() changed the INI file at
+ * offset pos: the len bytes of data either replaced the bytes in old, or they
+ * were appended (old is NULL); an appended key gets an overflow record. The
+ * sidecar is left alone (so it is rebuilt on the next lookup) if it did not
+ * match the file before the change, or if the header of the section of an
+ * appended key cannot be found.
+ */
+static void sidecar_update(const char *Filename, INI_FILESTAT *before, INI_FILEPOS pos,
+                           const char *old, const char *data, SceSize len, const char *Section,
+                           const SIDECAR_RECORD *rec)
+{
+  char name[INI_BUFFERSIZE];
+  SIDECAR_HEADER header;
+  SIDECAR_RECORD appended;
+  INI_FILESTAT after;
+  INI_FILETYPE xfd;
+  INI_FILEPOS offset;
+  SceBool ok;
+
+  sidecar_name(name, Filename, sizeof(name));
+  if (!ini_openrewrite(name, &xfd))
+    return;
+  ok = ini_readblock(&header, sizeof(header), &xfd) == (int)sizeof(header)
+       && memcmp(header.magic, SIDECAR_MAGIC, 4) == 0 && header.version == SIDECAR_VERSION
+       && header.size == ini_statsize(before)
+       && memcmp(&header.mtime, &ini_statmtime(before), sizeof(INI_FILETIME)) == 0
+       && (old != NULL || header.overflow < INI_SIDECAROVERFLOW)
+       && ini_stat(Filename, &after)
+       && ini_statsize(&after) == header.size + ((old != NULL) ? 0 : (INI_FILEPOS)len);
+  if (ok && old != NULL) {
+    /* replacing byte i changes the Adler-32 sums by the difference of the
+     * bytes, and by that difference times the distance to the end of file */
+    SceUInt32 a = header.hash & 0xffff, b = header.hash >> 16;
+    SceSize i;
+    for (i = 0; i < len; i++) {
+      SceUInt32 d = (65521u + (unsigned char)data[i] - (unsigned char)old[i]) % 65521u;
+      SceUInt32 w = (SceUInt32)((header.size - (pos + (INI_FILEPOS)i)) % 65521);
+      a = (a + d) % 65521u;
+      b = (b + w * d % 65521u) % 65521u;
+    }
+    header.hash = (b << 16) | a;
+  } else if (ok) {
+    appended = *rec;
+    if (appended.header == SIDECAR_UNKNOWN)
+      ok = sidecar_findheader(&xfd, &header, Filename, Section, appended.section, &appended.header);
+    header.hash = adler32(header.hash, (const unsigned char *)data, len);
+    offset = (INI_FILEPOS)(sizeof(SIDECAR_HEADER) + (INI_FILEPOS)(header.count + header.overflow) * sizeof(SIDECAR_RECORD));
+    ok = ok && ini_seek(&xfd, &offset) && ini_write((const char *)&appended, sizeof(SIDECAR_RECORD), &xfd);
+    header.overflow++;
+  }
+  if (ok) {
+    header.size = ini_statsize(&after);
+    header.mtime = ini_statmtime(&after);
+    offset = 0;
+    if (ini_seek(&xfd, &offset))
+      (void)ini_write((const char *)&header, sizeof(header), &xfd);
+  }
+  (void)ini_close(&xfd);
+}
+#endif /* INI_SIDECAR */
+
+#if INI_FASTAPPEND
+/* Append a key (preceded by a section header if newsection is true) to the
+ * end of the file, without copying the file. The read handle must be open;
+ * it is used to check whether the last line has a line terminator.
+ */
+static SceBool append_key(INI_FILETYPE *rfd, INI_FILEPOS eof, const char *Section, SceBool newsection,
+                          const char *Key, const char *Value, const char *Filename, INI_SPLICE *splice)
+{
+  char Block[2 * INI_BUFFERSIZE + 1];
+  INI_FILETYPE wfd;
+  SceSize len = 0;
+  SceBool ok;
+#if INI_SIDECAR
+  INI_FILESTAT before;
+  SIDECAR_RECORD rec;
+  SceBool known;
+#endif
+
+  splice->offset = eof;
+  if (eof > 0) {
+    eof--;
+    (void)ini_seek(rfd, &eof);
+    if (!ini_read(Block, 2, rfd) || Block[0] != INI_LINETERMCHAR) {
+      strcpy(Block, INI_LINETERM); /* force a new line behind the last line of the INI file */
+      len = (SceSize)strlen(Block);
+    }
+  }
+  (void)ini_close(rfd);
+
+  /* build all lines in one block, so that they are appended in a single write */
+  Block[len] = '\0';
+#if INI_SIDECAR
+  if (Section == NULL || *Section == '\0')
+    rec.header = SIDECAR_NOHEADER;
+  else
+    rec.header = newsection ? splice->offset + len : SIDECAR_UNKNOWN;
+#endif
+  if (newsection) {
+    writesection(Block + len, Section, NULL);
+    len += (SceSize)strlen(Block + len);
+  }
+#if INI_SIDECAR
+  rec.section = ini_hash((Section != NULL) ? Section : "", (Section != NULL) ? (SceSize)strlen(Section) : 0);
+  rec.key = ini_hash(Key, (SceSize)strlen(Key));
+  rec.offset = splice->offset + len;
+  known = ini_stat(Filename, &before);
+#endif
+  writekey(Block + len, Key, Value, NULL);
+  len += (SceSize)strlen(Block + len);
+  if (!ini_openappend(Filename, &wfd))
     return INI_FALSE;
-  *size += len;
-  return INI_TRUE;
-}
+  ok = ini_write(Block, len, &wfd);
+  (void)ini_close(&wfd);
+  if (ok)
+    splice->inserted = len;
+#if INI_SIDECAR
+  if (ok && known)
+    sidecar_update(Filename, &before, splice->offset, NULL, Block, len, Section, &rec);
+#endif
 
-static SceBool cache_flush(char *buffer, SceSize *size,
-                      INI_FILETYPE *rfd, INI_FILETYPE *wfd, INI_FILEPOS *mark)
-{
-  SceSize terminator_len = (SceSize)strlen(INI_LINETERM);
-  SceUInt pos = 0, pos_prev = -1;
+#if INI_SYNCAPPEND
+  /* flush the device the file is on (e.g. "ms0:") */
+  if (ok) {
+    const char *p = strchr(Filename, ':');
+    if (p != NULL && (SceSize)(p - Filename) + 2 <= sizeof(Block)) {
+      ini_strncpy(Block, Filename, (SceSize)(p - Filename) + 2, QUOTE_NONE);
+      ok = ini_sync(Block);
+    }
+  }
+#endif
 
-  (void)ini_seek(rfd, mark);
-  assert(buffer != NULL);
-  buffer[0] = '\0';
-  assert(size != NULL);
-  assert(*size <= INI_BUFFERSIZE);
-  while (pos < *size && pos != pos_prev) {
-    pos_prev = pos;     /* to guard against zero bytes in the INI file */
-    (void)ini_read(buffer + pos, INI_BUFFERSIZE - pos, rfd);
-    while (pos < *size && buffer[pos] != '\0')
-      pos++;            /* cannot use strlen() because buffer may not be zero-terminated */
-  }
-  if (buffer[0] != '\0') {
-    assert(pos > 0 && pos <= INI_BUFFERSIZE);
-    if (pos == INI_BUFFERSIZE)
-      pos--;
-    buffer[pos] = '\0'; /* force zero-termination (may be left unterminated in the above while loop) */
-    (void)ini_write(buffer, *size, wfd);
-  }
-  (void)ini_tell(rfd, mark);  /* update mark */
-  *size = 0;
-  /* return whether the buffer ended with a line termination */
-  return (pos > terminator_len) && (strcmp(buffer + pos - terminator_len, INI_LINETERM) == 0);
+  return ok;
 }
+#endif /* INI_FASTAPPEND */
 
-static SceBool close_rename(INI_FILETYPE *rfd, INI_FILETYPE *wfd, const char *filename, char *buffer)
+#if INI_PINGPONG
+/* Write the new contents of the INI file to the slot that is not current, and
+ * commit it by appending the trailer. There are no directory operations, and
+ * the write is purely sequential.
+ */
+static SceBool slot_puts(const char *Section, const char *Key, int nth, const char *Value, const char *Filename,
+                         INI_SPLICE *splice)
 {
-  (void)ini_close(rfd);
-  (void)ini_close(wfd);
-  (void)ini_tempname(buffer, filename, INI_BUFFERSIZE);
-  (void)ini_remove(filename);
-  (void)ini_rename(buffer, filename);
-  return INI_TRUE;
+  INI_FILETYPE rfd, wfd;
+  INI_FILEPOS len;
+  SceUInt32 seq = 0, sum;
+  SceBool ok;
+  char slot, last, target;
+  char LocalBuffer[INI_BUFFERSIZE];
+
+  slot = slot_openread(Filename, &rfd, &seq);
+  if (slot != '\0' && Key != NULL) {
+    /* nothing to do if the setting is unchanged, or if the key to erase is absent */
+    SceBool match = getnthkey(&rfd, Section, Key, nth, LocalBuffer, sizeof(LocalBuffer), NULL, NULL);
+    if ((Value != NULL && match && strcmp(LocalBuffer, Value) == 0) || (Value == NULL && !match)) {
+      (void)ini_close(&rfd);
+      return INI_TRUE;
+    }
+    len = 0;
+    (void)ini_seek(&rfd, &len);
+  }
+  if (slot == '\0' && (Key == NULL || Value == NULL))
+    return INI_TRUE;  /* nothing to erase */
+
+  target = (slot == 'a') ? 'b' : 'a';
+  slot_name(LocalBuffer, Filename, target, INI_BUFFERSIZE);
+  if (!ini_openwrite(LocalBuffer, &wfd)) {
+    if (slot != '\0')
+      (void)ini_close(&rfd);
+    return INI_FALSE;
+  }
+  if (slot != '\0') {
+    copy_update(&rfd, &wfd, Section, Key, nth, Value, LocalBuffer, splice);
+    (void)ini_close(&rfd);
+  } else {
+    writesection(LocalBuffer, Section, &wfd);
+    writekey(LocalBuffer, Key, Value, &wfd);
+  }
+  ok = ini_tell(&wfd, &len);
+  if (slot == '\0')
+    splice->inserted = len;
+  (void)ini_close(&wfd);
+
+  /* read the data back for the checksum, then append the trailer */
+  slot_name(LocalBuffer, Filename, target, INI_BUFFERSIZE);
+  if (!ok || !ini_openread(LocalBuffer, &rfd))
+    return INI_FALSE;
+  ok = slot_sum(&rfd, len, &sum, &last);
+  (void)ini_close(&rfd);
+  if (!ok || !ini_openappend(LocalBuffer, &wfd))
+    return INI_FALSE;
+  if (last != INI_LINETERMCHAR) {
+    /* the trailer must start on a line of its own */
+    ok = ini_write(INI_LINETERM, strlen(INI_LINETERM), &wfd);
+    sum = adler32(sum, (const unsigned char *)INI_LINETERM, (SceSize)strlen(INI_LINETERM));
+  }
+  snprintf(LocalBuffer, INI_BUFFERSIZE, SLOT_TAG "%08x %08x" INI_LINETERM, (unsigned)(seq + 1), (unsigned)sum);
+  ok = ini_write(LocalBuffer, SLOT_SIZE, &wfd) && ok;
+  (void)ini_close(&wfd);
+  return ok;
 }
+#endif /* INI_PINGPONG */
 
 /** ini_puts()
  * \param Section     the name of the section to write the string in
@@ -671,16 +5014,33 @@ static SceBool close_rename(INI_FILETYPE *rfd, INI_FILETYPE *wfd, const char *fi
  */
 SceBool ini_puts(const char *Section, const char *Key, const char *Value, const char *Filename)
 {
+  return ini_puts_splice(Section, Key, Value, Filename, NULL);
+}
+
+/* The implementation of ini_puts_splice() */
+static SceBool puts_splice(const char *Section, const char *Key, int nth, const char *Value, const char *Filename,
+                           INI_SPLICE *Splice)
+{
+  INI_SPLICE splice;
   INI_FILETYPE rfd;
   INI_FILETYPE wfd;
-  INI_FILEPOS mark;
   INI_FILEPOS head, tail;
-  char *sp, *ep;
   char LocalBuffer[INI_BUFFERSIZE];
-  SceSize len, cachelen;
-  SceBool match, flag;
+  SceBool match;
+  enum scan_end scan;
+#if INI_SIDECAR
+  char OldBuffer[INI_BUFFERSIZE];
+  INI_FILESTAT before;
+  SceBool known;
+#endif
 
   assert(Filename != NULL);
+  if (Splice == NULL)
+    Splice = &splice;
+  Splice->offset = Splice->removed = Splice->inserted = 0;
+#if INI_PINGPONG
+  return slot_puts(Section, Key, nth, Value, Filename, Splice);
+#endif
   if (!ini_openread(Filename, &rfd)) {
     /* If the .ini file doesn't exist, make a new file */
     if (Key != NULL && Value != NULL) {
@@ -688,6 +5048,7 @@ SceBool ini_puts(const char *Section, const char *Key, const char *Value, const
         return INI_FALSE;
       writesection(LocalBuffer, Section, &wfd);
       writekey(LocalBuffer, Key, Value, &wfd);
+      (void)ini_tell(&wfd, &Splice->inserted);
       (void)ini_close(&wfd);
     }
     return INI_TRUE;
@@ -698,7 +5059,7 @@ SceBool ini_puts(const char *Section, const char *Key, const char *Value, const
    * the INI file.
    */
   if (Key != NULL && Value != NULL) {
-    match = getkeystring(&rfd, Section, Key, -1, -1, LocalBuffer, sizeof(LocalBuffer), &head);
+    match = getnthkey(&rfd, Section, Key, nth, LocalBuffer, sizeof(LocalBuffer), &head, &scan);
     if (match) {
       /* if the current setting is identical to the one to write, there is
        * nothing to do.
@@ -716,6 +5077,11 @@ SceBool ini_puts(const char *Section, const char *Key, const char *Value, const
       writekey(LocalBuffer, Key, Value, NULL);
       
       if (strlen(LocalBuffer) == (SceSize)(tail - head)) {
+#if INI_SIDECAR
+        /* keep the old line, for updating the checksum in the sidecar */
+        known = ini_stat(Filename, &before) && ini_seek(&rfd, &head)
+                && ini_readblock(OldBuffer, (SceSize)(tail - head), &rfd) == (int)(tail - head);
+#endif
         /* length matches, close the file & re-open for read/write, then
          * write at the correct position
          */
@@ -723,16 +5089,34 @@ SceBool ini_puts(const char *Section, const char *Key, const char *Value, const
         if (!ini_openrewrite(Filename, &wfd))
           return INI_FALSE;
         (void)ini_seek(&wfd, &head);
+#if INI_SIDECAR
+        known = ini_write(LocalBuffer, strlen(LocalBuffer), &wfd) && known;
+        (void)ini_close(&wfd);
+        if (known)
+          sidecar_update(Filename, &before, head, OldBuffer, LocalBuffer, (SceSize)(tail - head), NULL, NULL);
+#else
         (void)ini_write(LocalBuffer, strlen(LocalBuffer), &wfd);
         (void)ini_close(&wfd);
+#endif
+        Splice->offset = head;
+        Splice->removed = Splice->inserted = tail - head;
         return INI_TRUE;
       }
     }
+#if INI_FASTAPPEND
+    /* if the key was not found and the scan ran into EOF, the section is the
+     * last one in the file (or it is missing); the new key can be appended
+     * without copying the file.
+     */
+    else if (scan == SCAN_EOF || scan == SCAN_NOSECTION) {
+      return append_key(&rfd, head, Section, scan == SCAN_NOSECTION, Key, Value, Filename, Splice);
+    }
+#endif
     /* key not found, or different value & length -> proceed */
   } else if (Key != NULL && Value == NULL) {
     /* Conversely, for a request to delete a setting; if that setting isn't
        present, just return */
-    match = getkeystring(&rfd, Section, Key, -1, -1, LocalBuffer, sizeof(LocalBuffer), NULL);
+    match = getnthkey(&rfd, Section, Key, nth, LocalBuffer, sizeof(LocalBuffer), NULL, NULL);
     if (!match) {
       (void)ini_close(&rfd);
       return INI_TRUE;
@@ -755,130 +5139,72 @@ SceBool ini_puts(const char *Section, const char *Key, const char *Value, const
     assert(Key != NULL && Value != NULL);
     writesection(LocalBuffer, Section, &wfd);
     writekey(LocalBuffer, Key, Value, &wfd);
+    (void)ini_tell(&wfd, &Splice->inserted);
     (void)ini_close(&wfd);
     return INI_TRUE;
   }
 
-  (void)ini_tell(&rfd, &mark);
-  cachelen = 0;
+  copy_update(&rfd, &wfd, Section, Key, nth, Value, LocalBuffer, Splice);
+  return close_rename(&rfd, &wfd, Filename, LocalBuffer);  /* clean up and rename */
+}
 
-  /* Move through the file one line at a time until a section is
-   * matched or until EOF. Copy to temp file as it is read.
-   */
-  len = (Section != NULL) ? (SceSize)strlen(Section) : 0;
-  if (len > 0) {
-    do {
-      if (!ini_read(LocalBuffer, INI_BUFFERSIZE, &rfd)) {
-        /* Failed to find section, so add one to the end */
-        flag = cache_flush(LocalBuffer, &cachelen, &rfd, &wfd, &mark);
-        if (Key!=NULL && Value!=NULL) {
-          if (!flag)
-            (void)ini_write(INI_LINETERM, 1, &wfd);  /* force a new line behind the last line of the INI file */
-          writesection(LocalBuffer, Section, &wfd);
-          writekey(LocalBuffer, Key, Value, &wfd);
-        }
-        return close_rename(&rfd, &wfd, Filename, LocalBuffer);  /* clean up and rename */
-      }
-      /* Check whether this line is a section */
-      sp = skipleading(LocalBuffer);
-      ep = strrchr(sp, ']');
-      match = (*sp == '[' && ep != NULL);
-      if (match) {
-        /* A section was found, skip leading and trailing whitespace */
-        assert(sp != NULL && *sp == '[');
-        sp = skipleading(sp + 1);
-        assert(ep != NULL && *ep == ']');
-        ep = skiptrailing(ep, sp);
-        match = ((SceUInt)(ep-sp) == len && strnicmp(sp, Section, len) == 0);
-      }
-      /* Copy the line from source to dest, but not if this is the section that
-       * we are looking for and this section must be removed
-       */
-      if (!match || Key != NULL) {
-        if (!cache_accum(LocalBuffer, &cachelen, INI_BUFFERSIZE)) {
-          cache_flush(LocalBuffer, &cachelen, &rfd, &wfd, &mark);
-          (void)ini_read(LocalBuffer, INI_BUFFERSIZE, &rfd);
-          cache_accum(LocalBuffer, &cachelen, INI_BUFFERSIZE);
-        }
-      }
-    } while (!match);
-  }
-  cache_flush(LocalBuffer, &cachelen, &rfd, &wfd, &mark);
-  /* when deleting a section, the section head that was just found has not been
-   * copied to the output file, but because this line was not "accumulated" in
-   * the cache, the position in the input file was reset to the point just
-   * before the section; this must now be skipped (again)
-   */
-  if (Key == NULL) {
-    (void)ini_read(LocalBuffer, INI_BUFFERSIZE, &rfd);
-    (void)ini_tell(&rfd, &mark);
-  }
+/** ini_puts_splice()
+ * \param Section     the name of the section to write the string in
+ * \param Key         the name of the entry to write, or NULL to erase all keys in the section
+ * \param Value       a pointer to the buffer the string, or NULL to erase the key
+ * \param Filename    the name and full path of the .ini file to write to
+ * \param Splice      set to the part of the file that changed: at the offset,
+ *                    "removed" bytes were replaced by "inserted" bytes (both
+ *                    zero if the file was not changed); may be NULL
+ *
+ * File offsets that were cached before the write stay valid if they are
+ * before the offset, and they must be shifted by inserted - removed if they
+ * are at or beyond offset + removed.
+ *
+ * \return            1 if successful, otherwise 0
+ */
+SceBool ini_puts_splice(const char *Section, const char *Key, const char *Value, const char *Filename,
+                        INI_SPLICE *Splice)
+{
+  SceBool ok;
 
-  /* Now that the section has been found, find the entry. Stop searching
-   * upon leaving the section's area. Copy the file as it is read
-   * and create an entry if one is not found.
-   */
-  len = (Key != NULL) ? (SceSize)strlen(Key) : 0;
-  for( ;; ) {
-    if (!ini_read(LocalBuffer, INI_BUFFERSIZE, &rfd)) {
-      /* EOF without an entry so make one */
-      flag = cache_flush(LocalBuffer, &cachelen, &rfd, &wfd, &mark);
-      if (Key!=NULL && Value!=NULL) {
-        if (!flag)
-          (void)ini_write(INI_LINETERM, 1, &wfd);  /* force a new line behind the last line of the INI file */
-        writekey(LocalBuffer, Key, Value, &wfd);
-      }
-      return close_rename(&rfd, &wfd, Filename, LocalBuffer);  /* clean up and rename */
-    }
-    sp = skipleading(LocalBuffer);
-    ep = strchr(sp, '='); /* Parse out the equal sign */
-    if (ep == NULL)
-      ep = strchr(sp, ':');
-    match = (ep != NULL && len > 0 && (SceUInt)(skiptrailing(ep,sp)-sp) == len && strnicmp(sp,Key,len) == 0);
-    if ((Key != NULL && match) || *sp == '[')
-      break;  /* found the key, or found a new section */
-    /* copy other keys in the section */
-    if (Key == NULL) {
-      (void)ini_tell(&rfd, &mark);  /* we are deleting the entire section, so update the read position */
-    } else {
-      if (!cache_accum(LocalBuffer, &cachelen, INI_BUFFERSIZE)) {
-        cache_flush(LocalBuffer, &cachelen, &rfd, &wfd, &mark);
-        (void)ini_read(LocalBuffer, INI_BUFFERSIZE, &rfd);
-        cache_accum(LocalBuffer, &cachelen, INI_BUFFERSIZE);
-      }
-    }
-  }
-  /* the key was found, or we just dropped on the next section (meaning that it
-   * wasn't found); in both cases we need to write the key, but in the latter
-   * case, we also need to write the line starting the new section after writing
-   * the key
-   */
-  flag = (*sp == '[');
-  cache_flush(LocalBuffer, &cachelen, &rfd, &wfd, &mark);
-  if (Key != NULL && Value != NULL)
-    writekey(LocalBuffer, Key, Value, &wfd);
-  /* cache_flush() reset the "read pointer" to the start of the line with the
-   * previous key or the new section; read it again (because writekey() destroyed
-   * the buffer)
-   */
-  (void)ini_read(LocalBuffer, INI_BUFFERSIZE, &rfd);
-  if (flag) {
-    /* the new section heading needs to be copied to the output file */
-    cache_accum(LocalBuffer, &cachelen, INI_BUFFERSIZE);
-  } else {
-    /* forget the old key line */
-    (void)ini_tell(&rfd, &mark);
-  }
-  /* Copy the rest of the INI file */
-  while (ini_read(LocalBuffer, INI_BUFFERSIZE, &rfd)) {
-    if (!cache_accum(LocalBuffer, &cachelen, INI_BUFFERSIZE)) {
-      cache_flush(LocalBuffer, &cachelen, &rfd, &wfd, &mark);
-      (void)ini_read(LocalBuffer, INI_BUFFERSIZE, &rfd);
-      cache_accum(LocalBuffer, &cachelen, INI_BUFFERSIZE);
-    }
-  }
-  cache_flush(LocalBuffer, &cachelen, &rfd, &wfd, &mark);
-  return close_rename(&rfd, &wfd, Filename, LocalBuffer);  /* clean up and rename */
+  TRACE_BEGIN("ini_puts");
+  ok = puts_splice(Section, Key, 0, Value, Filename, Splice);
+#if INI_ENUMCURSOR
+  enum_writes++;
+#endif
+  TRACE_END("ini_puts");
+  return ok;
+}
+
+/** ini_puts_nth()
+ * \param Section     the name of the section to write the string in
+ * \param Key         the name of the entry to write
+ * \param Occurrence  which occurrence of a key that appears more than once in
+ *                    the section is written, from 0 (the one that ini_puts()
+ *                    writes) in file order, as ini_getdups() returns them
+ * \param Value       a pointer to the buffer the string, or NULL to erase
+ *                    this occurrence of the key
+ * \param Filename    the name and full path of the .ini file to write to
+ *
+ * When the section has fewer occurrences of the key, the value is added as a
+ * new occurrence, at the end of the section (and erasing does nothing).
+ *
+ * \return            1 if successful, otherwise 0
+ */
+SceBool ini_puts_nth(const char *Section, const char *Key, int Occurrence, const char *Value, const char *Filename)
+{
+  SceBool ok;
+
+  if (Key == NULL || Occurrence < 0)
+    return INI_FALSE;
+  TRACE_BEGIN("ini_puts_nth");
+  ok = puts_splice(Section, Key, Occurrence, Value, Filename, NULL);
+#if INI_ENUMCURSOR
+  enum_writes++;
+#endif
+  TRACE_END("ini_puts_nth");
+  return ok;
 }
 
 /** ini_puti()
@@ -939,4 +5265,435 @@ SceBool ini_putbool(const char *Section, const char *Key, SceBool Value, const c
   return ini_puts(Section, Key, Value ? "true" : "false", Filename);
 }
 
+#if INI_LAZYINDEX
+/* Remove a section (that has no parsed keys) from the section table */
+static void index_remove(INI_INDEX *index, int i)
+{
+  int j;
+
+  assert(i > 0 && i < index->count && index->sections[i].parsed == NULL);
+  index_droptree(index);
+  memmove(&index->sections[i], &index->sections[i + 1], (index->count - i - 1) * sizeof(INI_SECTIONSPAN));
+  index->count--;
+  /* the LRU links are indices into the table, so renumber them */
+  for (j = 0; j < index->count; j++) {
+    if (index->sections[j].newer > i)
+      index->sections[j].newer--;
+    if (index->sections[j].older > i)
+      index->sections[j].older--;
+  }
+  if (index->mru > i)
+    index->mru--;
+  if (index->lru > i)
+    index->lru--;
+}
+
+#if !INI_CASESENSITIVE
+/* Index the file again after a change that ini_puts() made with names that
+ * are not case-sensitive, so that the index sees the sections as they are */
+static SceBool index_reopen(INI_INDEX *index)
+{
+  INI_ALLOCATOR allocator = index->allocator;
+  SceSize budget = index->cache.budget;
+  SceBool casesensitive = index->casesensitive;
+  char *filename = (char *)mem_alloc(&allocator, strlen(index->filename) + 1);
+  SceBool ok;
+
+  if (filename == NULL)
+    return INI_FALSE;
+  strcpy(filename, index->filename);
+  ini_index_close(index);
+  ok = ini_index_open_alloc(index, filename, &allocator);
+  if (ok) {
+    ini_index_setbudget(index, budget);
+    ini_index_setcase(index, casesensitive);
+  }
+  mem_free(&allocator, filename);
+  return ok;
+}
+#endif
+
+/** ini_index_puts()
+ * \param index       an index opened with ini_index_open()
+ * \param Section     the name of the section to write the string in
+ * \param Key         the name of the entry to write, or NULL to erase all keys in the section
+ * \param Value       a pointer to the buffer the string, or NULL to erase the key
+ *
+ * Writes the setting to the file of the index, like ini_puts(), and adjusts
+ * the index to the change: the sections behind the change are shifted, and
+ * only the section that changed is parsed again on its next access. An index
+ * with case-sensitive names (see ini_index_setcase()) is built again instead,
+ * because ini_puts() matches the names regardless of case.
+ *
+ * \return            1 if successful, otherwise 0
+ */
+SceBool ini_index_puts(INI_INDEX *index, const char *Section, const char *Key, const char *Value)
+{
+  char LocalBuffer[INI_BUFFERSIZE];
+  INI_SPLICE splice;
+  INI_SECTIONSPAN *span;
+  SceOff delta;
+  int i, j;
+
+  assert(index != NULL && index->filename != NULL);
+  if (!ini_puts_splice(Section, Key, Value, index->filename, &splice))
+    return INI_FALSE;
+  if (splice.removed == 0 && splice.inserted == 0)
+    return INI_TRUE;
+  index_droptree(index);  /* a section may have been added or removed */
+#if !INI_CASESENSITIVE
+  if (index->casesensitive)
+    return index_reopen(index);
+#endif
+
+  if ((span = index_section(index, Section)) == NULL) {
+    /* a new section with the key was added to the end of the file */
+    INI_FILEPOS head, next, end = splice.offset + splice.inserted;
+    writekey(LocalBuffer, Key, Value, NULL);
+    next = end - (INI_FILEPOS)strlen(LocalBuffer);
+    writesection(LocalBuffer, Section, NULL);
+    head = next - (INI_FILEPOS)strlen(LocalBuffer);
+    index_drop(index, index->count - 1);
+    index->sections[index->count - 1].end = head;
+    if (!index_addsection(index, LocalBuffer + 1, head, next))
+      return INI_FALSE;
+    index->sections[index->count - 1].end = end;
+    return INI_TRUE;
+  }
+
+  i = (int)(span - index->sections);
+  delta = splice.inserted - splice.removed;
+  index_drop(index, i);
+  index->sections[i].end += delta;
+  for (j = i + 1; j < index->count; j++) {
+    index->sections[j].start += delta;
+    index->sections[j].end += delta;
+  }
+  if (Key == NULL && i > 0)
+    index_remove(index, i);   /* the section was erased, with its header */
+  return INI_TRUE;
+}
+#endif /* INI_LAZYINDEX */
+
+#if INI_VERSIONS
+/* Find the section headers in the file, which must be those of the version
+ * that was last saved: heads[i] is the offset of the header of section i
+ * (heads[0] is zero), and heads[count] is the end of the file. Returns false
+ * if the file has other sections (it was changed behind the document).
+ */
+static SceBool doc_scanheads(const INI_DOC *doc, const DOC_VERSION *base, INI_FILETYPE *rfd, INI_FILEPOS *heads,
+                             char *LocalBuffer)
+{
+  INI_FILEPOS pos;
+  char *sp, *ep;
+  int n = 0;
+
+  heads[0] = 0;
+  for ( ;; ) {
+    (void)ini_tell(rfd, &pos);
+    if (!ini_readline(LocalBuffer, INI_BUFFERSIZE, rfd))
+      break;
+    sp = skipleading(LocalBuffer);
+    if (*sp != '[' || (ep = strrchr(sp, ']')) == NULL)
+      continue;
+    sp = skipleading(sp + 1);
+    ep = skiptrailing(ep, sp);
+    if (++n >= base->count || section_name(base->sections[n])[ep - sp] != '\0'
+        || namecasecmp(section_name(base->sections[n]), sp, (SceSize)(ep - sp), exact_names(doc)) != 0)
+      return INI_FALSE;
+    heads[n] = pos;
+  }
+  heads[base->count] = pos;
+  return n == base->count - 1;
+}
+
+/* Pair the sections of cur with those of base, whose lines are in the file:
+ * a section that did not change is paired with itself, and the changed
+ * sections with the unpaired sections with the same name in base, aligned
+ * from the end (only the first section with a name is edited or erased, so
+ * the sections behind it are those that stay). The sections of base are
+ * looked up through a hash table on their names. pairs[i] is the index in
+ * base for section i of cur, or -1 for a new section.
+ */
+static SceBool doc_pairsections(const INI_DOC *doc, const DOC_VERSION *base, const DOC_VERSION *cur, int *pairs)
+{
+  int *slots, *next, *paired;
+  int i, j, slot, mask, nslots = 16;
+  const DOC_SECTION *sect;
+  SceSize len;
+
+  while (nslots < 2 * base->count)
+    nslots *= 2;
+  mask = nslots - 1;
+  slots = (int *)mem_alloc(&doc->allocator, (nslots + 2 * base->count) * sizeof(int));
+  if (slots == NULL)
+    return INI_FALSE;
+  next = slots + nslots;        /* the next section of base with the same hash */
+  paired = next + base->count;  /* whether a section of base is paired */
+  for (slot = 0; slot < nslots; slot++)
+    slots[slot] = -1;
+  for (i = base->count - 1; i > 0; i--) {
+    for (slot = (int)(base->sections[i]->hash & mask); slots[slot] >= 0; slot = (slot + 1) & mask)
+      if (base->sections[slots[slot]]->hash == base->sections[i]->hash)
+        break;
+    next[i] = slots[slot];
+    slots[slot] = i;
+    paired[i] = INI_FALSE;
+  }
+  pairs[0] = 0;
+  for (i = 1; i < cur->count; i++) {
+    sect = cur->sections[i];
+    for (slot = (int)(sect->hash & mask); slots[slot] >= 0; slot = (slot + 1) & mask)
+      if (base->sections[slots[slot]]->hash == sect->hash)
+        break;
+    for (j = slots[slot]; j >= 0 && base->sections[j] != sect; j = next[j])
+      /* nothing */;
+    pairs[i] = j;
+    if (j >= 0)
+      paired[j] = INI_TRUE;
+  }
+  for (i = cur->count - 1; i > 0; i--) {
+    if (pairs[i] >= 0)
+      continue;
+    sect = cur->sections[i];
+    for (slot = (int)(sect->hash & mask); slots[slot] >= 0; slot = (slot + 1) & mask)
+      if (base->sections[slots[slot]]->hash == sect->hash)
+        break;
+    len = (SceSize)strlen(section_name(sect));
+    for (pairs[i] = -1, j = slots[slot]; j >= 0; j = next[j])
+      if (!paired[j] && section_name(base->sections[j])[len] == '\0'
+          && namecasecmp(section_name(base->sections[j]), section_name(sect), len, exact_names(doc)) == 0)
+        pairs[i] = j;
+    if (pairs[i] >= 0)
+      paired[pairs[i]] = INI_TRUE;
+  }
+  mem_free(&doc->allocator, slots);
+  return INI_TRUE;
+}
+
+/* Copy the file from mark up to end, if there is anything to copy, and note
+ * whether the output now ends with a line terminator */
+static void doc_copy(char *Block, INI_FILETYPE *rfd, INI_FILETYPE *wfd, INI_FILEPOS *mark, INI_FILEPOS end,
+                     SceBool *terminated)
+{
+  if (*mark < end)
+    *terminated = cache_flush(Block, rfd, wfd, mark, end);
+}
+
+/* Start a new line in the output, if the last line that was copied has no
+ * line terminator (the last line of the file) */
+static void doc_newline(INI_FILETYPE *wfd, SceBool *terminated)
+{
+  if (!*terminated)
+    (void)ini_write(INI_LINETERM, strlen(INI_LINETERM), wfd);
+  *terminated = INI_TRUE;
+}
+
+/* Write a section from the lines of its old version in the file, from start
+ * up to end. The lines of keys whose values did not change are copied, like
+ * the comments and the header; a key that occurs more than once is matched
+ * by its occurrence (the nth line with the name holds the nth value). Keys
+ * that are not in the section any more are dropped, and new keys are added
+ * behind the last line of the section, or in front of the first '[' line
+ * that is not a valid section header (which ends the section too).
+ */
+static SceBool doc_savekeys(const INI_DOC *doc, const DOC_SECTION *sect, SceBool header, INI_FILETYPE *rfd,
+                            INI_FILETYPE *wfd, INI_FILEPOS start, INI_FILEPOS end, SceBool *terminated)
+{
+  char LocalBuffer[INI_BUFFERSIZE], Block[INI_BUFFERSIZE];
+  const INI_BLOCK *keys = sect->keys;
+  const INI_RECORD **recs, *rec;
+  int *slots, *first, *next, *used;
+  int k, slot, mask, nslots = 16;
+  INI_FILEPOS mark = start, line = start, pos;
+  SceUInt32 hash;
+  SceSize len;
+  char *sp, *vp;
+
+  while (nslots < 2 * keys->count)
+    nslots *= 2;
+  mask = nslots - 1;
+  recs = (const INI_RECORD **)mem_alloc(&doc->allocator, keys->count * sizeof(INI_RECORD *)
+                                                         + (2 * nslots + 2 * keys->count) * sizeof(int));
+  if (recs == NULL)
+    return INI_FALSE;
+  slots = (int *)(recs + keys->count);  /* the first key with a hash */
+  first = slots + nslots;               /* the first unused key with that hash */
+  next = first + nslots;                /* the next key with the same hash */
+  used = next + keys->count;
+  for (slot = 0; slot < nslots; slot++)
+    slots[slot] = -1;
+  for (k = 0, rec = block_first(keys); k < keys->count; k++, rec = record_next(rec))
+    recs[k] = rec;
+  for (k = keys->count - 1; k >= 0; k--) {
+    for (slot = (int)(recs[k]->hash & mask); slots[slot] >= 0; slot = (slot + 1) & mask)
+      if (recs[slots[slot]]->hash == recs[k]->hash)
+        break;
+    next[k] = slots[slot];
+    first[slot] = slots[slot] = k;
+    used[k] = INI_FALSE;
+  }
+
+  if (start < end || keys->count > 0)
+    doc_newline(wfd, terminated);
+  if (start < end) {
+    (void)ini_seek(rfd, &mark);
+    if (header)
+      (void)ini_readline(LocalBuffer, INI_BUFFERSIZE, rfd);
+    for ( ;; ) {
+      (void)ini_tell(rfd, &line);
+      if (line >= end || !ini_readline(LocalBuffer, INI_BUFFERSIZE, rfd) || *skipleading(LocalBuffer) == '[')
+        break;
+      if (!splitkey(LocalBuffer, &sp, &len, &vp))
+        continue;
+      /* take the first unused key with the name */
+      hash = ini_hashcase(sp, len, exact_names(doc));
+      for (slot = (int)(hash & mask); slots[slot] >= 0; slot = (slot + 1) & mask)
+        if (recs[slots[slot]]->hash == hash)
+          break;
+      for (k = (slots[slot] >= 0) ? first[slot] : -1; k >= 0; k = next[k])
+        if (!used[k] && (SceSize)recs[k]->keylen == len && namememcmp(record_key(recs[k]), sp, len, exact_names(doc)) == 0)
+          break;
+      if (k >= 0) {
+        used[k] = INI_TRUE;
+        if (k == first[slot])
+          first[slot] = next[k];  /* the keys with a name are taken in order */
+        if (strcmp(record_value(recs[k]), vp) == 0)
+          continue;               /* unchanged, the line is copied */
+      }
+      (void)ini_tell(rfd, &pos);
+      doc_copy(Block, rfd, wfd, &mark, line, terminated);
+      if (k >= 0) {
+        doc_newline(wfd, terminated);
+        writekey(LocalBuffer, record_key(recs[k]), record_value(recs[k]), wfd);
+      }
+      mark = pos;                 /* skip the old line */
+    }
+  }
+  doc_copy(Block, rfd, wfd, &mark, line, terminated);
+  for (k = 0; k < keys->count; k++) {
+    if (!used[k]) {
+      doc_newline(wfd, terminated);
+      writekey(LocalBuffer, record_key(recs[k]), record_value(recs[k]), wfd);
+    }
+  }
+  doc_copy(Block, rfd, wfd, &mark, end, terminated);
+  mem_free(&doc->allocator, (void *)recs);
+  return INI_TRUE;
+}
+
+/* Write the sections of cur in their order: the unchanged ones are copied,
+ * the changed ones through doc_savekeys(), and the new ones are written */
+static SceBool doc_savesections(const INI_DOC *doc, const DOC_VERSION *base, const DOC_VERSION *cur,
+                                const int *pairs, const INI_FILEPOS *heads, INI_FILETYPE *rfd, INI_FILETYPE *wfd)
+{
+  char LocalBuffer[INI_BUFFERSIZE];
+  const DOC_SECTION *sect;
+  const INI_RECORD *rec;
+  INI_FILEPOS mark;
+  SceBool ok = INI_TRUE, terminated = INI_TRUE;
+  int i, j, k;
+
+  for (i = 0; ok && i < cur->count; i++) {
+    sect = cur->sections[i];
+    j = pairs[i];
+    if (j >= 0 && base->sections[j] == sect) {
+      /* an unchanged section is copied as a whole */
+      mark = heads[j];
+      if (mark < heads[j + 1])
+        doc_newline(wfd, &terminated);
+      doc_copy(LocalBuffer, rfd, wfd, &mark, heads[j + 1], &terminated);
+    } else if (j >= 0) {
+      ok = doc_savekeys(doc, sect, j > 0, rfd, wfd, heads[j], heads[j + 1], &terminated);
+    } else {
+      doc_newline(wfd, &terminated);
+      if (*section_name(sect) == '\0')
+        (void)ini_write("[]" INI_LINETERM, 2 + strlen(INI_LINETERM), wfd);
+      else
+        writesection(LocalBuffer, section_name(sect), wfd);
+      for (k = 0, rec = block_first(sect->keys); k < sect->keys->count; k++, rec = record_next(rec))
+        writekey(LocalBuffer, record_key(rec), record_value(rec), wfd);
+    }
+  }
+  return ok;
+}
+
+/** ini_doc_save()
+ * \param doc         a document opened with ini_doc_open()
+ *
+ * Writes the current version to the file, in a single copy of the file. Only
+ * the differences with the version that was last saved (or opened) are
+ * written: the sections that both versions share are copied without looking
+ * at their lines, and in a changed section, only the lines of the keys that
+ * changed are replaced. Comments and the layout of the file are kept, also
+ * for keys that occur more than once and for case-sensitive names (see
+ * ini_doc_setcase()). New sections go where they are in the document.
+ *
+ * \return            1 if successful, 0 if the file was changed by other
+ *                    means since the document was last saved (or opened), or
+ *                    on a write error or when out of memory
+ */
+SceBool ini_doc_save(INI_DOC *doc)
+{
+  char LocalBuffer[INI_BUFFERSIZE];
+  DOC_VERSION *base = (DOC_VERSION *)doc->base;
+  DOC_VERSION *cur = (DOC_VERSION *)doc->versions[doc->current];
+  INI_FILETYPE rfd, wfd;
+  INI_FILEPOS *heads;
+  int *pairs;
+  SceBool ok, found;
+
+  assert(doc != NULL && base != NULL);
+  if (cur == base)
+    return INI_TRUE;
+  TRACE_BEGIN("ini_doc_save");
+  heads = (INI_FILEPOS *)mem_alloc(&doc->allocator, (base->count + 1) * sizeof(INI_FILEPOS));
+  pairs = (int *)mem_alloc(&doc->allocator, cur->count * sizeof(int));
+  ok = (heads != NULL && pairs != NULL);
+  found = ok && ini_opensource(doc->filename, &rfd);
+  if (found) {
+    ok = doc_scanheads(doc, base, &rfd, heads, LocalBuffer);
+  } else if (ok) {
+    /* no file: only a document without sections or keys was read from it */
+    ok = (base->count == 1 && base->sections[0]->keys->count == 0);
+    heads[0] = heads[1] = 0;
+  }
+  ok = ok && doc_pairsections(doc, base, cur, pairs);
+  if (ok) {
+    ini_tempname(LocalBuffer, doc->filename, INI_BUFFERSIZE);
+    ok = ini_openwrite(LocalBuffer, &wfd);
+  }
+  if (ok) {
+    ok = doc_savesections(doc, base, cur, pairs, heads, &rfd, &wfd);
+    ok = ini_close(&wfd) && ok;
+    if (found)
+      (void)ini_close(&rfd);
+    found = INI_FALSE;
+    ini_tempname(LocalBuffer, doc->filename, INI_BUFFERSIZE);
+    if (ok) {
+      (void)ini_remove(doc->filename);
+      ok = ini_rename(LocalBuffer, doc->filename);
+    } else {
+      (void)ini_remove(LocalBuffer);
+    }
+#if INI_ENUMCURSOR
+    enum_writes++;
+#endif
+  }
+  if (found)
+    (void)ini_close(&rfd);
+  if (heads != NULL)
+    mem_free(&doc->allocator, heads);
+  if (pairs != NULL)
+    mem_free(&doc->allocator, pairs);
+  if (ok) {
+    version_release(&doc->allocator, base);
+    cur->refs++;
+    doc->base = cur;
+  }
+  TRACE_END("ini_doc_save");
+  return ok;
+}
+#endif /* INI_VERSIONS */
+
 #endif /* !INI_READONLY */
\ No newline at end of file
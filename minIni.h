@@ -37,6 +37,102 @@
   #define INI_BROWSE    INI_TRUE
 #endif
 
+/* Append new keys without copying the file when the key belongs to the last
+ * section, or to a section that doesn't exist yet */
+#ifndef INI_FASTAPPEND
+  #define INI_FASTAPPEND  INI_TRUE
+#endif
+
+/* Crash-safe append: write the appended lines at once and sync the device */
+#ifndef INI_SYNCAPPEND
+  #define INI_SYNCAPPEND  INI_FALSE
+#endif
+
+/* Commit writes to two alternating slot files (Filename.a and Filename.b),
+ * each ending with a sequence number and a checksum, instead of through a
+ * temporary file that is renamed; readers use the newest valid slot */
+#ifndef INI_PINGPONG
+  #define INI_PINGPONG  INI_FALSE
+#endif
+
+/* Section index: scan only the section headers when the index is opened, and
+ * parse the keys of a section on its first access */
+#ifndef INI_LAZYINDEX
+  #define INI_LAZYINDEX INI_FALSE
+#endif
+
+/* Default memory budget (in bytes) for the parsed sections of a section
+ * index; the least recently used sections are evicted when it is exceeded.
+ * Zero means no limit */
+#ifndef INI_CACHEBUDGET
+  #define INI_CACHEBUDGET 0
+#endif
+
+/* Enumeration cursor: ini_getsection() and ini_getkey() resume where the
+ * previous call stopped when they are called with the next index on an
+ * unchanged file, instead of scanning from the start; it costs a static
+ * cursor of two INI_BUFFERSIZE names */
+#ifndef INI_ENUMCURSOR
+  #define INI_ENUMCURSOR  INI_FALSE
+#endif
+
+/* Sidecar index: keep a sorted table of (section, key, offset) records next
+ * to the INI file (Filename.idx), so that lookups in a large, mostly static
+ * file need a binary search instead of a scan. The sidecar is rebuilt when
+ * it is stale */
+#ifndef INI_SIDECAR
+  #define INI_SIDECAR   INI_FALSE
+#endif
+
+/* Maximum number of records appended to the sidecar (unsorted) by ini_puts()
+ * before the sidecar is rebuilt */
+#ifndef INI_SIDECAROVERFLOW
+  #define INI_SIDECAROVERFLOW 64
+#endif
+
+#if INI_SIDECAR && INI_PINGPONG
+  #error INI_SIDECAR cannot be combined with INI_PINGPONG
+#endif
+
+/* Document versions: the file is parsed into memory, every edit makes a new
+ * version that shares the unchanged sections with the previous version, and
+ * undo/redo switch between versions */
+#ifndef INI_VERSIONS
+  #define INI_VERSIONS  INI_FALSE
+#endif
+
+#if INI_VERSIONS && INI_PINGPONG
+  #error INI_VERSIONS cannot be combined with INI_PINGPONG
+#endif
+
+/* Published image: the file is parsed once into a position-independent
+ * image in memory that is shared by many readers, which look up values in
+ * it without parsing */
+#ifndef INI_IMAGE
+  #define INI_IMAGE     INI_FALSE
+#endif
+
+/* Hot-key profiler: count the lookups per (file, section, key), with their
+ * time, cache hits and the path that they took */
+#ifndef INI_PROFILE
+  #define INI_PROFILE   INI_FALSE
+#endif
+
+/* Number of (file, section, key) entries that the profiler keeps, and the
+ * size of the (truncated) names in an entry */
+#ifndef INI_PROFILESIZE
+  #define INI_PROFILESIZE 64
+#endif
+#ifndef INI_PROFILENAME
+  #define INI_PROFILENAME 32
+#endif
+
+/* Trace export: write all API calls and glue I/O calls as Chrome trace
+ * events (JSON), to a buffer or a file */
+#ifndef INI_TRACE
+  #define INI_TRACE     INI_FALSE
+#endif
+
 /* INI Debug (for asserts). Only use when debugging this library! */
 #ifndef INI_DEBUG
   #define INI_DEBUG     INI_FALSE
@@ -47,34 +143,313 @@
   #define INI_BUFFERSIZE  512
 #endif
 
+/* Block size for reading files in bulk (section index) */
+#ifndef INI_SCANSIZE
+  #define INI_SCANSIZE  2048
+#endif
+
+/* The dialect; leaving out what the files do not use removes those cases
+ * from the parsing loops. A ':' separates a key from its value, as well as
+ * a '=' */
+#ifndef INI_COLONDELIM
+  #define INI_COLONDELIM    INI_TRUE
+#endif
+
+/* A '#' starts a comment, as well as a ';' */
+#ifndef INI_HASHCOMMENT
+  #define INI_HASHCOMMENT   INI_TRUE
+#endif
+
+/* Values may be quoted (a comment character between quotes is part of the
+ * value, and "" and \" are escaped quotes); without it, a value runs up to
+ * the first comment character and is returned as is */
+#ifndef INI_QUOTES
+  #define INI_QUOTES        INI_TRUE
+#endif
+
+/* Section and key names match with their case (compared with memcmp() or
+ * strncmp(), and hashed without case folding); an index or a document can
+ * also be made case-sensitive on its own */
+#ifndef INI_CASESENSITIVE
+  #define INI_CASESENSITIVE INI_FALSE
+#endif
+
+/* A key line goes on over the lines that continue it: a line that ends with
+ * a backslash is joined with the next line, and an indented line (that is
+ * not blank, a comment or a section) adds a line to the value; keys cannot
+ * be indented. Values that ini_puts() writes are folded at INI_FOLDWIDTH
+ * characters. The push parser (ini_feed()) and INI_STATIC see single lines */
+#ifndef INI_CONTINUATION
+  #define INI_CONTINUATION  INI_FALSE
+#endif
+#ifndef INI_FOLDWIDTH
+  #define INI_FOLDWIDTH     76
+#endif
+
+#if INI_CONTINUATION && (INI_LAZYINDEX || INI_SIDECAR)
+  #error INI_CONTINUATION cannot be combined with INI_LAZYINDEX or INI_SIDECAR
+#endif
+
 /* Default Newline */
 #ifndef INI_LINETERM
   #define INI_LINETERM      "\n"
   #define INI_LINETERMCHAR  '\n'
 #endif
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Which occurrences of a key that appears more than once in a section are
+ * returned by ini_getdups(); the other getters return the first one, and
+ * ini_puts() writes the first one (ini_puts_nth() writes any one) */
+enum {
+  INI_DUP_FIRST,
+  INI_DUP_LAST,
+  INI_DUP_ALL,  /* all of them, in file order */
+};
+
 int       ini_geti(const char *Section, const char *Key, int DefValue, const char *Filename);
 SceUInt   ini_getu(const char *Section, const char *Key, SceUInt DefValue, const char *Filename);
 SceBool   ini_getbool(const char *Section, const char *Key, SceBool DefValue, const char *Filename);
 float     ini_getf(const char *Section, const char *Key, float DefValue, const char *Filename);
 SceSize   ini_gets(const char *Section, const char *Key, const char *DefValue, char *Buffer, SceSize BufferSize, const char *Filename);
+SceSize   ini_gets_len(const char *Section, const char *Key, const char *DefValue, char *Buffer, SceSize BufferSize, const char *Filename);
 SceSize   ini_getsection(int idx, char *Buffer, SceSize BufferSize, const char *Filename);
 SceSize   ini_getkey(const char *Section, int idx, char *Buffer, SceSize BufferSize, const char *Filename);
+int       ini_getdups(const char *Section, const char *Key, int Policy, char *Buffer, SceSize BufferSize, const char *Filename);
 
 SceBool   ini_hassection(const char *Section, const char *Filename);
 SceBool   ini_haskey(const char *Section, const char *Key, const char *Filename);
 
+/* A bump allocator over caller-provided memory, for ini_gets_alloc() */
+typedef struct {
+  char      *base;
+  SceSize   size;
+  SceSize   used;
+} INI_ARENA;
+
+void      ini_arena_init(INI_ARENA *arena, void *Memory, SceSize Size);
+void      ini_arena_reset(INI_ARENA *arena);
+const char *ini_gets_alloc(INI_ARENA *arena, const char *Section, const char *Key, const char *DefValue, const char *Filename);
+
 #if !INI_READONLY
+/* The part of the file that a write changed: at "offset", "removed" bytes
+ * were replaced by "inserted" bytes */
+typedef struct {
+  SceOff    offset;
+  SceOff    removed;
+  SceOff    inserted;
+} INI_SPLICE;
+
 SceBool   ini_puti(const char *Section, const char *Key, int Value, const char *Filename);
 SceBool   ini_putu(const char *Section, const char *Key, SceUInt Value, const char *Filename);
 SceBool   ini_putbool(const char *Section, const char *Key, SceBool Value, const char *Filename);
 SceBool   ini_putf(const char *Section, const char *Key, float Value, const char *Filename);
 SceBool   ini_puts(const char *Section, const char *Key, const char *Value, const char *Filename);
+SceBool   ini_puts_splice(const char *Section, const char *Key, const char *Value, const char *Filename, INI_SPLICE *Splice);
+SceBool   ini_puts_nth(const char *Section, const char *Key, int Occurrence, const char *Value, const char *Filename);
 #endif /* INI_READONLY */
 
 #if INI_BROWSE
 typedef SceBool (*INI_CALLBACK)(const char *Section, const char *Key, const char *Value, void *UserData);
 SceBool   ini_browse(INI_CALLBACK Callback, void *UserData, const char *Filename);
+
+/* Pull parser events */
+enum {
+  INI_EVENT_EOF,
+  INI_EVENT_SECTION,
+  INI_EVENT_KEY,
+  INI_EVENT_COMMENT,
+  INI_EVENT_BLANK,
+};
+
+/* The file handle of the glue layer (see minGlue.h) */
+#ifndef INI_FILETYPE
+  #define INI_FILETYPE SceUID
+#endif
+
+/* A span points into the reader's line buffer; it is zero-terminated, and it
+ * stays valid until the next call to ini_next() */
+typedef struct {
+  const char *ptr;
+  SceSize    len;
+} INI_SPAN;
+
+typedef struct {
+  int       type;     /* INI_EVENT_xxx */
+  INI_SPAN  section;  /* the current section, "" above the first section */
+  INI_SPAN  key;      /* INI_EVENT_KEY: the key */
+  INI_SPAN  value;    /* INI_EVENT_KEY: the (dequoted) value; INI_EVENT_COMMENT: the comment text */
+} INI_EVENT;
+
+typedef struct {
+  INI_FILETYPE fd;
+  char      line[INI_BUFFERSIZE];
+  char      section[INI_BUFFERSIZE];
+  SceSize   sectionlen;
+} INI_READER;
+
+SceBool   ini_reader_open(INI_READER *reader, const char *Filename);
+int       ini_next(INI_READER *reader, INI_EVENT *event);
+void      ini_reader_close(INI_READER *reader);
+
+typedef struct {
+  INI_CALLBACK callback;
+  void      *userdata;
+  char      line[INI_BUFFERSIZE];
+  SceSize   len;
+  char      section[INI_BUFFERSIZE];
+  SceSize   sectionlen;
+  SceBool   stopped;
+} INI_PARSER;
+
+void      ini_parser_init(INI_PARSER *parser, INI_CALLBACK Callback, void *UserData);
+SceBool   ini_feed(INI_PARSER *parser, const char *data, SceSize len);
+SceBool   ini_feed_end(INI_PARSER *parser);
 #endif /* INI_BROWSE */
 
+#if INI_LAZYINDEX || INI_VERSIONS
+/* The memory of an index or a document; free() gets the size that alloc()
+ * was asked for. Without functions, ini_malloc() and ini_free() are used. */
+typedef struct {
+  void      *(*alloc)(void *context, SceSize size);
+  void      (*free)(void *context, void *ptr, SceSize size);
+  void      *context;
+} INI_ALLOCATOR;
+#endif
+
+#if INI_LAZYINDEX
+typedef struct {
+  SceOff    start;    /* offset of the first line below the section header */
+  SceOff    end;      /* offset of the line that ends the section */
+  SceUInt32 hash;     /* hash of the case-folded section name */
+  SceUInt32 name;     /* offset of the section name in the name pool */
+  void      *parsed;  /* parsed keys, NULL until the section is first accessed */
+  int       newer;    /* LRU list links (indices into the section table) */
+  int       older;
+  SceBool   oversize; /* too big for the cache budget, looked up in the file */
+} INI_SECTIONSPAN;
+
+typedef struct {
+  SceSize   budget;     /* maximum bytes for parsed sections, 0 = no limit */
+  SceSize   used;       /* bytes currently held by parsed sections */
+  SceUInt32 hits;       /* lookups in a section that was already parsed */
+  SceUInt32 misses;     /* lookups that had to (re-)parse a section */
+  SceUInt32 evictions;  /* parsed sections dropped to stay within the budget */
+} INI_CACHESTATS;
+
+typedef struct {
+  char            *filename;
+  INI_SECTIONSPAN *sections;  /* sections[0] holds the keys above the first section */
+  int             count, capacity;
+  char            *names;
+  SceSize         namesize, namecapacity;
+  int             mru, lru;   /* most and least recently used parsed sections */
+  INI_CACHESTATS  cache;
+  INI_ALLOCATOR   allocator;
+  SceBool         casesensitive;  /* see ini_index_setcase() */
+  void            *tree;      /* the hierarchy of dotted section names, built on first use */
+} INI_INDEX;
+
+SceBool   ini_index_open(INI_INDEX *index, const char *Filename);
+SceBool   ini_index_open_alloc(INI_INDEX *index, const char *Filename, const INI_ALLOCATOR *Allocator);
+void      ini_index_close(INI_INDEX *index);
+SceSize   ini_index_gets(INI_INDEX *index, const char *Section, const char *Key, const char *DefValue, char *Buffer, SceSize BufferSize);
+SceSize   ini_index_getsection(INI_INDEX *index, int idx, char *Buffer, SceSize BufferSize);
+SceSize   ini_index_getkey(INI_INDEX *index, const char *Section, int idx, char *Buffer, SceSize BufferSize);
+SceBool   ini_index_haskey(INI_INDEX *index, const char *Section, const char *Key);
+int       ini_index_getdups(INI_INDEX *index, const char *Section, const char *Key, int Policy, char *Buffer, SceSize BufferSize);
+SceSize   ini_index_getsubsection(INI_INDEX *index, const char *Section, int idx, char *Buffer, SceSize BufferSize);
+SceSize   ini_index_gets_inherit(INI_INDEX *index, const char *Section, const char *Key, const char *DefValue, char *Buffer, SceSize BufferSize);
+void      ini_index_setbudget(INI_INDEX *index, SceSize Budget);
+void      ini_index_setcase(INI_INDEX *index, SceBool CaseSensitive);
+#if !INI_READONLY
+SceBool   ini_index_puts(INI_INDEX *index, const char *Section, const char *Key, const char *Value);
+#endif
+#endif /* INI_LAZYINDEX */
+
+#if INI_VERSIONS
+typedef struct {
+  char      *filename;
+  void      **versions;   /* the edit history, oldest version first */
+  int       count, capacity;
+  int       current;      /* the version that is read and edited */
+  void      *base;        /* the version that matches the file */
+  INI_ALLOCATOR allocator;
+  SceBool   casesensitive;  /* see ini_doc_setcase() */
+} INI_DOC;
+
+SceBool   ini_doc_open(INI_DOC *doc, const char *Filename);
+SceBool   ini_doc_open_alloc(INI_DOC *doc, const char *Filename, const INI_ALLOCATOR *Allocator);
+void      ini_doc_close(INI_DOC *doc);
+SceSize   ini_doc_gets(INI_DOC *doc, const char *Section, const char *Key, const char *DefValue, char *Buffer, SceSize BufferSize);
+SceSize   ini_doc_getsection(INI_DOC *doc, int idx, char *Buffer, SceSize BufferSize);
+SceSize   ini_doc_getkey(INI_DOC *doc, const char *Section, int idx, char *Buffer, SceSize BufferSize);
+int       ini_doc_getdups(INI_DOC *doc, const char *Section, const char *Key, int Policy, char *Buffer, SceSize BufferSize);
+SceBool   ini_doc_puts(INI_DOC *doc, const char *Section, const char *Key, const char *Value);
+SceBool   ini_doc_undo(INI_DOC *doc);
+SceBool   ini_doc_redo(INI_DOC *doc);
+SceBool   ini_doc_setversion(INI_DOC *doc, int version);
+void      ini_doc_setcase(INI_DOC *doc, SceBool CaseSensitive);
+#if !INI_READONLY
+SceBool   ini_doc_save(INI_DOC *doc);
+#endif
+#endif /* INI_VERSIONS */
+
+#if INI_IMAGE
+SceSize   ini_image_publish(void *Image, SceSize ImageSize, const char *Filename);
+SceSize   ini_image_gets(const void *Image, SceSize ImageSize, const char *Section, const char *Key, const char *DefValue, char *Buffer, SceSize BufferSize);
+const char *ini_image_find(const void *Image, SceSize ImageSize, const char *Section, const char *Key, SceSize *Length, SceUInt32 *Generation);
+SceUInt32 ini_image_generation(const void *Image);
+
+/* An image in POSIX shared memory, shared by processes on the host; the PSP
+ * has no shared memory objects */
+#if !defined(__PSP__) && defined(__unix__)
+  #define MININI_SHAREDIMAGE
+void     *ini_image_create(const char *Name, SceSize ImageSize);
+const void *ini_image_attach(const char *Name, SceSize *ImageSize);
+void      ini_image_detach(const void *Image, SceSize ImageSize);
+SceBool   ini_image_remove(const char *Name);
+#endif
+#endif /* INI_IMAGE */
+
+#if INI_PROFILE
+/* The paths through which a lookup went */
+enum {
+  INI_PATH_CLASSIC  = 0x01, /* ini_gets(), scanning the file */
+  INI_PATH_SIDECAR  = 0x02, /* ini_gets(), through the sidecar index */
+  INI_PATH_INDEX    = 0x04, /* ini_index_gets() */
+  INI_PATH_DOC      = 0x08, /* ini_doc_gets() */
+  INI_PATH_IMAGE    = 0x10, /* ini_image_gets(), ini_image_find() */
+};
+
+typedef struct {
+  char      file[INI_PROFILENAME];    /* empty for a published image */
+  char      section[INI_PROFILENAME];
+  char      key[INI_PROFILENAME];
+  SceUInt32 calls;
+  SceUInt32 hits;     /* lookups that did not need to read the INI file */
+  SceUInt32 found;    /* lookups that found the key */
+  SceUInt64 time;     /* total time of the lookups, in microseconds */
+  int       paths;    /* INI_PATH_xxx flags */
+} INI_PROFILE_ENTRY;
+
+int       ini_profile_top(INI_PROFILE_ENTRY *entries, int count);
+SceUInt32 ini_profile_dropped(void);
+void      ini_profile_reset(void);
+SceBool   ini_profile_dump(int count, const char *Filename);
+#endif /* INI_PROFILE */
+
+#if INI_TRACE
+SceBool   ini_trace_start(char *Buffer, SceSize BufferSize);
+SceBool   ini_trace_startfile(const char *Filename);
+SceSize   ini_trace_stop(void);
+SceUInt32 ini_trace_dropped(void);
+#endif /* INI_TRACE */
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* MININI_H */
\ No newline at end of file
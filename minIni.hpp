@@ -0,0 +1,1208 @@
+/*  minIni - Multi-Platform INI file parser, suitable for embedded systems
+ *  pspIni - A optimized fork for the PlayStation: Portable
+ *
+ *  C++ wrapper (C++17): RAII handles over the C functions, std::string_view
+ *  results and typed get<T>() / put<T>(). No function allocates memory; a
+ *  string_view that a handle returns points into the handle's buffer, and it
+ *  stays valid until the next call on that handle.
+ *
+ *  Copyright (c) CompuPhase, 2008-2024
+ *  Copyright (c) danssmnt,   2025
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *  use this file except in compliance with the License. You may obtain a copy
+ *  of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *  License for the specific language governing permissions and limitations
+ *  under the License.
+ */
+#ifndef MININI_HPP
+#define MININI_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#if __cplusplus >= 202002L
+  #include <algorithm>
+  #include <array>
+  #include <ranges>
+  #if __has_include(<coroutine>)
+    #include <coroutine>
+    #include <optional>
+    #define MININI_COROUTINES
+  #endif
+  #if defined(MININI_COROUTINES) && !defined(__PSP__) && __has_include(<thread>)
+    #include <condition_variable>
+    #include <deque>
+    #include <mutex>
+    #include <thread>
+    #include <vector>
+    #define MININI_THREADPOOL
+  #endif
+#endif
+
+#include "minIni.h"
+#if INI_LAZYINDEX || INI_VERSIONS
+  #include <memory_resource>
+#endif
+
+namespace minIni {
+
+namespace detail {
+
+template <typename T>
+inline constexpr bool always_false = false;
+
+/* The same rules as ini_getbool() */
+inline bool to_bool(std::string_view value, bool def)
+{
+  if (value.empty())
+    return def;
+  switch (value[0]) {
+  case 'Y': case 'y': case 'T': case 't': case '1':
+    return true;
+  case 'N': case 'n': case 'F': case 'f': case '0':
+    return false;
+  default:
+    return def;
+  }
+}
+
+/* The same rules as ini_geti(), ini_getu() and ini_getf(): an empty value
+ * gives the default, a second character 'x' selects hexadecimal */
+template <typename T>
+T to_number(const char *value, SceSize len, T def)
+{
+  if (len == 0)
+    return def;
+  if constexpr (std::is_floating_point_v<T>) {
+    return static_cast<T>(std::strtod(value, nullptr));
+  } else {
+    int base = (len >= 2 && (value[1] == 'x' || value[1] == 'X')) ? 16 : 10;
+    if constexpr (std::is_signed_v<T>)
+      return static_cast<T>(std::strtoll(value, nullptr, base));
+    else
+      return static_cast<T>(std::strtoull(value, nullptr, base));
+  }
+}
+
+/* Format a value the way ini_puti(), ini_putu(), ini_putf() and
+ * ini_putbool() do; returns the text (in buffer, or a literal) */
+template <typename T>
+const char *to_text(T value, char *buffer, SceSize size)
+{
+  if constexpr (std::is_same_v<T, bool>) {
+    (void)buffer;
+    (void)size;
+    return value ? "true" : "false";
+  } else if constexpr (std::is_floating_point_v<T>) {
+    std::snprintf(buffer, size, "%f", static_cast<double>(value));
+  } else if constexpr (std::is_signed_v<T>) {
+    std::snprintf(buffer, size, "%lld", static_cast<long long>(value));
+  } else {
+    std::snprintf(buffer, size, "%llu", static_cast<unsigned long long>(value));
+  }
+  return buffer;
+}
+
+#if INI_LAZYINDEX || INI_VERSIONS
+/* An INI_ALLOCATOR on a std::pmr::memory_resource; a failed allocation is
+ * returned to the C functions as NULL */
+inline void *resource_alloc(void *context, SceSize size)
+{
+#if defined(__cpp_exceptions)
+  try {
+    return static_cast<std::pmr::memory_resource *>(context)->allocate(size, alignof(std::max_align_t));
+  } catch (...) {
+    return nullptr;
+  }
+#else
+  return static_cast<std::pmr::memory_resource *>(context)->allocate(size, alignof(std::max_align_t));
+#endif
+}
+
+inline void resource_free(void *context, void *ptr, SceSize size)
+{
+  static_cast<std::pmr::memory_resource *>(context)->deallocate(ptr, size, alignof(std::max_align_t));
+}
+
+inline INI_ALLOCATOR allocator(std::pmr::memory_resource *resource)
+{
+  return INI_ALLOCATOR{resource_alloc, resource_free, resource};
+}
+#endif
+
+} /* namespace detail */
+
+/* Typed getters, on top of the lookup of a handle:
+ *   SceSize lookup(const char *section, const char *key, const char *def, char *buffer, SceSize size)
+ */
+template <class Handle>
+class Getters {
+public:
+  /* The value, or the default when the key is absent */
+  std::string_view gets(const char *section, const char *key, const char *def = "")
+  {
+    SceSize len = self().lookup(section, key, def, buffer_, sizeof(buffer_));
+    return std::string_view(buffer_, len);
+  }
+
+  /* The value converted to T (an integer, floating point, bool or string
+   * type); the conversion is chosen at compile time */
+  template <typename T>
+  T get(const char *section, const char *key, T def)
+  {
+    if constexpr (std::is_same_v<T, std::string_view> || std::is_same_v<T, const char *>) {
+      /* the default is returned as is, so it need not be zero-terminated */
+      SceSize len = self().lookup(section, key, "", buffer_, sizeof(buffer_));
+      if (len == 0 && !self().has_key(section, key))
+        return def;
+      return T(buffer_);
+    } else if constexpr (std::is_same_v<T, bool>) {
+      SceSize len = self().lookup(section, key, "", buffer_, sizeof(buffer_));
+      return detail::to_bool(std::string_view(buffer_, len), def);
+    } else if constexpr (std::is_arithmetic_v<T>) {
+      SceSize len = self().lookup(section, key, "", buffer_, sizeof(buffer_));
+      return detail::to_number<T>(buffer_, len, def);
+    } else {
+      static_assert(detail::always_false<T>, "get<T>() supports integer, floating point, bool and string types");
+    }
+  }
+
+protected:
+  Getters() = default;
+  Getters(Getters &&) = default;
+  Getters &operator=(Getters &&) = default;
+  Getters(const Getters &) = delete;
+  Getters &operator=(const Getters &) = delete;
+  ~Getters() = default;
+
+  char buffer_[INI_BUFFERSIZE] = "";
+
+private:
+  Handle &self() { return static_cast<Handle &>(*this); }
+};
+
+#if INI_BROWSE
+/* A single forward pass over an INI file (ini_reader_open()), as a range of
+ * sections, where each section is a range of key/value pairs:
+ *
+ *   for (auto &sec : file.sections())
+ *     for (auto [key, value] : sec)
+ *       ...
+ *
+ * The sections come in file order, as with ini_browse(); the keys above the
+ * first section form a section with an empty name, which is only there when
+ * there are such keys. Both are input ranges: a section name is valid until
+ * the next section, a key and a value until the next key. Moving to the next
+ * section skips the keys that were not visited. As C++20 views, they work
+ * with range adaptors, like std::views::filter and std::views::take.
+ */
+class Sections
+#if __cplusplus >= 202002L
+  : public std::ranges::view_base
+#endif
+{
+public:
+  struct Sentinel {};
+
+  class Section {
+  public:
+    class iterator {
+    public:
+      using iterator_concept = std::input_iterator_tag;
+      using iterator_category = std::input_iterator_tag;
+      using value_type = std::pair<std::string_view, std::string_view>;
+      using difference_type = std::ptrdiff_t;
+      using reference = value_type;
+      using pointer = void;
+
+      iterator() = default;
+      explicit iterator(Sections *owner) : owner_(owner) {}
+
+      value_type operator*() const { return {owner_->span(owner_->event_.key), owner_->span(owner_->event_.value)}; }
+      iterator &operator++()
+      {
+        owner_->advance();
+        return *this;
+      }
+      void operator++(int) { ++*this; }
+
+      friend bool operator==(const iterator &it, Sentinel) { return it.done(); }
+      friend bool operator!=(const iterator &it, Sentinel s) { return !(it == s); }
+      friend bool operator==(Sentinel s, const iterator &it) { return it == s; }
+      friend bool operator!=(Sentinel s, const iterator &it) { return !(it == s); }
+
+    private:
+      bool done() const { return !owner_->at_key(); }
+      Sections *owner_ = nullptr;
+    };
+
+    Section() = default;
+    explicit Section(Sections *owner) : owner_(owner) {}
+
+    std::string_view name() const { return owner_->span(owner_->event_.section); }
+
+    /* The keys, starting at the first key of the section that was not visited */
+    iterator begin()
+    {
+      if (owner_->header_)
+        owner_->advance();
+      return iterator(owner_);
+    }
+    Sentinel end() const { return {}; }
+
+  private:
+    friend class Sections;
+    Sections *owner_ = nullptr;
+  };
+
+  class iterator {
+  public:
+    using iterator_concept = std::input_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Section;
+    using difference_type = std::ptrdiff_t;
+    using reference = Section &;
+    using pointer = Section *;
+
+    iterator() = default;
+    explicit iterator(Sections *owner) : owner_(owner) {}
+
+    Section &operator*() const { return owner_->section_; }
+    Section *operator->() const { return &owner_->section_; }
+    iterator &operator++()
+    {
+      owner_->next_section();
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(const iterator &it, Sentinel) { return it.done(); }
+    friend bool operator!=(const iterator &it, Sentinel s) { return !(it == s); }
+    friend bool operator==(Sentinel s, const iterator &it) { return it == s; }
+    friend bool operator!=(Sentinel s, const iterator &it) { return !(it == s); }
+
+  private:
+    bool done() const { return owner_->event_.type == INI_EVENT_EOF; }
+    Sections *owner_ = nullptr;
+  };
+
+  Sections() = default;
+  explicit Sections(const char *filename)
+  {
+    open_ = ini_reader_open(&reader_, filename);
+    section_.owner_ = this;
+  }
+  Sections(Sections &&other) noexcept { take(other); }
+  Sections &operator=(Sections &&other) noexcept
+  {
+    if (this != &other) {
+      close();
+      take(other);
+    }
+    return *this;
+  }
+  Sections(const Sections &) = delete;
+  Sections &operator=(const Sections &) = delete;
+  ~Sections() { close(); }
+
+  bool is_open() const { return open_; }
+
+  /* The first section; a forward-only range can be started only once */
+  iterator begin()
+  {
+    if (!started_) {
+      started_ = true;
+      advance();
+      header_ = (event_.type == INI_EVENT_SECTION);
+    }
+    return iterator(this);
+  }
+  Sentinel end() const { return {}; }
+
+private:
+  std::string_view span(const INI_SPAN &span) const { return std::string_view(span.ptr, span.len); }
+  bool at_key() const { return !header_ && event_.type == INI_EVENT_KEY; }
+
+  /* Read up to the next key, section or the end of the file */
+  void advance()
+  {
+    header_ = false;
+    if (!open_) {
+      event_.type = INI_EVENT_EOF;
+      return;
+    }
+    do
+      (void)ini_next(&reader_, &event_);
+    while (event_.type == INI_EVENT_COMMENT || event_.type == INI_EVENT_BLANK);
+  }
+
+  /* Skip the rest of the current section; when its keys were all visited,
+   * the header of the next section was already read */
+  void next_section()
+  {
+    if (header_ || event_.type == INI_EVENT_KEY) {
+      do
+        advance();
+      while (event_.type == INI_EVENT_KEY);
+    }
+    header_ = (event_.type == INI_EVENT_SECTION);
+  }
+
+  void take(Sections &other)
+  {
+    reader_ = other.reader_;
+    event_ = other.event_;
+    /* the spans point into the reader, which has moved */
+    auto rebase = [&](INI_SPAN &span, const char *from, char *to) {
+      if (span.ptr >= from && span.ptr < from + INI_BUFFERSIZE)
+        span.ptr = to + (span.ptr - from);
+    };
+    rebase(event_.section, other.reader_.section, reader_.section);
+    rebase(event_.key, other.reader_.line, reader_.line);
+    rebase(event_.value, other.reader_.line, reader_.line);
+    open_ = other.open_;
+    started_ = other.started_;
+    header_ = other.header_;
+    section_.owner_ = this;
+    other.open_ = false;
+  }
+
+  void close()
+  {
+    if (open_)
+      ini_reader_close(&reader_);
+    open_ = false;
+  }
+
+  INI_READER reader_{};
+  INI_EVENT event_{INI_EVENT_EOF, {"", 0}, {"", 0}, {"", 0}};
+  Section section_{};
+  bool open_ = false;
+  bool started_ = false;
+  bool header_ = false;   /* event_ is the header of the current section */
+};
+#endif /* INI_BROWSE */
+
+/* An INI file, read and written through the ini_gets() / ini_puts() family
+ * (and the sidecar index, with INI_SIDECAR) */
+class File : public Getters<File> {
+public:
+  explicit File(const char *filename)
+  {
+    std::strncpy(filename_, filename, sizeof(filename_) - 1);
+    filename_[sizeof(filename_) - 1] = '\0';
+  }
+  File(File &&) = default;
+  File &operator=(File &&) = default;
+
+  const char *filename() const { return filename_; }
+
+  SceSize lookup(const char *section, const char *key, const char *def, char *buffer, SceSize size)
+  {
+    return ini_gets(section, key, def, buffer, size, filename_);
+  }
+
+  bool has_section(const char *section) { return ini_hassection(section, filename_); }
+
+#if INI_BROWSE
+  /* All sections and keys, in one pass over the file */
+  Sections sections() const { return Sections(filename_); }
+#endif
+  bool has_key(const char *section, const char *key) { return ini_haskey(section, key, filename_); }
+
+  /* The name of section idx, empty past the last section */
+  std::string_view section(int idx)
+  {
+    return std::string_view(buffer_, ini_getsection(idx, buffer_, sizeof(buffer_), filename_));
+  }
+
+  /* The name of key idx in the section, empty past the last key */
+  std::string_view key(const char *section, int idx)
+  {
+    return std::string_view(buffer_, ini_getkey(section, idx, buffer_, sizeof(buffer_), filename_));
+  }
+
+#if !INI_READONLY
+  bool put(const char *section, const char *key, const char *value)
+  {
+    return ini_puts(section, key, value, filename_);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+  bool put(const char *section, const char *key, T value)
+  {
+    return put(section, key, detail::to_text(value, buffer_, sizeof(buffer_)));
+  }
+
+  bool erase(const char *section, const char *key) { return ini_puts(section, key, nullptr, filename_); }
+  bool erase_section(const char *section) { return ini_puts(section, nullptr, nullptr, filename_); }
+#endif
+
+private:
+  char filename_[INI_BUFFERSIZE];
+};
+
+#if INI_LAZYINDEX
+/* A section index over an INI file (ini_index_open()); closed when the
+ * handle is destroyed. With a memory resource, all memory of the index comes
+ * from that resource (which must outlive the index), else from ini_malloc() */
+class Index : public Getters<Index> {
+public:
+  explicit Index(const char *filename, std::pmr::memory_resource *resource = nullptr)
+  {
+    if (resource != nullptr) {
+      INI_ALLOCATOR allocator = detail::allocator(resource);
+      open_ = ini_index_open_alloc(&index_, filename, &allocator);
+    } else {
+      open_ = ini_index_open(&index_, filename);
+    }
+  }
+  Index(Index &&other) noexcept : Getters<Index>(std::move(other)), index_(other.index_), open_(other.open_)
+  {
+    other.open_ = false;
+  }
+  Index &operator=(Index &&other) noexcept
+  {
+    if (this != &other) {
+      close();
+      Getters<Index>::operator=(std::move(other));
+      index_ = other.index_;
+      open_ = other.open_;
+      other.open_ = false;
+    }
+    return *this;
+  }
+  ~Index() { close(); }
+
+  bool is_open() const { return open_; }
+  INI_INDEX *handle() { return &index_; }
+  std::pmr::memory_resource *resource() const
+  {
+    return static_cast<std::pmr::memory_resource *>(index_.allocator.context);
+  }
+  const INI_CACHESTATS &stats() const { return index_.cache; }
+  void set_budget(SceSize budget) { ini_index_setbudget(&index_, budget); }
+  void set_case_sensitive(bool exact) { ini_index_setcase(&index_, exact ? INI_TRUE : INI_FALSE); }
+
+  SceSize lookup(const char *section, const char *key, const char *def, char *buffer, SceSize size)
+  {
+    if (!open_) {
+      std::strncpy(buffer, def != nullptr ? def : "", size - 1);
+      buffer[size - 1] = '\0';
+      return static_cast<SceSize>(std::strlen(buffer));
+    }
+    return ini_index_gets(&index_, section, key, def, buffer, size);
+  }
+
+  bool has_key(const char *section, const char *key) { return open_ && ini_index_haskey(&index_, section, key); }
+
+  std::string_view section(int idx)
+  {
+    return std::string_view(buffer_, open_ ? ini_index_getsection(&index_, idx, buffer_, sizeof(buffer_)) : 0);
+  }
+
+  std::string_view key(const char *section, int idx)
+  {
+    return std::string_view(buffer_, open_ ? ini_index_getkey(&index_, section, idx, buffer_, sizeof(buffer_)) : 0);
+  }
+
+  /* The idx-th section in the subtree of a dotted section name */
+  std::string_view subsection(const char *section, int idx)
+  {
+    return std::string_view(buffer_, open_ ? ini_index_getsubsection(&index_, section, idx, buffer_, sizeof(buffer_)) : 0);
+  }
+
+  /* The value, from the nearest parent section when it is not in the section */
+  std::string_view gets_inherit(const char *section, const char *key, const char *def = "")
+  {
+    if (!open_)
+      return gets(section, key, def);
+    return std::string_view(buffer_, ini_index_gets_inherit(&index_, section, key, def, buffer_, sizeof(buffer_)));
+  }
+
+#if !INI_READONLY
+  bool put(const char *section, const char *key, const char *value)
+  {
+    if (!open_)
+      return false;
+    bool ok = ini_index_puts(&index_, section, key, value);
+    open_ = index_.filename != nullptr;   // a case-sensitive index that failed to reopen is closed
+    return ok;
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+  bool put(const char *section, const char *key, T value)
+  {
+    return put(section, key, detail::to_text(value, buffer_, sizeof(buffer_)));
+  }
+#endif
+
+private:
+  void close()
+  {
+    if (open_)
+      ini_index_close(&index_);
+    open_ = false;
+  }
+
+  INI_INDEX index_{};
+  bool open_ = false;
+};
+#endif /* INI_LAZYINDEX */
+
+#if INI_VERSIONS
+/* An INI file parsed into memory, with undo/redo (ini_doc_open()); closed
+ * when the handle is destroyed. With a memory resource, the document and its
+ * whole history are allocated from it, else from ini_malloc(). A document
+ * that is loaded and dropped per level fits a monotonic_buffer_resource on a
+ * static buffer, which is released in one step afterwards:
+ *
+ *   std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+ *   {
+ *     minIni::Document level("level3.ini", &arena);
+ *     ...
+ *   }
+ *   arena.release();
+ */
+class Document : public Getters<Document> {
+public:
+  explicit Document(const char *filename, std::pmr::memory_resource *resource = nullptr)
+  {
+    if (resource != nullptr) {
+      INI_ALLOCATOR allocator = detail::allocator(resource);
+      open_ = ini_doc_open_alloc(&doc_, filename, &allocator);
+    } else {
+      open_ = ini_doc_open(&doc_, filename);
+    }
+  }
+  Document(Document &&other) noexcept : Getters<Document>(std::move(other)), doc_(other.doc_), open_(other.open_)
+  {
+    other.open_ = false;
+  }
+  Document &operator=(Document &&other) noexcept
+  {
+    if (this != &other) {
+      close();
+      Getters<Document>::operator=(std::move(other));
+      doc_ = other.doc_;
+      open_ = other.open_;
+      other.open_ = false;
+    }
+    return *this;
+  }
+  ~Document() { close(); }
+
+  bool is_open() const { return open_; }
+  INI_DOC *handle() { return &doc_; }
+  std::pmr::memory_resource *resource() const
+  {
+    return static_cast<std::pmr::memory_resource *>(doc_.allocator.context);
+  }
+
+  SceSize lookup(const char *section, const char *key, const char *def, char *buffer, SceSize size)
+  {
+    if (!open_) {
+      std::strncpy(buffer, def != nullptr ? def : "", size - 1);
+      buffer[size - 1] = '\0';
+      return static_cast<SceSize>(std::strlen(buffer));
+    }
+    return ini_doc_gets(&doc_, section, key, def, buffer, size);
+  }
+
+  bool has_key(const char *section, const char *key)
+  {
+    /* no value can be equal to both defaults */
+    char probe[2];
+    return open_ && (ini_doc_gets(&doc_, section, key, "a", probe, sizeof(probe)) != 1 || probe[0] != 'a'
+                     || ini_doc_gets(&doc_, section, key, "b", probe, sizeof(probe)) != 1 || probe[0] != 'b');
+  }
+
+  std::string_view section(int idx)
+  {
+    return std::string_view(buffer_, open_ ? ini_doc_getsection(&doc_, idx, buffer_, sizeof(buffer_)) : 0);
+  }
+
+  std::string_view key(const char *section, int idx)
+  {
+    return std::string_view(buffer_, open_ ? ini_doc_getkey(&doc_, section, idx, buffer_, sizeof(buffer_)) : 0);
+  }
+
+  bool put(const char *section, const char *key, const char *value)
+  {
+    return open_ && ini_doc_puts(&doc_, section, key, value);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+  bool put(const char *section, const char *key, T value)
+  {
+    return put(section, key, detail::to_text(value, buffer_, sizeof(buffer_)));
+  }
+
+  bool undo() { return open_ && ini_doc_undo(&doc_); }
+  bool redo() { return open_ && ini_doc_redo(&doc_); }
+  bool set_version(int version) { return open_ && ini_doc_setversion(&doc_, version); }
+  void set_case_sensitive(bool exact) { ini_doc_setcase(&doc_, exact ? INI_TRUE : INI_FALSE); }
+#if !INI_READONLY
+  bool save() { return open_ && ini_doc_save(&doc_); }
+#endif
+
+private:
+  void close()
+  {
+    if (open_)
+      ini_doc_close(&doc_);
+    open_ = false;
+  }
+
+  INI_DOC doc_{};
+  bool open_ = false;
+};
+#endif /* INI_VERSIONS */
+
+#if INI_IMAGE
+/* A view on an image made by ini_image_publish(); the image memory is owned
+ * by the caller */
+class ImageView : public Getters<ImageView> {
+public:
+  ImageView(const void *image, SceSize size) : image_(image), size_(size) {}
+  ImageView(ImageView &&) = default;
+  ImageView &operator=(ImageView &&) = default;
+
+  SceUInt32 generation() const { return ini_image_generation(image_); }
+
+  SceSize lookup(const char *section, const char *key, const char *def, char *buffer, SceSize size)
+  {
+    return ini_image_gets(image_, size_, section, key, def, buffer, size);
+  }
+
+  bool has_key(const char *section, const char *key)
+  {
+    return ini_image_find(image_, size_, section, key, nullptr, nullptr) != nullptr;
+  }
+
+private:
+  const void *image_;
+  SceSize size_;
+};
+#endif /* INI_IMAGE */
+
+#if __cplusplus >= 202002L
+/* The dialect of a StaticIni, as template parameters; the default is the
+ * dialect that the C library was configured with (INI_COLONDELIM,
+ * INI_HASHCOMMENT, INI_QUOTES and INI_CASESENSITIVE) */
+template <bool Colon = INI_COLONDELIM, bool HashComment = INI_HASHCOMMENT, bool Quotes = INI_QUOTES,
+          bool CaseSensitive = INI_CASESENSITIVE>
+struct Dialect {
+  static constexpr bool colon = Colon;
+  static constexpr bool hash_comment = HashComment;
+  static constexpr bool quotes = Quotes;
+  static constexpr bool case_sensitive = CaseSensitive;
+};
+
+/* '=' only, ';' only, no quotes, case-sensitive names */
+using MinimalDialect = Dialect<false, false, false, true>;
+
+namespace detail {
+
+/* skipleading() and the case folding of strnicmp() and ini_hash() in
+ * minIni.c, usable at compile time */
+constexpr bool is_blank(char c) { return '\0' < c && c <= ' '; }
+
+template <class D>
+constexpr char fold(char c)
+{
+  if constexpr (D::case_sensitive)
+    return c;
+  else
+    return ('a' <= c && c <= 'z') ? static_cast<char>(c + ('A' - 'a')) : c;
+}
+
+template <class D>
+constexpr bool is_comment(char c)
+{
+  return c == ';' || (D::hash_comment && c == '#');
+}
+
+template <class D>
+constexpr bool same_name(std::string_view a, std::string_view b)
+{
+  if (a.size() != b.size())
+    return false;
+  for (std::size_t i = 0; i < a.size(); i++)
+    if (fold<D>(a[i]) != fold<D>(b[i]))
+      return false;
+  return true;
+}
+
+/* FNV-1a over the case-folded name, like ini_hash() */
+template <class D>
+constexpr SceUInt32 name_hash(std::string_view name, SceUInt32 hash = 2166136261u)
+{
+  for (char c : name)
+    hash = (hash ^ static_cast<SceUInt32>(static_cast<unsigned char>(fold<D>(c)))) * 16777619u;
+  return hash;
+}
+
+/* The hash of a section and a key, with a zero byte in between */
+template <class D>
+constexpr SceUInt32 key_hash(std::string_view section, std::string_view key)
+{
+  return name_hash<D>(key, (name_hash<D>(section) ^ 0u) * 16777619u);
+}
+
+/* The end of the line that starts at pos, as ini_read() returns it: up to
+ * and including the line terminator, at most INI_BUFFERSIZE - 1 bytes */
+constexpr std::size_t line_end(std::string_view text, std::size_t pos)
+{
+  std::size_t end = pos;
+  while (end < text.size() && end - pos < INI_BUFFERSIZE - 1)
+    if (text[end++] == INI_LINETERMCHAR)
+      break;
+  return end;
+}
+
+/* A line, classified the way getkeystring() and cleanstring() do */
+struct StaticLine {
+  enum Kind { OTHER, SECTION, BREAK, KEY } kind = OTHER;  /* BREAK: '[' without ']' */
+  std::string_view name;    /* the section or the key */
+  std::string_view value;   /* without comment and blanks, quotes still in */
+  bool quoted = false;      /* the value was between double quotes */
+};
+
+template <class D>
+constexpr StaticLine parse_line(std::string_view line)
+{
+  StaticLine result;
+  std::size_t sp = 0, ep;
+  while (sp < line.size() && is_blank(line[sp]))
+    sp++;
+  if (sp < line.size() && line[sp] == '[') {
+    ep = line.rfind(']');
+    if (ep == std::string_view::npos || ep < sp) {
+      result.kind = StaticLine::BREAK;
+      return result;
+    }
+    sp++;
+    while (sp < ep && is_blank(line[sp]))
+      sp++;
+    while (ep > sp && is_blank(line[ep - 1]))
+      ep--;
+    result.kind = StaticLine::SECTION;
+    result.name = line.substr(sp, ep - sp);
+    return result;
+  }
+  if (sp >= line.size() || is_comment<D>(line[sp]))
+    return result;
+  ep = line.find('=', sp);
+  if (D::colon && ep == std::string_view::npos)
+    ep = line.find(':', sp);
+  if (ep == std::string_view::npos)
+    return result;
+  result.kind = StaticLine::KEY;
+  std::size_t kp = ep;
+  while (kp > sp && is_blank(line[kp - 1]))
+    kp--;
+  result.name = line.substr(sp, kp - sp);
+
+  /* the value: skip leading blanks, cut a trailing comment (outside quotes),
+   * strip trailing blanks, then remove surrounding quotes */
+  std::size_t vp = ep + 1;
+  while (vp < line.size() && is_blank(line[vp]))
+    vp++;
+  bool isstring = false;
+  std::size_t vq = vp;
+  for (; vq < line.size() && (!is_comment<D>(line[vq]) || isstring); vq++) {
+    if (!D::quotes)
+      continue;
+    bool next_quote = vq + 1 < line.size() && line[vq + 1] == '"';
+    if (line[vq] == '"') {
+      if (next_quote)
+        vq++;
+      else
+        isstring = !isstring;
+    } else if (line[vq] == '\\' && next_quote) {
+      vq++;
+    }
+  }
+  if (vq > line.size())
+    vq = line.size();
+  while (vq > vp && is_blank(line[vq - 1]))
+    vq--;
+  if (D::quotes && vq > vp && line[vp] == '"' && line[vq - 1] == '"') {
+    result.quoted = true;
+    vp++;
+    vq = (vq - 1 > vp) ? vq - 1 : vp;
+  }
+  result.value = line.substr(vp, vq - vp);
+  return result;
+}
+
+/* The number of lines of the kind in the text */
+template <class D, std::size_t N>
+constexpr std::size_t count_lines(const char (&text)[N], StaticLine::Kind kind)
+{
+  std::string_view view(text, N - 1);
+  std::size_t count = 0;
+  for (std::size_t pos = 0, end; pos < view.size(); pos = end) {
+    end = line_end(view, pos);
+    if (parse_line<D>(view.substr(pos, end - pos)).kind == kind)
+      count++;
+  }
+  return count;
+}
+
+} /* namespace detail */
+
+/* A section and key, hashed at compile time, for a lookup at run time that
+ * takes only a binary search on the hash and one name comparison */
+template <class D = Dialect<>>
+struct StaticKey {
+  consteval StaticKey(std::string_view sectionname, std::string_view keyname)
+    : hash(detail::key_hash<D>(sectionname, keyname)), section(sectionname), key(keyname) {}
+  SceUInt32 hash;
+  std::string_view section;
+  std::string_view key;
+};
+
+/* An INI file in a string literal, parsed at compile time into a table that
+ * is sorted on the hashes of the section and key names. The lookups follow
+ * ini_gets(): only the first section with a name is searched, the first key
+ * with a name is found, the section "" holds the keys above the first
+ * section, a quoted value is returned without its quotes and escapes, and
+ * a line longer than INI_BUFFERSIZE is split the way ini_read() splits it.
+ * Create it with INI_STATIC():
+ *
+ *   constexpr auto defaults = INI_STATIC("[net]\nport=8080\n");
+ *   static_assert(defaults.gets("net", "port") == "8080");
+ */
+template <std::size_t Keys, std::size_t Sections, std::size_t Size, class D = Dialect<>>
+class StaticIni {
+public:
+  consteval explicit StaticIni(const char (&text)[Size])
+  {
+    std::string_view view(text, Size - 1);
+    std::array<Span, (Sections > 0) ? Sections : 1> seen{};
+    std::size_t nseen = 0, first = 0;
+    Span section{};
+    bool active = true;   /* the keys above the first section are in section "" */
+
+    for (std::size_t pos = 0, end; pos < view.size(); pos = end) {
+      end = detail::line_end(view, pos);
+      detail::StaticLine line = detail::parse_line<D>(view.substr(pos, end - pos));
+      if (line.kind == detail::StaticLine::BREAK) {
+        active = false;
+      } else if (line.kind == detail::StaticLine::SECTION) {
+        /* an unnamed section and a repeated section are never searched */
+        active = !line.name.empty();
+        for (std::size_t i = 0; active && i < nseen; i++)
+          active = !detail::same_name<D>(str(seen[i]), line.name);
+        if (active) {
+          section = store(line.name, false);
+          seen[nseen++] = section;
+          first = count_;
+        }
+      } else if (line.kind == detail::StaticLine::KEY && active && !line.name.empty()) {
+        bool repeated = false;
+        for (std::size_t i = first; !repeated && i < count_; i++)
+          repeated = detail::same_name<D>(str(entries_[i].key), line.name);
+        if (!repeated) {
+          Entry &entry = entries_[count_++];
+          entry.section = section;
+          entry.key = store(line.name, false);
+          entry.value = store(line.value, line.quoted);
+          entry.hash = detail::key_hash<D>(str(section), line.name);
+        }
+      }
+    }
+    std::sort(entries_.begin(), entries_.begin() + count_,
+              [](const Entry &a, const Entry &b) { return a.hash < b.hash; });
+  }
+
+  /* The number of keys that a lookup can find */
+  constexpr std::size_t size() const { return count_; }
+
+  constexpr std::string_view gets(std::string_view section, std::string_view key, std::string_view def = {}) const
+  {
+    return find(detail::key_hash<D>(section, key), section, key, def);
+  }
+
+  constexpr std::string_view gets(const StaticKey<D> &name, std::string_view def = {}) const
+  {
+    return find(name.hash, name.section, name.key, def);
+  }
+
+  constexpr bool has_key(std::string_view section, std::string_view key) const
+  {
+    return find(detail::key_hash<D>(section, key), section, key, {}).data() != nullptr;
+  }
+
+private:
+  struct Span {
+    SceSize offset = 0;
+    SceSize size = 0;
+  };
+
+  struct Entry {
+    SceUInt32 hash = 0;
+    Span section, key, value;
+  };
+
+  constexpr std::string_view str(Span span) const
+  {
+    return std::string_view(strings_.data() + span.offset, span.size);
+  }
+
+  /* Copy a name or a value into the string pool; the names and values
+   * together are never longer than the text they were parsed from */
+  consteval Span store(std::string_view text, bool dequote)
+  {
+    Span span{static_cast<SceSize>(used_), 0};
+    for (std::size_t s = 0; s < text.size(); s++) {
+      if (dequote && (text[s] == '"' || text[s] == '\\') && s + 1 < text.size() && text[s + 1] == '"')
+        s++;
+      strings_[used_++] = text[s];
+    }
+    span.size = static_cast<SceSize>(used_ - span.offset);
+    return span;
+  }
+
+  constexpr std::string_view find(SceUInt32 hash, std::string_view section, std::string_view key,
+                                  std::string_view def) const
+  {
+    std::size_t lo = 0, hi = count_;
+    while (lo < hi) {
+      std::size_t mid = lo + (hi - lo) / 2;
+      if (entries_[mid].hash < hash)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    for (; lo < count_ && entries_[lo].hash == hash; lo++)
+      if (detail::same_name<D>(str(entries_[lo].key), key) && detail::same_name<D>(str(entries_[lo].section), section))
+        return str(entries_[lo].value);
+    return def;
+  }
+
+  std::array<Entry, Keys> entries_{};
+  std::size_t count_ = 0;
+  std::array<char, Size> strings_{};
+  std::size_t used_ = 0;
+};
+
+/* An INI file in a string literal, parsed at compile time, in the default
+ * dialect or in the given one */
+#define INI_STATIC(text)  INI_STATIC_DIALECT(text, ::minIni::Dialect<>)
+#define INI_STATIC_DIALECT(text, dialect)                                       \
+  (::minIni::StaticIni<::minIni::detail::count_lines<dialect>((text), ::minIni::detail::StaticLine::KEY), \
+                       ::minIni::detail::count_lines<dialect>((text), ::minIni::detail::StaticLine::SECTION), \
+                       sizeof(text), dialect>(text))
+#endif /* __cplusplus >= 202002L */
+
+#if defined(MININI_COROUTINES)
+/* Asynchronous loading: the file I/O runs on an executor, and the coroutine
+ * that awaits it continues on the executor's thread. An executor is any type
+ * with a post() that runs fn(arg) at some later point, on some thread:
+ *
+ *   auto doc = co_await minIni::load_async<minIni::Document>(pool, "level.ini");
+ *
+ *   minIni::AsyncEntries entries(pool, "level.ini");
+ *   while (co_await entries.next())
+ *     use(entries.section(), entries.key(), entries.value());
+ */
+template <class E>
+concept Executor = requires(E &executor, void (*fn)(void *), void *arg) { executor.post(fn, arg); };
+
+/* Runs a job at once, on the calling thread */
+struct InlineExecutor {
+  void post(void (*fn)(void *), void *arg) { fn(arg); }
+};
+
+#if defined(MININI_THREADPOOL)
+/* A stand-in for the platform's I/O threads on the host: a fixed set of
+ * std::threads that run the posted jobs in order */
+class ThreadPool {
+public:
+  explicit ThreadPool(unsigned threads = 1)
+  {
+    for (unsigned i = 0; i < threads; i++)
+      threads_.emplace_back([this] { run(); });
+  }
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    ready_.notify_all();
+    for (auto &thread : threads_)
+      thread.join();
+  }
+
+  void post(void (*fn)(void *), void *arg)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.push_back({fn, arg});
+    }
+    ready_.notify_one();
+  }
+
+private:
+  struct Job {
+    void (*fn)(void *);
+    void *arg;
+  };
+
+  /* the jobs that were posted before the pool is destroyed are all run */
+  void run()
+  {
+    for (;;) {
+      Job job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+        if (jobs_.empty())
+          return;
+        job = jobs_.front();
+        jobs_.pop_front();
+      }
+      job.fn(job.arg);
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<Job> jobs_;
+  std::vector<std::thread> threads_;
+  bool stop_ = false;
+};
+#endif /* MININI_THREADPOOL */
+
+/* The awaitable of load_async(): opens the handle on the executor */
+template <class Handle, Executor E>
+class LoadAwaiter {
+public:
+  LoadAwaiter(E &executor, const char *filename) : executor_(executor)
+  {
+    std::strncpy(filename_, filename, sizeof(filename_) - 1);
+    filename_[sizeof(filename_) - 1] = '\0';
+  }
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> waiter)
+  {
+    waiter_ = waiter;
+    /* the coroutine may resume (and destroy this awaiter) inside post() */
+    executor_.post(&LoadAwaiter::load, this);
+  }
+  Handle await_resume() { return std::move(*handle_); }
+
+private:
+  static void load(void *arg)
+  {
+    LoadAwaiter *self = static_cast<LoadAwaiter *>(arg);
+    self->handle_.emplace(self->filename_);
+    self->waiter_.resume();
+  }
+
+  E &executor_;
+  char filename_[INI_BUFFERSIZE];
+  std::coroutine_handle<> waiter_;
+  std::optional<Handle> handle_;
+};
+
+/* Open a File, Index or Document on the executor; co_await gives the handle */
+template <class Handle, Executor E>
+LoadAwaiter<Handle, E> load_async(E &executor, const char *filename)
+{
+  return LoadAwaiter<Handle, E>(executor, filename);
+}
+
+#if INI_BROWSE
+/* The settings of an INI file, read one at a time on the executor; the
+ * strings are valid until the next call to next() */
+template <Executor E>
+class AsyncEntries {
+public:
+  class NextAwaiter {
+  public:
+    explicit NextAwaiter(AsyncEntries &entries) : entries_(entries) {}
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> waiter)
+    {
+      entries_.waiter_ = waiter;
+      entries_.executor_.post(&AsyncEntries::read, &entries_);
+    }
+    bool await_resume() const { return entries_.found_; }
+
+  private:
+    AsyncEntries &entries_;
+  };
+
+  AsyncEntries(E &executor, const char *filename) : executor_(executor)
+  {
+    std::strncpy(filename_, filename, sizeof(filename_) - 1);
+    filename_[sizeof(filename_) - 1] = '\0';
+  }
+  AsyncEntries(const AsyncEntries &) = delete;
+  AsyncEntries &operator=(const AsyncEntries &) = delete;
+  ~AsyncEntries()
+  {
+    if (open_)
+      ini_reader_close(&reader_);
+  }
+
+  /* co_await next() reads up to the next setting; false at the end */
+  NextAwaiter next() { return NextAwaiter(*this); }
+
+  std::string_view section() const { return std::string_view(event_.section.ptr, event_.section.len); }
+  std::string_view key() const { return std::string_view(event_.key.ptr, event_.key.len); }
+  std::string_view value() const { return std::string_view(event_.value.ptr, event_.value.len); }
+
+private:
+  static void read(void *arg)
+  {
+    AsyncEntries *self = static_cast<AsyncEntries *>(arg);
+    if (!self->started_) {
+      self->started_ = true;
+      self->open_ = ini_reader_open(&self->reader_, self->filename_);
+    }
+    self->found_ = false;
+    if (self->open_) {
+      int type;
+      while ((type = ini_next(&self->reader_, &self->event_)) != INI_EVENT_EOF && type != INI_EVENT_KEY)
+        continue;
+      self->found_ = (type == INI_EVENT_KEY);
+    }
+    self->waiter_.resume();
+  }
+
+  E &executor_;
+  char filename_[INI_BUFFERSIZE];
+  INI_READER reader_{};
+  INI_EVENT event_{INI_EVENT_EOF, {"", 0}, {"", 0}, {"", 0}};
+  std::coroutine_handle<> waiter_;
+  bool started_ = false;
+  bool open_ = false;
+  bool found_ = false;
+};
+#endif /* INI_BROWSE */
+#endif /* MININI_COROUTINES */
+
+} /* namespace minIni */
+
+#endif /* MININI_HPP */
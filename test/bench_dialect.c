@@ -0,0 +1,85 @@
+/*  Benchmark of the parser dialect: the same lookups and passes over a file,
+ *  and the same file parsed from memory (which leaves out the file I/O), in
+ *  the dialect that this build has. The benchmark is built in the full
+ *  dialect (bench_dialect) and in the minimal one (bench_dialect_minimal),
+ *  so that the two can be compared.
+ *
+ *  Usage: bench_dialect [rounds]     (default 20)
+ */
+#include <sys/time.h>
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "bench_dialect.ini";
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec + (double)tv.tv_usec / 1e6;
+}
+
+static int callback(const char *Section, const char *Key, const char *Value, void *UserData)
+{
+  (void)Section;
+  (void)Key;
+  *(long *)UserData += Value[0];
+  return 1;
+}
+
+int main(int argc, char *argv[])
+{
+  int rounds = (argc > 1) ? atoi(argv[1]) : 20;
+  char buffer[64], section[32], key[32];
+  double t, lookups, browse, feed;
+  INI_PARSER parser;
+  char *text;
+  SceSize size;
+  long sum = 0;
+  FILE *fp;
+  int s, k, i;
+
+  /* a file in the minimal dialect, so that both builds read the same data */
+  fp = fopen(ini, "wb");
+  for (s = 0; s < 100; s++) {
+    fprintf(fp, "[section%d]\n", s);
+    for (k = 0; k < 50; k++)
+      fprintf(fp, "key_number_%d = value %d of section %d ; comment\n", k, k, s);
+  }
+  fclose(fp);
+
+  t = now();
+  for (i = 0; i < 40 * rounds; i++) {
+    sprintf(section, "section%d", (i * 7) % 100);
+    sprintf(key, "key_number_%d", (i * 13) % 50);
+    CHECK(ini_gets(section, key, "", buffer, sizeof(buffer), ini) > 0);
+  }
+  lookups = (now() - t) * 1e6 / (40 * rounds);
+  t = now();
+  for (i = 0; i < rounds; i++)
+    ini_browse(callback, &sum, ini);
+  browse = (now() - t) * 1e3 / rounds;
+  fp = fopen(ini, "rb");
+  fseek(fp, 0, SEEK_END);
+  size = (SceSize)ftell(fp);
+  rewind(fp);
+  text = malloc(size);
+  CHECK(fread(text, 1, size, fp) == size);
+  fclose(fp);
+  t = now();
+  for (i = 0; i < 10 * rounds; i++) {
+    ini_parser_init(&parser, callback, &sum);
+    CHECK(ini_feed(&parser, text, size) && ini_feed_end(&parser));
+  }
+  feed = (double)size * 10 * rounds / (now() - t) / (1 << 20);
+  free(text);
+
+  printf("%s dialect (colon %d, hash %d, quotes %d, case-sensitive %d):\n",
+         (INI_COLONDELIM || INI_HASHCOMMENT || INI_QUOTES || !INI_CASESENSITIVE) ? "full" : "minimal",
+         INI_COLONDELIM, INI_HASHCOMMENT, INI_QUOTES, INI_CASESENSITIVE);
+  printf("  ini_gets:   %8.1f us per lookup\n", lookups);
+  printf("  ini_browse: %8.2f ms per pass\n", browse);
+  printf("  ini_feed:   %8.1f MiB/s (%ld)\n", feed, sum);
+
+  TEST_END(argv[0]);
+}
@@ -0,0 +1,95 @@
+/*  Benchmark for files above 2 GiB (and above 4 GiB, with a larger size)
+ *
+ *  Usage: bench_largefile [size in MiB]     (default 3072)
+ *
+ *  A file of the requested size is generated (once; it is kept for the next
+ *  run), with a section "Last" at its end. The benchmark times indexing the
+ *  section headers, a lookup through the index, a full scan with ini_gets()
+ *  and appending a key to the last section, and it checks that all of them
+ *  see the data behind the 2 GiB mark.
+ */
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "bench_largefile.ini";
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec + (double)tv.tv_usec / 1e6;
+}
+
+static void generate(long long size)
+{
+  char line[128];
+  long long written = 0;
+  unsigned s = 0, k;
+  FILE *fp;
+  struct stat st;
+
+  if (stat(ini, &st) == 0 && (long long)st.st_size >= size && (long long)st.st_size < size + (1 << 20))
+    return;   /* generated by a previous run */
+  printf("generating %lld MiB...\n", size >> 20);
+  fp = fopen(ini, "wb");
+  if (fp == NULL) {
+    perror(ini);
+    exit(2);
+  }
+  setvbuf(fp, NULL, _IOFBF, 1 << 20);
+  while (written < size) {
+    written += fprintf(fp, "[Section%u]\n", s);
+    for (k = 0; k < 16; k++) {
+      snprintf(line, sizeof(line), "key%02u = value %u/%u, padded to make the line about one hundred bytes long\n", k, s, k);
+      written += (long long)strlen(line);
+      fputs(line, fp);
+    }
+    s++;
+  }
+  fputs("[Last]\nanswer = 42\n", fp);
+  fclose(fp);
+}
+
+int main(int argc, char *argv[])
+{
+  long long size = ((argc > 1) ? atoll(argv[1]) : 3072) << 20;
+  char buffer[64];
+  double t, mib;
+  struct stat st;
+#if INI_LAZYINDEX
+  INI_INDEX index;
+#endif
+
+  generate(size);
+  stat(ini, &st);
+  mib = (double)st.st_size / (1 << 20);
+  printf("file: %.0f MiB\n", mib);
+
+#if INI_LAZYINDEX
+  t = now();
+  CHECK(ini_index_open(&index, ini));
+  t = now() - t;
+  printf("index the headers:      %8.3f s  %8.1f MiB/s  (%d sections)\n", t, mib / t, index.count);
+  CHECK(index.sections[index.count - 1].start > ((SceOff)1 << 31));
+  t = now();
+  CHECK(ini_index_gets(&index, "Last", "answer", "", buffer, sizeof(buffer)) == 2 && strcmp(buffer, "42") == 0);
+  printf("lookup in the index:    %8.6f s\n", now() - t);
+  ini_index_close(&index);
+#endif
+
+  t = now();
+  CHECK_GETS("Last", "answer", "42", ini);
+  t = now() - t;
+  printf("ini_gets (full scan):   %8.3f s  %8.1f MiB/s\n", t, mib / t);
+
+  t = now();
+  CHECK(ini_puts("Last", "appended", "yes", ini));
+  printf("ini_puts (append):      %8.3f s  (scans for the section, does not copy)\n", now() - t);
+  CHECK_GETS("Last", "appended", "yes", ini);
+  CHECK(truncate(ini, st.st_size) == 0);     /* keep the file for the next run */
+
+  TEST_END(argv[0]);
+}
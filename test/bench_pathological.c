@@ -0,0 +1,112 @@
+/*  Benchmark on pathological input: the time per byte must not grow with the
+ *  size of the file
+ *
+ *  Usage: bench_pathological [size in KiB]     (default 1024)
+ *
+ *  Every corpus is generated at the requested size and at four times that
+ *  size. For each, the benchmark times a lookup that scans the whole file,
+ *  a write that copies the whole file, and enumerating all sections (with
+ *  the cursor, see INI_ENUMCURSOR), and it prints the time per byte at both
+ *  sizes. With linear parsing, the ratio stays near 1.
+ */
+#include <sys/time.h>
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "bench_pathological.ini";
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec + (double)tv.tv_usec / 1e6;
+}
+
+/* Fill the file up to the size with the pattern, and end with a section
+   that the lookups do not find */
+static long generate(const char *pattern, int patternlen, long size)
+{
+  FILE *fp = fopen(ini, "wb");
+  long written = 0;
+
+  if (fp == NULL) {
+    perror(ini);
+    exit(2);
+  }
+  setvbuf(fp, NULL, _IOFBF, 1 << 20);
+  while (written < size)
+    written += (long)fwrite(pattern, 1, patternlen, fp);
+  written += fprintf(fp, "\n[Last]\nanswer=42\n");
+  fclose(fp);
+  return written;
+}
+
+/* Time the operations on a corpus; the results are in ns per byte */
+static void measure(const char *pattern, int patternlen, long size, double result[3])
+{
+  char buffer[64];
+  double t;
+  long bytes;
+  int n;
+
+  bytes = generate(pattern, patternlen, size);
+  t = now();
+  ini_gets("None", "key", "", buffer, sizeof(buffer), ini);
+  result[0] = (now() - t) * 1e9 / bytes;
+  CHECK_GETS("Last", "answer", "42", ini);
+
+  t = now();
+  CHECK(ini_puts("Last", "answer", "43", ini));
+  result[1] = (now() - t) * 1e9 / bytes;
+
+  t = now();
+  for (n = 0; ini_getsection(n, buffer, sizeof(buffer), ini) > 0; n++)
+    {}
+  result[2] = (now() - t) * 1e9 / bytes;
+}
+
+static void corpus(const char *name, const char *pattern, int patternlen, long size)
+{
+  static const char *ops[3] = { "lookup", "rewrite", "enumerate" };
+  double small[3], large[3];
+  int i;
+
+  measure(pattern, patternlen, size, small);
+  measure(pattern, patternlen, 4 * size, large);
+  for (i = 0; i < 3; i++)
+    printf("%-22s %-10s %8.2f ns/byte %8.2f ns/byte  x%.2f\n", (i == 0) ? name : "", ops[i],
+           small[i], large[i], large[i] / small[i]);
+}
+
+int main(int argc, char *argv[])
+{
+  long size = ((argc > 1) ? atol(argv[1]) : 1024) * 1024;
+  char *pattern;
+  int i;
+
+  printf("%-22s %-10s %16s %16s\n", "corpus", "", "size", "4 x size");
+  corpus("one-character lines", "x\n", 2, size);
+  corpus("one-character sections", "[a]\n", 4, size);
+  corpus("short sections", "[s]\nk=v\n", 8, size);
+  corpus("NUL bytes", "k=\0\0\0\n\0\0[\0]\n", 12, size);
+
+  /* a line far longer than INI_BUFFERSIZE, without a line end */
+  pattern = malloc(size);
+  memset(pattern, 'x', size);
+  corpus("one unterminated line", pattern, (int)size, size);
+
+  /* quotes with escaped quotes in them, longer than INI_BUFFERSIZE */
+  pattern[0] = 'k';
+  pattern[1] = '=';
+  pattern[2] = '"';
+  for (i = 3; i < 3 * 1024 - 2; i += 2) {
+    pattern[i] = '\\';
+    pattern[i + 1] = '"';
+  }
+  pattern[i++] = '"';
+  pattern[i++] = '\n';
+  corpus("escaped quotes", pattern, i, size);
+  free(pattern);
+
+  TEST_END(argv[0]);
+}
@@ -0,0 +1,109 @@
+/*  Host stand-in for the PSPSDK <pspiofilemgr.h>, for the minIni tests
+ *
+ *  The sceIo functions that minIni uses, mapped to POSIX. This file is in the
+ *  public domain.
+ */
+#ifndef PSPIOFILEMGR_H
+#define PSPIOFILEMGR_H
+
+#include "psptypes.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define PSP_O_RDONLY  O_RDONLY
+#define PSP_O_WRONLY  O_WRONLY
+#define PSP_O_RDWR    O_RDWR
+#define PSP_O_APPEND  O_APPEND
+#define PSP_O_CREAT   O_CREAT
+#define PSP_O_TRUNC   O_TRUNC
+#define PSP_O_EXCL    O_EXCL
+
+#define PSP_SEEK_SET  SEEK_SET
+#define PSP_SEEK_CUR  SEEK_CUR
+#define PSP_SEEK_END  SEEK_END
+
+typedef struct ScePspDateTime {
+  unsigned short  year, month, day, hour, minute, second;
+  unsigned int    microsecond;
+} ScePspDateTime;
+
+typedef struct SceIoStat {
+  SceMode         st_mode;
+  unsigned int    st_attr;
+  SceOff          st_size;
+  ScePspDateTime  sce_st_ctime;
+  ScePspDateTime  sce_st_atime;
+  ScePspDateTime  sce_st_mtime;
+  unsigned int    st_private[6];
+} SceIoStat;
+
+static inline SceUID sceIoOpen(const char *file, int flags, SceMode mode)
+{
+  return open(file, flags, mode);
+}
+
+static inline int sceIoClose(SceUID fd)
+{
+  return close(fd);
+}
+
+static inline int sceIoRead(SceUID fd, void *data, SceSize size)
+{
+  return (int)read(fd, data, size);
+}
+
+static inline int sceIoWrite(SceUID fd, const void *data, SceSize size)
+{
+  return (int)write(fd, data, size);
+}
+
+static inline SceOff sceIoLseek(SceUID fd, SceOff offset, int whence)
+{
+  return lseek(fd, offset, whence);
+}
+
+static inline int sceIoRemove(const char *file)
+{
+  return unlink(file);
+}
+
+static inline int sceIoRename(const char *oldname, const char *newname)
+{
+  return rename(oldname, newname);
+}
+
+static inline int sceIoSync(const char *device, unsigned int flag)
+{
+  (void)device;
+  (void)flag;
+  sync();
+  return 0;
+}
+
+/* the PSP keeps the modification time with a resolution of 2 seconds (FAT),
+ * the stand-in keeps the full resolution of the host */
+static inline int sceIoGetstat(const char *file, SceIoStat *stat_)
+{
+  struct stat st;
+  struct tm tm;
+  if (stat(file, &st) < 0)
+    return -1;
+  memset(stat_, 0, sizeof(*stat_));
+  stat_->st_mode = (SceMode)st.st_mode;
+  stat_->st_size = st.st_size;
+  gmtime_r(&st.st_mtime, &tm);
+  stat_->sce_st_mtime.year = (unsigned short)(tm.tm_year + 1900);
+  stat_->sce_st_mtime.month = (unsigned short)(tm.tm_mon + 1);
+  stat_->sce_st_mtime.day = (unsigned short)tm.tm_mday;
+  stat_->sce_st_mtime.hour = (unsigned short)tm.tm_hour;
+  stat_->sce_st_mtime.minute = (unsigned short)tm.tm_min;
+  stat_->sce_st_mtime.second = (unsigned short)tm.tm_sec;
+  stat_->sce_st_mtime.microsecond = (unsigned int)(st.st_mtim.tv_nsec / 1000);
+  return 0;
+}
+
+#endif /* PSPIOFILEMGR_H */
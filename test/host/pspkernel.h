@@ -0,0 +1,32 @@
+/*  Host stand-in for the PSPSDK <pspkernel.h>, for the minIni tests
+ *
+ *  The kernel functions that minIni uses (time, thread id, delay), mapped to
+ *  POSIX. This file is in the public domain.
+ */
+#ifndef PSPKERNEL_H
+#define PSPKERNEL_H
+
+#include "psptypes.h"
+#include "pspiofilemgr.h"
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+static inline SceUInt64 sceKernelGetSystemTimeWide(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (SceUInt64)ts.tv_sec * 1000000u + (SceUInt64)ts.tv_nsec / 1000u;
+}
+
+static inline SceUID sceKernelGetThreadId(void)
+{
+  return (SceUID)syscall(SYS_gettid);
+}
+
+static inline int sceKernelDelayThread(SceUInt32 delay)
+{
+  return usleep(delay);
+}
+
+#endif /* PSPKERNEL_H */
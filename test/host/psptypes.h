@@ -0,0 +1,38 @@
+/*  Host stand-in for the PSPSDK <psptypes.h>, for the minIni tests
+ *
+ *  Only the types that minIni uses are declared, with the sizes that they
+ *  have on the PSP. This file is in the public domain.
+ */
+#ifndef PSPTYPES_H
+#define PSPTYPES_H
+
+#include <stdint.h>
+
+typedef uint8_t   u8;
+typedef uint16_t  u16;
+typedef uint32_t  u32;
+typedef uint64_t  u64;
+typedef int8_t    s8;
+typedef int16_t   s16;
+typedef int32_t   s32;
+typedef int64_t   s64;
+
+typedef int           SceInt;
+typedef unsigned int  SceUInt;
+typedef int32_t       SceInt32;
+typedef uint32_t      SceUInt32;
+typedef int64_t       SceInt64;
+typedef uint64_t      SceUInt64;
+typedef uint8_t       SceUChar;
+typedef int8_t        SceChar8;
+typedef uint8_t       SceUChar8;
+typedef int16_t       SceShort16;
+typedef uint16_t      SceUShort16;
+typedef int32_t       SceUID;
+typedef unsigned int  SceSize;
+typedef int           SceSSize;
+typedef int           SceBool;
+typedef int           SceMode;
+typedef int64_t       SceOff;
+
+#endif /* PSPTYPES_H */
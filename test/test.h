@@ -0,0 +1,68 @@
+/*  Helpers for the minIni host tests
+ *
+ *  Every test is a program that includes this file, runs its CHECK()s and
+ *  ends with TEST_END(argv[0]). The tests run in the build directory, and they
+ *  create their INI files there. This file is in the public domain.
+ */
+#ifndef MININI_TEST_H
+#define MININI_TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int test_failures;
+
+#define CHECK(expr) \
+  do { \
+    if (!(expr)) { \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+      test_failures++; \
+    } \
+  } while (0)
+
+#define TEST_END(name) \
+  do { \
+    printf("%s: %s\n", (name), test_failures == 0 ? "ok" : "FAILED"); \
+    return test_failures != 0; \
+  } while (0)
+
+/* Replace the contents of a file */
+static __attribute__((unused)) void test_writefile(const char *filename, const char *text)
+{
+  FILE *fp = fopen(filename, "wb");
+  if (fp == NULL) {
+    perror(filename);
+    exit(2);
+  }
+  fputs(text, fp);
+  fclose(fp);
+}
+
+/* Read a (small) file; the text stays valid until the next call */
+static __attribute__((unused)) const char *test_readfile(const char *filename)
+{
+  static char text[1 << 16];
+  size_t size = 0;
+  FILE *fp = fopen(filename, "rb");
+  if (fp != NULL) {
+    size = fread(text, 1, sizeof(text) - 1, fp);
+    fclose(fp);
+  }
+  text[size] = '\0';
+  return text;
+}
+
+/* Whether ini_gets() finds the expected value */
+#define CHECK_GETS(section, key, expected, filename) \
+  do { \
+    char value_[256]; \
+    ini_gets((section), (key), "<default>", value_, sizeof(value_), (filename)); \
+    if (strcmp(value_, (expected)) != 0) { \
+      printf("%s:%d: [%s] %s is \"%s\", expected \"%s\"\n", __FILE__, __LINE__, \
+             (section) != NULL ? (section) : "", (key), value_, (expected)); \
+      test_failures++; \
+    } \
+  } while (0)
+
+#endif /* MININI_TEST_H */
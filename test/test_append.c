@@ -0,0 +1,83 @@
+/*  Tests for adding keys at the end of the file (INI_FASTAPPEND), and for
+ *  the basic getters and ini_puts() that the other tests build on
+ */
+#include <sys/stat.h>
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_append.ini";
+
+static long inode(const char *filename)
+{
+  struct stat st;
+  return (stat(filename, &st) == 0) ? (long)st.st_ino : -1;
+}
+
+int main(int argc, char *argv[])
+{
+  char buffer[64];
+  long before;
+
+  test_writefile(ini, "top=1\n[A]\nx = 1\ny=\"q\\\"z\" ; c\n[B]\nk:v\n# c\n[C]\nm=n\n");
+  CHECK_GETS("A", "x", "1", ini);
+  CHECK_GETS("A", "y", "q\"z", ini);
+  CHECK_GETS("b", "K", "v", ini);
+  CHECK_GETS(NULL, "top", "1", ini);
+  CHECK_GETS("C", "none", "<default>", ini);
+  CHECK(ini_getsection(2, buffer, sizeof(buffer), ini) == 1 && strcmp(buffer, "C") == 0);
+  CHECK(ini_getkey("A", 1, buffer, sizeof(buffer), ini) == 1 && strcmp(buffer, "y") == 0);
+  CHECK(ini_haskey("C", "m", ini) && !ini_haskey("C", "x", ini) && ini_hassection("B", ini));
+
+  /* a key in a section in the middle of the file, a key in the last
+     section and a key in a new section */
+  CHECK(ini_puts("B", "new", "v2", ini));
+  CHECK(ini_puts("C", "last", "v3", ini));
+  CHECK(ini_puts("D", "miss", "v4", ini));
+  CHECK(ini_puts("D", "miss2", "v5", ini));
+  CHECK(strcmp(test_readfile(ini), "top=1\n[A]\nx = 1\ny=\"q\\\"z\" ; c\n[B]\nk:v\n# c\nnew = v2\n"
+                                   "[C]\nm=n\nlast = v3\n[D]\nmiss = v4\nmiss2 = v5\n") == 0);
+
+  /* appending to the last section or a new section does not copy the file */
+  test_writefile(ini, "[A]\nx=1\n[B]\ny=2\n");
+  before = inode(ini);
+  CHECK(ini_puts("B", "z", "3", ini));
+  CHECK(!INI_FASTAPPEND || inode(ini) == before);
+  CHECK(ini_puts("C", "z", "3", ini));
+  CHECK(!INI_FASTAPPEND || inode(ini) == before);
+  CHECK(strcmp(test_readfile(ini), "[A]\nx=1\n[B]\ny=2\nz = 3\n[C]\nz = 3\n") == 0);
+
+  /* a key that already exists is replaced, not appended */
+  CHECK(ini_puts("C", "z", "4", ini));
+  CHECK(strcmp(test_readfile(ini), "[A]\nx=1\n[B]\ny=2\nz = 3\n[C]\nz = 4\n") == 0);
+
+  /* the last line has no line terminator */
+  test_writefile(ini, "[A]\nx=1");
+  CHECK(ini_puts("A", "y", "2", ini));
+  CHECK(strcmp(test_readfile(ini), "[A]\nx=1\ny = 2\n") == 0);
+  CHECK(ini_puts("Z", "y", "2", ini));
+  CHECK(strcmp(test_readfile(ini), "[A]\nx=1\ny = 2\n[Z]\ny = 2\n") == 0);
+
+  /* keys above the first section, and a file that does not exist */
+  test_writefile(ini, "a=1\n");
+  CHECK(ini_puts(NULL, "b", "2", ini));
+  CHECK(strcmp(test_readfile(ini), "a=1\nb = 2\n") == 0);
+  remove(ini);
+  CHECK(ini_puts("S", "k", "v", ini));
+  CHECK(strcmp(test_readfile(ini), "[S]\nk = v\n") == 0);
+
+  /* deleting keys and sections */
+  test_writefile(ini, "[A]\nx=1\n[B]\nk=v\n[C]\nm=n\n");
+  CHECK(ini_puts("B", "k", NULL, ini) && !ini_haskey("B", "k", ini));
+  CHECK(ini_puts("B", NULL, NULL, ini) && !ini_hassection("B", ini));
+  CHECK_GETS("C", "m", "n", ini);
+
+  /* values are quoted for a trailing space and for '"', ';' and '#' only
+     (INI_CONTINUATION also quotes leading and trailing white space) */
+  test_writefile(ini, "[A]\n");
+  CHECK(ini_puts("A", "a", "sp ", ini) && ini_puts("A", "b", " lead", ini) && ini_puts("A", "c", "tab\t", ini));
+  CHECK(ini_puts("A", "d", "x;y", ini));
+  CHECK(strcmp(test_readfile(ini), "[A]\na = \"sp \"\nb =  lead\nc = tab\t\nd = \"x;y\"\n") == 0);
+
+  (void)argc;
+  TEST_END(argv[0]);
+}
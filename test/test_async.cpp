@@ -0,0 +1,70 @@
+/*  Tests for asynchronous loading: the coroutines get the same data on an
+ *  inline executor and on a thread pool
+ */
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "test.h"
+#include "minIni.hpp"
+
+static const char *ini = "test_async.ini";
+
+/* A coroutine that starts at once and is not awaited */
+struct Task {
+  struct promise_type {
+    Task get_return_object() { return {}; }
+    std::suspend_never initial_suspend() { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+static std::atomic<int> done{0};
+static std::string listing;
+
+template <class E>
+static Task load(E &executor)
+{
+  auto doc = co_await minIni::load_async<minIni::Document>(executor, ini);
+  CHECK(doc.is_open() && doc.gets("a", "x") == "1");
+  auto file = co_await minIni::load_async<minIni::File>(executor, ini);
+  CHECK(file.gets("b", "y") == "2");
+  minIni::AsyncEntries<E> reader(executor, ini);
+  std::string text;
+  while (co_await reader.next())
+    text += std::string(reader.section()) + "." + std::string(reader.key()) + "=" + std::string(reader.value()) + ";";
+  listing = text;
+  done++;
+}
+
+template <class E>
+static Task load_missing(E &executor)
+{
+  minIni::AsyncEntries<E> reader(executor, "test_async.none");
+  CHECK(!co_await reader.next());
+  done++;
+}
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  test_writefile(ini, "t=0\n[a]\nx=1\n;c\n[b]\ny=2\n");
+  minIni::InlineExecutor inline_executor;
+  load(inline_executor);
+  CHECK(done == 1 && listing == ".t=0;a.x=1;b.y=2;");
+  load_missing(inline_executor);
+  CHECK(done == 2);
+
+  listing.clear();
+  {
+    minIni::ThreadPool pool(2);
+    load(pool);
+    while (done < 3)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  CHECK(listing == ".t=0;a.x=1;b.y=2;");
+
+  TEST_END(argv[0]);
+}
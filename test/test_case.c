@@ -0,0 +1,63 @@
+/*  Tests for case-sensitive names in an index or a document (with the
+ *  library built case-insensitive)
+ */
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_case.ini";
+
+#define CHECK_VALUE(call, expected) \
+  do { \
+    char value_[64]; \
+    (void)(call); \
+    if (strcmp(value_, (expected)) != 0) { \
+      printf("%s:%d: value is \"%s\", expected \"%s\"\n", __FILE__, __LINE__, value_, (expected)); \
+      test_failures++; \
+    } \
+  } while (0)
+#define INDEX_GETS(section, key)  ini_index_gets(&index, (section), (key), "-", value_, sizeof(value_))
+#define DOC_GETS(section, key)    ini_doc_gets(&doc, (section), (key), "-", value_, sizeof(value_))
+
+int main(int argc, char *argv[])
+{
+  INI_INDEX index;
+  INI_DOC doc;
+
+  (void)argc;
+  test_writefile(ini, "[Net]\nHost=a\nhost=b\n[net]\nPort=1\n");
+  CHECK(ini_index_open(&index, ini));
+  CHECK_VALUE(INDEX_GETS("net", "HOST"), "a");
+  ini_index_setcase(&index, INI_TRUE);
+  CHECK_VALUE(INDEX_GETS("net", "HOST"), "-");
+  CHECK_VALUE(INDEX_GETS("Net", "host"), "b");
+  CHECK_VALUE(INDEX_GETS("net", "Port"), "1");    /* [net] is a section of its own now */
+  CHECK(ini_index_puts(&index, "Net", "Extra", "x"));
+  CHECK_VALUE(INDEX_GETS("Net", "Extra"), "x");
+  CHECK_VALUE(INDEX_GETS("net", "Port"), "1");
+  ini_index_setcase(&index, INI_FALSE);
+  CHECK_VALUE(INDEX_GETS("NET", "port"), "-");    /* [Net] hides [net] again */
+  CHECK_VALUE(INDEX_GETS("NET", "extra"), "x");
+  ini_index_close(&index);
+
+  CHECK(ini_doc_open(&doc, ini));
+  ini_doc_setcase(&doc, INI_TRUE);
+  CHECK_VALUE(DOC_GETS("Net", "host"), "b");
+  CHECK_VALUE(DOC_GETS("net", "Host"), "-");
+  CHECK(ini_doc_puts(&doc, "net", "host", "c"));
+  CHECK_VALUE(DOC_GETS("net", "host"), "c");
+  CHECK_VALUE(DOC_GETS("Net", "host"), "b");
+  CHECK(ini_doc_undo(&doc));
+  ini_doc_setcase(&doc, INI_FALSE);
+  ini_doc_setcase(&doc, INI_TRUE);
+  CHECK(ini_doc_redo(&doc));
+  CHECK(ini_doc_save(&doc));
+  ini_doc_close(&doc);
+  CHECK(ini_doc_open(&doc, ini));
+  ini_doc_setcase(&doc, INI_TRUE);
+  CHECK_VALUE(DOC_GETS("net", "host"), "c");
+  CHECK_VALUE(DOC_GETS("Net", "host"), "b");
+  CHECK_VALUE(DOC_GETS("Net", "Host"), "a");
+  ini_doc_close(&doc);
+
+  TEST_END(argv[0]);
+}
@@ -0,0 +1,124 @@
+/*  Tests for continuation lines (INI_CONTINUATION): joined and indented lines
+ *  are read as one value, and every value that ini_puts() writes (folded, or
+ *  with new lines in it) reads back the same
+ */
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_cont.ini";
+
+static char seen[1024];
+
+static int callback(const char *Section, const char *Key, const char *Value, void *UserData)
+{
+  (void)UserData;
+  strcat(seen, Section);
+  strcat(seen, "|");
+  strcat(seen, Key);
+  strcat(seen, "=");
+  strcat(seen, Value);
+  strcat(seen, "#");
+  return 1;
+}
+
+/* Whether a value reads back the same, and the keys around it are intact */
+static void roundtrip(const char *value, int line)
+{
+  char back[INI_BUFFERSIZE];
+
+  test_writefile(ini, "[a]\nbefore=1\nafter=2\n[b]\nlast=3\n");
+  if (!ini_puts("a", "before", value, ini) || !ini_puts("a", "new", value, ini)) {
+    printf("%s:%d: writing failed\n", __FILE__, line);
+    test_failures++;
+    return;
+  }
+  ini_gets("a", "before", "<default>", back, sizeof(back), ini);
+  if (strcmp(back, value) != 0) {
+    printf("%s:%d: read back \"%s\", expected \"%s\"\n", __FILE__, line, back, value);
+    test_failures++;
+  }
+  ini_gets("a", "new", "<default>", back, sizeof(back), ini);
+  if (strcmp(back, value) != 0) {
+    printf("%s:%d: read back \"%s\" from a new key, expected \"%s\"\n", __FILE__, line, back, value);
+    test_failures++;
+  }
+  CHECK_GETS("a", "after", "2", ini);
+  CHECK_GETS("b", "last", "3", ini);
+  ini_getsection(2, back, sizeof(back), ini);
+  if (back[0] != '\0') {
+    printf("%s:%d: value made a section [%s]\n", __FILE__, line, back);
+    test_failures++;
+  }
+}
+
+#define ROUNDTRIP(value)  roundtrip((value), __LINE__)
+
+int main(int argc, char *argv[])
+{
+  char big[400], huge[2000];
+  FILE *fp;
+  int i;
+
+  (void)argc;
+  test_writefile(ini, "[a]\nk=one \\\ntwo\\\n three\nm = first\n  second\n\tthird\n;c\n  x=1\nn=v\n\n  y\n[b]\nz=\\\n");
+  CHECK_GETS("a", "k", "one two three", ini);
+  CHECK_GETS("a", "m", "first\nsecond\nthird", ini);
+  CHECK_GETS("a", "x", "1", ini);
+  CHECK_GETS("a", "n", "v", ini);
+  CHECK_GETS("b", "z", "", ini);
+  CHECK(ini_gets("a", "m", "", big, 10, ini) == 9 && strcmp(big, "first\nsec") == 0);
+  CHECK(ini_browse(callback, NULL, ini));
+  CHECK(strcmp(seen, "a|k=one two three#a|m=first\nsecond\nthird#a|x=1#a|n=v#b|z=#") == 0);
+
+  /* replacing or deleting a continued key drops its continuation lines */
+  CHECK(ini_puts("a", "m", "new", ini));
+  CHECK(strstr(test_readfile(ini), "second") == NULL && strstr(test_readfile(ini), "x=1") != NULL);
+  CHECK(ini_puts("a", "k", NULL, ini));
+  CHECK(strstr(test_readfile(ini), "three") == NULL);
+  CHECK_GETS("a", "x", "1", ini);
+
+  /* a long value is folded */
+  for (i = 0; i < (int)sizeof(big) - 1; i++)
+    big[i] = (char)('a' + i % 26);
+  big[sizeof(big) - 1] = '\0';
+  big[100] = ' ';
+  ROUNDTRIP(big);
+  CHECK(strstr(test_readfile(ini), "\\\n") != NULL);
+  big[INI_FOLDWIDTH - 8] = '\\';
+  big[INI_FOLDWIDTH - 7] = '\n';
+  ROUNDTRIP(big);
+
+  /* new lines in a value */
+  ROUNDTRIP("l1\nl2");
+  ROUNDTRIP("l1\nl2 \\");
+  ROUNDTRIP("ab\n;c");
+  ROUNDTRIP("ab\n#c");
+  ROUNDTRIP("ab\n[c]");
+  ROUNDTRIP("ab\n[c]\nd=1");
+  ROUNDTRIP("ab\\\ncd");
+  ROUNDTRIP("a\\\n\\\nb");
+  ROUNDTRIP("a\n\nb");
+  ROUNDTRIP("ab\n");
+  ROUNDTRIP("ab\n\n");
+  ROUNDTRIP("\nab");
+  ROUNDTRIP(" lead");
+  ROUNDTRIP("trail\t");
+  ROUNDTRIP("a\n  indented");
+  ROUNDTRIP("a\n\tb");
+  ROUNDTRIP("a\n\\b");
+  ROUNDTRIP("a\"q\"\n;b");
+
+  /* a value too long for the buffer is truncated, and the next key is found */
+  memset(huge, 'x', sizeof(huge) - 1);
+  huge[sizeof(huge) - 1] = '\0';
+  fp = fopen(ini, "wb");
+  fprintf(fp, "[a]\nk=%.*s\\\n%s\nafter=1\n", 300, huge, huge);
+  fclose(fp);
+  CHECK(ini_gets("a", "k", "", huge, sizeof(huge), ini) > 400 && strlen(huge) < INI_BUFFERSIZE);
+  CHECK_GETS("a", "after", "1", ini);
+  CHECK(ini_puts("a", "k", "short", ini));
+  CHECK_GETS("a", "k", "short", ini);
+  CHECK(strstr(test_readfile(ini), "xxxx") == NULL);
+
+  TEST_END(argv[0]);
+}
@@ -0,0 +1,58 @@
+/*  Tests for the dialect options (INI_COLONDELIM, INI_HASHCOMMENT,
+ *  INI_QUOTES and INI_CASESENSITIVE); the test is built in the full dialect
+ *  (the default) and in the minimal one
+ */
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_dialect.ini";
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  test_writefile(ini, "[Sec]\nKey=plain ; comment\ncolon:value\nhash=a # b\n# h=x\nquoted=\"a;b\" ;c\nesc=\"x\\\"y\"\n");
+  CHECK_GETS("Sec", "Key", "plain", ini);
+#if INI_COLONDELIM
+  CHECK_GETS("Sec", "colon", "value", ini);
+#else
+  CHECK_GETS("Sec", "colon", "<default>", ini);
+  CHECK_GETS("Sec", "colon:value", "<default>", ini);
+#endif
+#if INI_HASHCOMMENT
+  CHECK_GETS("Sec", "hash", "a", ini);
+  CHECK_GETS("Sec", "# h", "<default>", ini);
+#else
+  CHECK_GETS("Sec", "hash", "a # b", ini);
+  CHECK_GETS("Sec", "# h", "x", ini);
+#endif
+#if INI_QUOTES
+  CHECK_GETS("Sec", "quoted", "a;b", ini);
+  CHECK_GETS("Sec", "esc", "x\"y", ini);
+#else
+  CHECK_GETS("Sec", "quoted", "\"a", ini);
+  CHECK_GETS("Sec", "esc", "\"x\\\"y\"", ini);
+#endif
+#if INI_CASESENSITIVE
+  CHECK_GETS("sec", "Key", "<default>", ini);
+  CHECK_GETS("Sec", "key", "<default>", ini);
+#else
+  CHECK_GETS("sec", "KEY", "plain", ini);
+#endif
+
+  /* what ini_puts() writes reads back the same */
+  CHECK(ini_puts("Sec", "new", "v ; w", ini));
+#if INI_QUOTES
+  CHECK_GETS("Sec", "new", "v ; w", ini);
+#else
+  CHECK_GETS("Sec", "new", "v", ini);
+#endif
+  CHECK(ini_puts("Sec", "Key", "changed", ini));
+  CHECK_GETS("Sec", "Key", "changed", ini);
+#if INI_CASESENSITIVE
+  CHECK(ini_puts("SEC", "Key", "other", ini));
+  CHECK_GETS("Sec", "Key", "changed", ini);
+  CHECK_GETS("SEC", "Key", "other", ini);
+#endif
+
+  TEST_END(argv[0]);
+}
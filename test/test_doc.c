@@ -0,0 +1,219 @@
+/*  Tests for document versions (INI_VERSIONS): every edit through the
+ *  document must give the same result as the same edit with ini_puts(), in
+ *  the document itself and in the file after ini_doc_save()
+ */
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_doc.ini";           /* saved from the document */
+static const char *shadow = "test_doc.shadow.ini"; /* edited with ini_puts() */
+
+static void copyfile(const char *target, const char *source)
+{
+  test_writefile(target, test_readfile(source));
+}
+
+/* Compare all values (including those of repeated keys) in the document, in
+ * the file with the same edits and optionally in the saved file */
+static void compare(INI_DOC *doc, const char *expected, const char *saved, int step)
+{
+  char section[16], key[16], a[256], b[256], c[256];
+  int s, k, na, nb, nc;
+
+  for (s = -1; s < 8; s++) {
+    for (k = 0; k < 6; k++) {
+      if (s < 0)
+        section[0] = '\0';
+      else
+        sprintf(section, "S%d", s);
+      sprintf(key, "k%d", k);
+      memset(a, 0, sizeof(a));
+      memset(b, 0, sizeof(b));
+      memset(c, 0, sizeof(c));
+      na = ini_doc_getdups(doc, section, key, INI_DUP_ALL, a, sizeof(a));
+      nb = ini_getdups(section, key, INI_DUP_ALL, b, sizeof(b), expected);
+      if (na != nb || memcmp(a, b, sizeof(a)) != 0) {
+        printf("step %d [%s] %s: document has %d values \"%s\"..., expected %d \"%s\"...\n", step, section, key, na, a, nb, b);
+        test_failures++;
+      }
+      if (saved != NULL) {
+        nc = ini_getdups(section, key, INI_DUP_ALL, c, sizeof(c), saved);
+        if (nc != nb || memcmp(c, b, sizeof(c)) != 0) {
+          printf("step %d [%s] %s: saved file has %d values \"%s\"..., expected %d \"%s\"...\n", step, section, key, nc, c, nb, b);
+          test_failures++;
+        }
+      }
+    }
+  }
+}
+
+/* Random edits on a random file with repeated keys and repeated sections */
+static void fuzz(unsigned seed)
+{
+  char section[16], key[16], value[16];
+  INI_DOC doc;
+  FILE *fp;
+  int s, k, n;
+
+  srand(seed);
+  fp = fopen(ini, "wb");
+  for (k = rand() % 3; k > 0; k--)
+    fprintf(fp, "k%d=top%d\n", rand() % 6, k);
+  for (s = rand() % 10; s > 0; s--) {
+    fprintf(fp, "[S%d]\n", rand() % 8);
+    for (k = rand() % 6; k > 0; k--)
+      fprintf(fp, "k%d = %c%d\n", rand() % 6, 'a' + rand() % 26, k);
+    if (rand() % 4 == 0)
+      fputs("; comment\n", fp);
+  }
+  fclose(fp);
+  copyfile(shadow, ini);
+  for (memset(&doc, 0, sizeof(doc)), n = 0; n < 40 && test_failures == 0; n++) {
+    int op = rand() % 10;
+    if (n % 10 == 0) {
+      if (n > 0) {
+        CHECK(ini_doc_save(&doc));
+        ini_doc_close(&doc);
+      }
+      CHECK(ini_doc_open(&doc, ini));
+    }
+    if (rand() % 8 == 0)
+      section[0] = '\0';
+    else
+      sprintf(section, "S%d", rand() % 8);
+    sprintf(key, "k%d", rand() % 6);
+    sprintf(value, "v%.*s", rand() % 8, "abcdefgh");
+    if (op == 0) {
+      CHECK(ini_doc_puts(&doc, section, NULL, NULL));
+      CHECK(ini_puts(section, NULL, NULL, shadow));
+    } else if (op < 3) {
+      CHECK(ini_doc_puts(&doc, section, key, NULL));
+      CHECK(ini_puts(section, key, NULL, shadow));
+    } else {
+      CHECK(ini_doc_puts(&doc, section, key, value));
+      CHECK(ini_puts(section, key, value, shadow));
+    }
+    compare(&doc, shadow, NULL, n);
+    if (rand() % 3 == 0) {
+      CHECK(ini_doc_save(&doc));
+      compare(&doc, shadow, ini, n);
+    }
+  }
+  ini_doc_close(&doc);
+  if (test_failures > 0)
+    printf("fuzz seed %u\n", seed);
+}
+
+int main(int argc, char *argv[])
+{
+  char buffer[64];
+  INI_DOC doc;
+  unsigned seed;
+  int v;
+
+  (void)argc;
+  test_writefile(ini, "top=1\n[S0]\nk0=a\nk1 = \"q;x\" ;c\n[bad\nk2=lost\n[S1]\nk0:b\n = e\n[s0]\nk3=dup\n");
+  CHECK(ini_doc_open(&doc, ini));
+  CHECK(ini_doc_gets(&doc, "s0", "K1", "-", buffer, sizeof(buffer)) && strcmp(buffer, "q;x") == 0);
+  CHECK(ini_doc_gets(&doc, "S0", "k3", "-", buffer, sizeof(buffer)) && strcmp(buffer, "-") == 0);
+  CHECK(ini_doc_gets(&doc, NULL, "top", "-", buffer, sizeof(buffer)) && strcmp(buffer, "1") == 0);
+  CHECK(ini_doc_gets(&doc, "S1", "", "-", buffer, sizeof(buffer)) && strcmp(buffer, "-") == 0);
+  CHECK(ini_doc_getsection(&doc, 1, buffer, sizeof(buffer)) && strcmp(buffer, "S1") == 0);
+  CHECK(ini_doc_getkey(&doc, "S0", 1, buffer, sizeof(buffer)) && strcmp(buffer, "k1") == 0);
+  CHECK(ini_doc_puts(&doc, "S0", "k0", "a") && doc.count == 1);   /* no change, no new version */
+
+  /* undo and redo */
+  CHECK(ini_doc_puts(&doc, "S0", "k0", "b") && doc.count == 2 && doc.current == 1);
+  CHECK(ini_doc_puts(&doc, "S2", "k0", "c") && doc.count == 3 && doc.current == 2);
+  CHECK(ini_doc_undo(&doc) && doc.current == 1);
+  CHECK(ini_doc_gets(&doc, "S2", "k0", "-", buffer, sizeof(buffer)) && strcmp(buffer, "-") == 0);
+  CHECK(ini_doc_undo(&doc) && doc.current == 0 && !ini_doc_undo(&doc));
+  CHECK(ini_doc_gets(&doc, "S0", "k0", "-", buffer, sizeof(buffer)) && strcmp(buffer, "a") == 0);
+  CHECK(ini_doc_redo(&doc) && ini_doc_redo(&doc) && !ini_doc_redo(&doc));
+  CHECK(ini_doc_gets(&doc, "S2", "k0", "-", buffer, sizeof(buffer)) && strcmp(buffer, "c") == 0);
+  CHECK(ini_doc_setversion(&doc, 1));
+  CHECK(ini_doc_puts(&doc, "S3", "k0", "d") && doc.count == 3 && !ini_doc_redo(&doc));  /* drops the redo */
+  ini_doc_close(&doc);
+
+  /* saving only writes the differences, so comments are kept */
+  test_writefile(ini, "; keep\n[A]\nx=1 ; me too\n[B]\ny=2\n");
+  CHECK(ini_doc_open(&doc, ini));
+  CHECK(ini_doc_puts(&doc, "A", "z", "3") && ini_doc_puts(&doc, "B", NULL, NULL) && ini_doc_puts(&doc, "C", "w", "4"));
+  CHECK(ini_doc_save(&doc));
+  CHECK(strcmp(test_readfile(ini), "; keep\n[A]\nx=1 ; me too\nz = 3\n[C]\nw = 4\n") == 0);
+  v = doc.current;
+  CHECK(ini_doc_setversion(&doc, 0) && ini_doc_save(&doc));   /* back to the original */
+  CHECK(strcmp(test_readfile(ini), "; keep\n[A]\nx=1 ; me too\n[B]\ny = 2\n") == 0);
+  CHECK(ini_doc_setversion(&doc, v) && ini_doc_save(&doc));
+  ini_doc_close(&doc);
+  CHECK(ini_doc_open(&doc, ini));
+  CHECK(ini_doc_gets(&doc, "c", "W", "-", buffer, sizeof(buffer)) && strcmp(buffer, "4") == 0);
+  ini_doc_close(&doc);
+
+  /* a section with a repeated key: an edit of another key must not change
+     the first occurrence of the repeated key */
+  test_writefile(ini, "[s]\na = 1\na = zz\nb = 2\n");
+  CHECK(ini_doc_open(&doc, ini));
+  CHECK(ini_doc_puts(&doc, "s", "b", "3"));
+  CHECK(ini_doc_save(&doc));
+  ini_doc_close(&doc);
+  CHECK_GETS("s", "a", "1", ini);
+  CHECK(ini_getdups("s", "a", INI_DUP_ALL, buffer, sizeof(buffer), ini) == 2 && memcmp(buffer, "1\0zz\0", 6) == 0);
+  CHECK(strcmp(test_readfile(ini), "[s]\na = 1\na = zz\nb = 3\n") == 0);
+  /* a change of the repeated key itself only replaces its first line */
+  test_writefile(ini, "[s]\n; c\na = 1 ; first\na = zz ; second\nb = 2\n");
+  CHECK(ini_doc_open(&doc, ini));
+  CHECK(ini_doc_puts(&doc, "s", "a", "4"));
+  CHECK(ini_doc_save(&doc));
+  ini_doc_close(&doc);
+  CHECK(ini_getdups("s", "a", INI_DUP_ALL, buffer, sizeof(buffer), ini) == 2 && memcmp(buffer, "4\0zz\0", 6) == 0);
+  CHECK(strcmp(test_readfile(ini), "[s]\n; c\na = 4\na = zz ; second\nb = 2\n") == 0);
+
+  /* with case-sensitive names, only the lines of the changed key change */
+  test_writefile(ini, "; top\n[S]\nK=1\nk=2 ; lower\n[s]\nK=3\n");
+  CHECK(ini_doc_open(&doc, ini));
+  ini_doc_setcase(&doc, INI_TRUE);
+  CHECK(ini_doc_puts(&doc, "S", "K", "4") && ini_doc_puts(&doc, "s", "k", "5"));
+  CHECK(ini_doc_save(&doc));
+  ini_doc_close(&doc);
+  CHECK(strcmp(test_readfile(ini), "; top\n[S]\nK = 4\nk=2 ; lower\n[s]\nK=3\nk = 5\n") == 0);
+
+  /* erasing a repeated section makes the next one visible, and an edit of
+     that one keeps its other lines */
+  test_writefile(ini, "[T]\n[S]\na=1\n[S]\na=2\nb=x ; keep\n");
+  CHECK(ini_doc_open(&doc, ini));
+  CHECK(ini_doc_puts(&doc, "S", NULL, NULL) && ini_doc_puts(&doc, "S", "a", "3"));
+  CHECK(ini_doc_save(&doc));
+  ini_doc_close(&doc);
+  CHECK(strcmp(test_readfile(ini), "[T]\n[S]\na = 3\nb=x ; keep\n") == 0);
+
+  /* a last line without a line terminator */
+  test_writefile(ini, "[A]\nx=1");
+  CHECK(ini_doc_open(&doc, ini));
+  CHECK(ini_doc_puts(&doc, "A", "y", "2") && ini_doc_puts(&doc, "B", "z", "3"));
+  CHECK(ini_doc_save(&doc));
+  ini_doc_close(&doc);
+  CHECK(strcmp(test_readfile(ini), "[A]\nx=1\ny = 2\n[B]\nz = 3\n") == 0);
+
+  /* a file that was changed behind the document is not overwritten */
+  CHECK(ini_doc_open(&doc, ini));
+  CHECK(ini_puts("C", "w", "4", ini));
+  CHECK(ini_doc_puts(&doc, "A", "x", "5"));
+  CHECK(!ini_doc_save(&doc));
+  ini_doc_close(&doc);
+  CHECK_GETS("A", "x", "1", ini);
+  CHECK_GETS("C", "w", "4", ini);
+
+  /* a file that does not exist is an empty document */
+  remove("test_doc.none");
+  CHECK(ini_doc_open(&doc, "test_doc.none") && doc.count == 1);
+  CHECK(ini_doc_puts(&doc, "A", "x", "1") && ini_doc_save(&doc));
+  ini_doc_close(&doc);
+  CHECK(strcmp(test_readfile("test_doc.none"), "[A]\nx = 1\n") == 0);
+  remove("test_doc.none");
+
+  for (seed = 1; seed <= 200 && test_failures == 0; seed++)
+    fuzz(seed);
+
+  TEST_END(argv[0]);
+}
@@ -0,0 +1,81 @@
+/*  Tests for keys that repeat in a section (ini_getdups() and its index and
+ *  document variants)
+ */
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_dups.ini";
+
+/* Whether the list in the buffer is the expected one (with its zeros) */
+#define CHECK_DUPS(call, count, list) \
+  do { \
+    char buffer_[64]; \
+    int n_ = (call); \
+    if (n_ != (count) || memcmp(buffer_, (list), sizeof(list)) != 0) { \
+      printf("%s:%d: %d values, expected %d\n", __FILE__, __LINE__, n_, (count)); \
+      test_failures++; \
+    } \
+  } while (0)
+
+int main(int argc, char *argv[])
+{
+  INI_INDEX index;
+  INI_DOC doc;
+  int pass;
+
+  (void)argc;
+  test_writefile(ini, "p=top\n[Plugins]\nload=a\nx=1\nLOAD = \"b;c\" ;c\n;load=no\nload=d\n[other]\nload=e\n[plugins]\nload=f\n");
+  CHECK_DUPS(ini_getdups("plugins", "load", INI_DUP_ALL, buffer_, sizeof(buffer_), ini), 3, "a\0b;c\0d");
+  CHECK_DUPS(ini_getdups("plugins", "load", INI_DUP_FIRST, buffer_, sizeof(buffer_), ini), 1, "a");
+  CHECK_DUPS(ini_getdups("plugins", "load", INI_DUP_LAST, buffer_, sizeof(buffer_), ini), 1, "d");
+  CHECK_DUPS(ini_getdups(NULL, "p", INI_DUP_ALL, buffer_, sizeof(buffer_), ini), 1, "top");
+  CHECK_DUPS(ini_getdups("plugins", "none", INI_DUP_ALL, buffer_, sizeof(buffer_), ini), 0, "");
+  CHECK_DUPS(ini_getdups("nosect", "load", INI_DUP_LAST, buffer_, sizeof(buffer_), ini), 0, "");
+  CHECK_DUPS(ini_getdups("plugins", "", INI_DUP_ALL, buffer_, sizeof(buffer_), ini), 0, "");
+  CHECK_DUPS(ini_getdups("plugins", "load", INI_DUP_ALL, buffer_, 6, ini), 2, "a\0b;");   /* truncated */
+  CHECK_DUPS(ini_getdups("plugins", "load", INI_DUP_ALL, buffer_, 2, ini), 1, "");
+  CHECK_GETS("plugins", "load", "a", ini);
+
+  /* writing one occurrence: with a copy, erased, and added at the end of the
+     section; the other occurrences and the comment stay */
+  CHECK(ini_puts_nth("plugins", "load", 2, "D", ini));
+  CHECK(ini_puts_nth("plugins", "load", 1, "bb", ini));
+  CHECK(ini_puts_nth("plugins", "load", 0, NULL, ini));
+  CHECK(ini_puts_nth("plugins", "load", 5, "g", ini));
+  CHECK(ini_puts_nth("plugins", "load", 9, NULL, ini));
+  CHECK(ini_puts_nth(NULL, "p", 1, "top2", ini));
+  CHECK(!ini_puts_nth("plugins", "load", -1, "x", ini));
+  CHECK(strcmp(test_readfile(ini), "p=top\np = top2\n[Plugins]\nx=1\nload = bb\n;load=no\nload = D\nload = g\n"
+                                   "[other]\nload=e\n[plugins]\nload=f\n") == 0);
+  CHECK_DUPS(ini_getdups("plugins", "load", INI_DUP_ALL, buffer_, sizeof(buffer_), ini), 3, "bb\0D\0g");
+  CHECK(ini_puts_nth("plugins", "load", 2, "h", ini));     /* same length: in place */
+  CHECK_DUPS(ini_getdups("plugins", "load", INI_DUP_ALL, buffer_, sizeof(buffer_), ini), 3, "bb\0D\0h");
+  /* a section without repeated keys, and a section at the end of the file */
+  CHECK(ini_puts_nth("other", "load", 0, "E", ini));
+  CHECK(ini_puts_nth("nosect", "k", 3, "v", ini));
+  CHECK(ini_puts_nth("nosect", "k", 1, "w", ini));
+  CHECK_DUPS(ini_getdups("nosect", "k", INI_DUP_ALL, buffer_, sizeof(buffer_), ini), 2, "v\0w");
+  CHECK_DUPS(ini_getdups("other", "load", INI_DUP_ALL, buffer_, sizeof(buffer_), ini), 1, "E");
+
+  test_writefile(ini, "p=top\n[Plugins]\nload=a\nx=1\nLOAD = \"b;c\" ;c\n;load=no\nload=d\n[other]\nload=e\n[plugins]\nload=f\n");
+
+  CHECK(ini_index_open(&index, ini));
+  for (pass = 0; pass < 2; pass++) {
+    if (pass == 1)
+      ini_index_setbudget(&index, 1);   /* the values are read from the file */
+    CHECK_DUPS(ini_index_getdups(&index, "plugins", "load", INI_DUP_ALL, buffer_, sizeof(buffer_)), 3, "a\0b;c\0d");
+    CHECK_DUPS(ini_index_getdups(&index, "plugins", "load", INI_DUP_LAST, buffer_, sizeof(buffer_)), 1, "d");
+    CHECK_DUPS(ini_index_getdups(&index, "plugins", "load", INI_DUP_ALL, buffer_, 6), 2, "a\0b;");
+    CHECK_DUPS(ini_index_getdups(&index, "x", "load", INI_DUP_ALL, buffer_, 6), 0, "");
+  }
+  ini_index_close(&index);
+
+  CHECK(ini_doc_open(&doc, ini));
+  CHECK_DUPS(ini_doc_getdups(&doc, "plugins", "load", INI_DUP_ALL, buffer_, sizeof(buffer_)), 3, "a\0b;c\0d");
+  CHECK_DUPS(ini_doc_getdups(&doc, "plugins", "load", INI_DUP_LAST, buffer_, sizeof(buffer_)), 1, "d");
+  CHECK_DUPS(ini_doc_getdups(&doc, "", "p", INI_DUP_FIRST, buffer_, sizeof(buffer_)), 1, "top");
+  CHECK_DUPS(ini_doc_getdups(&doc, "plugins", "", INI_DUP_ALL, buffer_, sizeof(buffer_)), 0, "");
+  ini_doc_close(&doc);
+
+  TEST_END(argv[0]);
+}
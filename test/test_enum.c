@@ -0,0 +1,91 @@
+/*  Tests for enumerating sections and keys, with and without the cursor
+ *  (INI_ENUMCURSOR): both must give what a scan from the start gives
+ */
+#include <utime.h>
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_enum.ini";
+
+/* Write the file with a fixed time stamp, as an edit by another program
+   within the resolution of the time stamp */
+static void write_stamped(const char *text)
+{
+  struct utimbuf times;
+  test_writefile(ini, text);
+  times.actime = times.modtime = 1000;
+  utime(ini, &times);
+}
+
+#define CHECK_SECTION(idx, expected) \
+  do { \
+    char name_[64]; \
+    ini_getsection((idx), name_, sizeof(name_), ini); \
+    if (strcmp(name_, (expected)) != 0) { \
+      printf("%s:%d: section %d is \"%s\", expected \"%s\"\n", __FILE__, __LINE__, (idx), name_, (expected)); \
+      test_failures++; \
+    } \
+  } while (0)
+
+#define CHECK_KEY(section, idx, expected) \
+  do { \
+    char name_[64]; \
+    ini_getkey((section), (idx), name_, sizeof(name_), ini); \
+    if (strcmp(name_, (expected)) != 0) { \
+      printf("%s:%d: key %d of [%s] is \"%s\", expected \"%s\"\n", __FILE__, __LINE__, \
+             (idx), (section) != NULL ? (section) : "", name_, (expected)); \
+      test_failures++; \
+    } \
+  } while (0)
+
+int main(int argc, char *argv[])
+{
+  char name[16], expected[16];
+  FILE *fp;
+  int i;
+
+  (void)argc;
+  test_writefile(ini, "top=1\n[A]\nx=1\n;c\ny=2\n[B]\nz=3\n[a]\nw=4\n");
+  CHECK_SECTION(0, "A");
+  CHECK_SECTION(1, "B");
+  CHECK_SECTION(2, "a");
+  CHECK_SECTION(3, "");
+  CHECK_SECTION(1, "B");    /* backwards */
+  CHECK_KEY("A", 0, "x");
+  CHECK_KEY("A", 1, "y");
+  CHECK_KEY("A", 2, "");
+  CHECK_KEY("b", 0, "z");
+  CHECK_KEY(NULL, 0, "top");
+  CHECK_KEY("A", 1, "y");
+  CHECK_KEY("B", 1, "");    /* the next index in another section */
+
+  /* a write through the library in between */
+  CHECK_SECTION(0, "A");
+  CHECK(ini_puts("A", NULL, NULL, ini));
+  CHECK_SECTION(1, "a");
+
+  /* an edit by another program that keeps the size and the time stamp */
+  write_stamped("[a]\n[bb]\n[c]\n[d]\n");
+  CHECK_SECTION(0, "a");
+  CHECK_SECTION(1, "bb");
+  write_stamped("[a]\n[b]\n[x]\n[cd]\n");
+  CHECK_SECTION(2, "x");
+  write_stamped("[s]\nk1=a\nk22=b\nk3=c\n");
+  CHECK_KEY("s", 0, "k1");
+  CHECK_KEY("s", 1, "k22");
+  write_stamped("[s]\nk1=a\nk2=b\nk33=c\n");
+  CHECK_KEY("s", 2, "k33");
+
+  /* enumerating a longer file */
+  fp = fopen(ini, "wb");
+  for (i = 0; i < 500; i++)
+    fprintf(fp, "[S%d]\nkey%d=%d\n", i, i, i);
+  fclose(fp);
+  for (i = 0; i < 500; i++) {
+    sprintf(expected, "S%d", i);
+    CHECK(ini_getsection(i, name, sizeof(name), ini) > 0 && strcmp(name, expected) == 0);
+  }
+  CHECK(ini_getsection(500, name, sizeof(name), ini) == 0);
+
+  TEST_END(argv[0]);
+}
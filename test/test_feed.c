@@ -0,0 +1,77 @@
+/*  Tests for the push parser (ini_feed()): it must report the same settings
+ *  as ini_browse(), however the input is split into chunks
+ */
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_feed.ini";
+static char output[1 << 17];
+
+static SceBool collect(const char *Section, const char *Key, const char *Value, void *UserData)
+{
+  int *limit = (int *)UserData;
+  sprintf(strchr(output, '\0'), "%s|%s|%s\n", Section, Key, Value);
+  return limit == NULL || --*limit > 0;
+}
+
+int main(int argc, char *argv[])
+{
+  static char text[1 << 17], expected[1 << 17];
+  INI_PARSER parser;
+  SceSize offset, size, chunk;
+  char *p = text;
+  int s, k, step, limit;
+
+  (void)argc;
+  /* quoted values with comment characters, a line that is longer than the
+     line buffer, and no line terminator on the last line */
+  for (s = 0; s < 200; s++) {
+    p += sprintf(p, "%s[S%d]\r\n", (s % 3) ? "" : "  ", s);
+    for (k = 0; k < 5; k++)
+      p += sprintf(p, "k%d = \"v %d;%d\" # x\n", k, s, k);
+    if (s == 50) {
+      p += sprintf(p, "long=");
+      for (k = 0; k < 3 * INI_BUFFERSIZE; k++)
+        *p++ = (char)('a' + k % 26);
+      *p++ = '\n';
+    }
+  }
+  sprintf(p, "last=1");
+  test_writefile(ini, text);
+  CHECK(ini_browse(collect, NULL, ini));
+  strcpy(expected, output);
+  CHECK(strlen(expected) > 10000);
+
+  /* chunks of varying sizes, from a single byte upwards */
+  size = (SceSize)strlen(text);
+  for (step = 1; step < 40; step += 3) {
+    output[0] = '\0';
+    ini_parser_init(&parser, collect, NULL);
+    for (offset = 0; offset < size; offset += chunk) {
+      chunk = (SceSize)((offset * 31 + (SceSize)step) % (SceSize)(step * 13 + 1)) + 1;
+      if (chunk > size - offset)
+        chunk = size - offset;
+      CHECK(ini_feed(&parser, text + offset, chunk));
+    }
+    CHECK(ini_feed_end(&parser));
+    CHECK(strcmp(output, expected) == 0);
+  }
+
+  /* the whole text at once, and an empty chunk */
+  output[0] = '\0';
+  ini_parser_init(&parser, collect, NULL);
+  CHECK(ini_feed(&parser, text, 0));
+  CHECK(ini_feed(&parser, text, size));
+  CHECK(ini_feed_end(&parser));
+  CHECK(strcmp(output, expected) == 0);
+
+  /* the callback stops the parser */
+  output[0] = '\0';
+  limit = 3;
+  ini_parser_init(&parser, collect, &limit);
+  CHECK(!ini_feed(&parser, text, size));
+  CHECK(!ini_feed_end(&parser));
+  CHECK(strcmp(output, "S0|k0|v 0;0\nS0|k1|v 0;1\nS0|k2|v 0;2\n") == 0);
+
+  TEST_END(argv[0]);
+}
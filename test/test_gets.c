@@ -0,0 +1,39 @@
+/*  Tests for ini_gets_len() and ini_gets_alloc(): the length of a value is
+ *  known without a buffer that holds all of it, and the arena takes exactly
+ *  what the values need
+ */
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_gets.ini";
+
+int main(int argc, char *argv[])
+{
+  char buffer[8], memory[20];
+  const char *value;
+  INI_ARENA arena;
+
+  (void)argc;
+  test_writefile(ini, "[A]\nx=\"hello world\" ;c\ny=\n");
+  CHECK(ini_gets_len("A", "x", "d", NULL, 0, ini) == 11);
+  CHECK(ini_gets_len("A", "x", "d", buffer, sizeof(buffer), ini) == 11 && strcmp(buffer, "hello w") == 0);
+  CHECK(ini_gets_len("a", "X", "d", buffer, sizeof(buffer), ini) == 11);
+  CHECK(ini_gets_len("A", "y", "d", buffer, sizeof(buffer), ini) == 0 && buffer[0] == '\0');
+  CHECK(ini_gets_len("A", "z", "default!", buffer, sizeof(buffer), ini) == 8 && strcmp(buffer, "default") == 0);
+  CHECK(ini_gets_len("A", "z", NULL, buffer, sizeof(buffer), ini) == 0 && buffer[0] == '\0');
+  CHECK(ini_gets("A", "x", "d", buffer, sizeof(buffer), ini) == 7);   /* ini_gets() returns what it copied */
+
+  ini_arena_init(&arena, memory, sizeof(memory));
+  value = ini_gets_alloc(&arena, "A", "x", NULL, ini);
+  CHECK(value == memory && strcmp(value, "hello world") == 0 && arena.used == 12);
+  CHECK(ini_gets_alloc(&arena, "A", "x", NULL, ini) == NULL && arena.used == 12);   /* does not fit */
+  value = ini_gets_alloc(&arena, "A", "none", "1234567", ini);
+  CHECK(value == memory + 12 && strcmp(value, "1234567") == 0 && arena.used == 20);
+  CHECK(ini_gets_alloc(&arena, "A", "y", NULL, ini) == NULL);     /* even an empty string needs a byte */
+  ini_arena_reset(&arena);
+  CHECK(arena.used == 0);
+  value = ini_gets_alloc(&arena, "A", "y", "d", ini);
+  CHECK(value == memory && *value == '\0' && arena.used == 1);
+
+  TEST_END(argv[0]);
+}
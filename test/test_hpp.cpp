@@ -0,0 +1,76 @@
+/*  Tests for the C++ wrapper (minIni.hpp): the handles give what the C
+ *  functions give, and they can be moved but not copied
+ */
+#include "test.h"
+#include "minIni.hpp"
+
+static const char *ini = "test_hpp.ini";
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  test_writefile(ini, "[A]\nx=0x10\ny=yes\nf=1.5\ns=\"hi there\"\ne=\nn=-3\n");
+  minIni::File file(ini);
+  CHECK(file.get<int>("A", "x", 0) == 16);
+  CHECK(file.get<unsigned long long>("A", "x", 0) == 16);
+  CHECK(file.get<int>("A", "n", 0) == -3);
+  CHECK(file.get<bool>("A", "y", false));
+  CHECK(file.get<bool>("A", "zz", true));
+  CHECK(file.get<float>("A", "f", 0) == 1.5f);
+  CHECK(file.get<std::string_view>("A", "s", "d") == "hi there");
+  CHECK(file.get<std::string_view>("A", "zz", "d") == "d");
+  CHECK(file.get<std::string_view>("A", "e", "d") == "");   /* present but empty */
+  CHECK(file.get<int>("A", "zz", 7) == 7);
+  CHECK(file.gets("a", "S") == "hi there");
+  CHECK(file.section(0) == "A" && file.section(1) == "");
+  CHECK(file.key("A", 2) == "f" && file.key("A", 9) == "");
+  CHECK(file.has_section("A") && !file.has_section("B"));
+  CHECK(file.has_key("A", "e") && !file.has_key("A", "zz"));
+  CHECK(file.put("A", "i", 42) && file.put("A", "b", true) && file.put("A", "u", 7u));
+  CHECK(file.gets("A", "i") == "42" && file.gets("A", "b") == "true" && file.gets("A", "u") == "7");
+  CHECK(file.erase("A", "u") && !file.has_key("A", "u"));
+  CHECK(file.put("B", "k", "v") && file.erase_section("B") && !file.has_section("B"));
+  minIni::File moved(std::move(file));
+  CHECK(std::strcmp(moved.filename(), ini) == 0 && moved.get<int>("A", "i", 0) == 42);
+
+#if INI_BROWSE
+  int count = 0;
+  for (auto &section : moved.sections())
+    for (auto [key, value] : section)
+      count += section.name() == "A" && !key.empty() && value.data() != nullptr;
+  CHECK(count == 8);
+#endif
+
+#if INI_LAZYINDEX
+  minIni::Index index(ini);
+  CHECK(index.is_open() && index.get<int>("A", "i", 0) == 42);
+  CHECK(index.put("A", "i", 43) && index.get<int>("A", "i", 0) == 43);
+  minIni::Index index2(std::move(index));
+  CHECK(!index.is_open() && index2.is_open());
+  CHECK(index2.gets("A", "s") == "hi there" && index2.has_key("A", "e") && !index2.has_key("A", "q"));
+  minIni::Index missing("test_hpp.none");
+  CHECK(missing.gets("A", "x", "d") == "d");
+#endif
+
+#if INI_VERSIONS
+  minIni::Document doc(ini);
+  CHECK(doc.is_open() && doc.put("A", "i", 44) && doc.get<int>("A", "i", 0) == 44);
+  CHECK(doc.has_key("A", "e") && !doc.has_key("A", "q"));
+  CHECK(doc.undo() && doc.get<int>("A", "i", 0) == 43 && doc.redo());
+  minIni::Document doc2 = std::move(doc);
+  CHECK(doc2.is_open() && !doc.is_open());
+  CHECK(!doc.put("A", "i", 1) && doc.gets("A", "i", "d") == "d");
+  CHECK(doc2.save() && moved.get<int>("A", "i", 0) == 44);
+#endif
+
+  static_assert(!std::is_copy_constructible_v<minIni::File>);
+  static_assert(std::is_nothrow_move_constructible_v<minIni::File>);
+#if INI_LAZYINDEX
+  static_assert(!std::is_copy_constructible_v<minIni::Index>);
+#endif
+#if INI_VERSIONS
+  static_assert(!std::is_copy_assignable_v<minIni::Document>);
+#endif
+
+  TEST_END(argv[0]);
+}
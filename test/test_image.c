@@ -0,0 +1,131 @@
+/*  Tests for published images (INI_IMAGE): lookups in the image must find
+ *  what ini_gets() finds, and readers must never see a half-published image
+ */
+#include <pthread.h>
+#include "test.h"
+#include "minIni.h"
+
+static SceUInt32 image[4096];
+static volatile int stop;
+
+#define CHECK_IMAGE(section, key, expected) \
+  do { \
+    char value_[64]; \
+    ini_image_gets(image, sizeof(image), (section), (key), "<default>", value_, sizeof(value_)); \
+    if (strcmp(value_, (expected)) != 0) { \
+      printf("%s:%d: [%s] %s is \"%s\", expected \"%s\"\n", __FILE__, __LINE__, \
+             (section) != NULL ? (section) : "", (key), value_, (expected)); \
+      test_failures++; \
+    } \
+  } while (0)
+
+/* Publish the two files in turn, until the readers are done */
+static void *publisher(void *arg)
+{
+  int i;
+
+  (void)arg;
+  for (i = 0; !stop; i++)
+    if (ini_image_publish(image, sizeof(image), (i & 1) ? "test_image1.ini" : "test_image2.ini") == 0) {
+      printf("publishing failed\n");
+      test_failures++;
+      break;
+    }
+  return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+  char buffer[64];
+  pthread_t thread;
+  SceUInt32 generation;
+  int i;
+
+  (void)argc;
+  test_writefile("test_image1.ini", "top=1\n[A]\nx=a1\ny = \"q v\" ; c\nx=dup\n = e\n[B]\nk:b\n[A]\nz=no\n[bad\nw=hidden\n");
+  test_writefile("test_image2.ini", "top=1\n[A]\nx=a2\ny=q v\n[B]\nk=b\n");
+  CHECK(ini_image_publish(image, sizeof(image), "test_image1.ini") > 0);
+  generation = ini_image_generation(image);
+  CHECK_IMAGE("a", "X", "a1");
+  CHECK_IMAGE("A", "y", "q v");
+  CHECK_IMAGE("A", "z", "<default>");    /* a repeated section is not merged */
+  CHECK_IMAGE("A", "", "<default>");
+  CHECK_IMAGE("", "top", "1");
+  CHECK_IMAGE(NULL, "top", "1");
+  CHECK_IMAGE("B", "k", "b");
+  CHECK_IMAGE("bad", "w", "<default>");
+  CHECK_IMAGE("B", "w", "<default>");
+  CHECK(ini_image_gets(image, sizeof(image), "A", "y", "", buffer, 3) == 2 && strcmp(buffer, "q ") == 0);
+  CHECK(ini_image_publish(image, 40, "test_image1.ini") == 0);  /* does not fit, image is kept */
+  CHECK(ini_image_generation(image) == generation);
+  CHECK_IMAGE("a", "X", "a1");
+
+  /* a value in the image, without a copy */
+  {
+    const char *value;
+    SceSize len;
+    SceUInt32 found;
+    value = ini_image_find(image, sizeof(image), "A", "y", &len, &found);
+    CHECK(value != NULL && len == 3 && strcmp(value, "q v") == 0 && found == generation);
+    CHECK(value >= (const char *)image && value + len < (const char *)image + sizeof(image));
+    CHECK(ini_image_find(image, sizeof(image), NULL, "top", NULL, NULL) != NULL);
+    CHECK(ini_image_find(image, sizeof(image), "A", "z", &len, NULL) == NULL);
+    CHECK(ini_image_find(image, sizeof(image), "C", "x", NULL, NULL) == NULL);
+  }
+
+  /* a file without keys, and a file that does not exist */
+  test_writefile("test_image3.ini", "");
+  CHECK(ini_image_publish(image, sizeof(image), "test_image3.ini") > 0);
+  CHECK_IMAGE("", "top", "<default>");
+  test_writefile("test_image3.ini", "; only a comment\n[empty]\n");
+  CHECK(ini_image_publish(image, sizeof(image), "test_image3.ini") > 0);
+  CHECK_IMAGE("empty", "x", "<default>");
+  remove("test_image4.ini");
+  CHECK(ini_image_publish(image, sizeof(image), "test_image4.ini") == 0);
+
+  /* readers see either file, never a mix */
+  CHECK(ini_image_publish(image, sizeof(image), "test_image1.ini") > 0);
+  generation = ini_image_generation(image);
+  pthread_create(&thread, NULL, publisher, NULL);
+  for (i = 0; i < 100000; i++) {
+    ini_image_gets(image, sizeof(image), "A", "x", "", buffer, sizeof(buffer));
+    if (strcmp(buffer, "a1") != 0 && strcmp(buffer, "a2") != 0) {
+      printf("torn read: \"%s\"\n", buffer);
+      test_failures++;
+      break;
+    }
+  }
+  stop = 1;
+  pthread_join(thread, NULL);
+  CHECK(ini_image_generation(image) > generation);
+
+#if defined(MININI_SHAREDIMAGE)
+  /* an image in shared memory: the reader's mapping shows what the publisher
+     publishes later on */
+  {
+    static const char *name = "/test_image.shm";
+    const void *reader;
+    void *shared;
+    SceSize size = 0;
+    (void)ini_image_remove(name);
+    CHECK(ini_image_attach(name, &size) == NULL);
+    shared = ini_image_create(name, sizeof(image));
+    CHECK(shared != NULL);
+    CHECK(ini_image_publish(shared, sizeof(image), "test_image1.ini") > 0);
+    reader = ini_image_attach(name, &size);
+    CHECK(reader != NULL && size == sizeof(image) && reader != (const void *)shared);
+    if (shared != NULL && reader != NULL) {
+      ini_image_gets(reader, size, "A", "x", "", buffer, sizeof(buffer));
+      CHECK(strcmp(buffer, "a1") == 0);
+      CHECK(ini_image_publish(shared, sizeof(image), "test_image2.ini") > 0);
+      CHECK(strcmp(ini_image_find(reader, size, "A", "x", NULL, NULL), "a2") == 0);
+      CHECK(ini_image_generation(reader) == ini_image_generation(shared));
+    }
+    ini_image_detach(reader, size);
+    ini_image_detach(shared, sizeof(image));
+    CHECK(ini_image_remove(name));
+  }
+#endif
+
+  TEST_END(argv[0]);
+}
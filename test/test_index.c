@@ -0,0 +1,147 @@
+/*  Tests for the lazy section index (INI_LAZYINDEX)
+ */
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_index.ini";
+
+/* Compare every lookup through the index with ini_gets() */
+static void compare_all(INI_INDEX *index, int sections, int keys)
+{
+  char section[16], key[16], expected[64], value[64];
+  int s, k;
+
+  for (s = 0; s < sections; s++) {
+    sprintf(section, "sec%d", (s * 37) % sections);
+    for (k = 0; k < keys; k++) {
+      sprintf(key, "K%d", k);
+      ini_gets(section, key, "<default>", expected, sizeof(expected), ini);
+      ini_index_gets(index, section, key, "<default>", value, sizeof(value));
+      if (strcmp(expected, value) != 0) {
+        printf("[%s] %s: index gives \"%s\", ini_gets gives \"%s\"\n", section, key, value, expected);
+        test_failures++;
+      }
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  INI_INDEX index;
+  char buffer[64];
+  FILE *fp;
+  SceUInt32 misses;
+  int s, k;
+
+  (void)argc;
+  test_writefile(ini, "top=1\n  [ A ]  \nx = 1\ny=\"q\\\"z\" ; c\n[bogus\nlost=1\n"
+                      "[B]\nk:v\n = empty\n# c\n\n\t[C]\nm=n");
+  CHECK(ini_index_open(&index, ini));
+  CHECK(index.count == 4);      /* the keys above the first section, A, B and C */
+  CHECK(ini_index_gets(&index, "a", "X", "d", buffer, sizeof(buffer)) == 1 && strcmp(buffer, "1") == 0);
+  CHECK(ini_index_gets(&index, "A", "y", "d", buffer, sizeof(buffer)) && strcmp(buffer, "q\"z") == 0);
+  CHECK(ini_index_gets(&index, "A", "lost", "d", buffer, sizeof(buffer)) && strcmp(buffer, "d") == 0);
+  CHECK(ini_index_gets(&index, "B", "k", "d", buffer, sizeof(buffer)) && strcmp(buffer, "v") == 0);
+  CHECK(ini_index_gets(&index, "C", "m", "d", buffer, sizeof(buffer)) && strcmp(buffer, "n") == 0);
+  CHECK(ini_index_gets(&index, NULL, "top", "d", buffer, sizeof(buffer)) && strcmp(buffer, "1") == 0);
+  CHECK(ini_index_gets(&index, "Z", "top", "d", buffer, sizeof(buffer)) && strcmp(buffer, "d") == 0);
+  CHECK(ini_index_getsection(&index, 2, buffer, sizeof(buffer)) && strcmp(buffer, "C") == 0);
+  CHECK(ini_index_getkey(&index, "A", 1, buffer, sizeof(buffer)) && strcmp(buffer, "y") == 0);
+  CHECK(ini_index_haskey(&index, "C", "m") && !ini_index_haskey(&index, "C", "q"));
+  /* ini_gets() never matches an empty key, so neither does the index */
+  CHECK_GETS("B", "", "<default>", ini);
+  CHECK(ini_index_gets(&index, "B", "", "d", buffer, sizeof(buffer)) == 1 && strcmp(buffer, "d") == 0);
+  CHECK(!ini_index_haskey(&index, "B", ""));
+  CHECK(ini_index_getkey(&index, "B", 1, buffer, sizeof(buffer)) == 0);
+  ini_index_close(&index);
+
+  /* a generated file, with indented headers and keys, both delimiters and
+     comments behind the values */
+  fp = fopen(ini, "wb");
+  srand(7);
+  for (s = 0; s < 300; s++) {
+    fprintf(fp, "%s[Sec%d]\n", (s % 7 == 0) ? "  " : "", s);
+    for (k = rand() % 20; k > 0; k--)
+      fprintf(fp, "%sk%d %c v%d_%d%s\n", (k % 3) ? "" : " ", k, (k % 2) ? '=' : ':', s, k, (k % 5) ? "" : " ;cmt");
+  }
+  fclose(fp);
+  CHECK(ini_index_open(&index, ini));
+  CHECK(index.count == 301);
+  compare_all(&index, 300, 22);
+  CHECK(index.cache.evictions == 0 && index.cache.misses > 0 && index.cache.hits > 0);
+  ini_index_close(&index);
+
+  /* the same lookups within a memory budget: the least recently used
+     sections are evicted, and parsed again when they are needed */
+  CHECK(ini_index_open(&index, ini));
+  ini_index_setbudget(&index, 600);
+  compare_all(&index, 300, 22);
+  CHECK(index.cache.used <= 600);
+  CHECK(index.cache.evictions > 0);
+  ini_index_gets(&index, "Sec3", "K1", "d", buffer, sizeof(buffer));
+  misses = index.cache.misses;  /* the most recently used section stays */
+  ini_index_gets(&index, "Sec3", "K2", "d", buffer, sizeof(buffer));
+  CHECK(index.cache.misses == misses);
+  ini_index_setbudget(&index, 40);      /* lowering the budget evicts at once */
+  CHECK(index.cache.used <= 40);
+  /* a section that does not fit in the budget is looked up in the file */
+  compare_all(&index, 300, 22);
+  CHECK(index.cache.used <= 40);
+  ini_index_setbudget(&index, 0);       /* no limit */
+  compare_all(&index, 300, 22);
+  ini_index_close(&index);
+
+  /* lines that are too long for the buffer are split where ini_read() splits
+     them: behind a long value, the rest of the line can be a key or a header,
+     and a header that is too long ends a section without starting one */
+  {
+    static const char *const names[][2] = {
+      { "s", "long" }, { "s", "k2" }, { "s", "x" }, { "t", "k" }, { "t", "k3" }, { "u", "k4" }
+    };
+    char pad[700], name[INI_BUFFERSIZE], expected[INI_BUFFERSIZE];
+    memset(pad, 'a', sizeof(pad) - 1);
+    pad[sizeof(pad) - 1] = '\0';
+    fp = fopen(ini, "wb");
+    fprintf(fp, "[s]\nlong=%.*sk2=v2\n", INI_BUFFERSIZE - 1 - 5, pad);
+    fprintf(fp, "x=%.*s[t]\nk=1\n", INI_BUFFERSIZE - 1 - 2, pad);
+    fprintf(fp, "[%.*s]\nk3=3\n", INI_BUFFERSIZE + 50, pad);
+    fprintf(fp, "%*s[u]\nk4=4\n", INI_BUFFERSIZE - 1, "");
+    fclose(fp);
+    CHECK(ini_index_open(&index, ini));
+    for (k = 0; k < (int)(sizeof(names) / sizeof(names[0])); k++) {
+      ini_gets(names[k][0], names[k][1], "<default>", expected, sizeof(expected), ini);
+      ini_index_gets(&index, names[k][0], names[k][1], "<default>", name, sizeof(name));
+      if (strcmp(expected, name) != 0) {
+        printf("[%s] %s: index gives \"%.20s\", ini_gets gives \"%.20s\"\n", names[k][0], names[k][1], name, expected);
+        test_failures++;
+      }
+    }
+    for (s = 0; s < 4; s++) {
+      ini_getsection(s, expected, sizeof(expected), ini);
+      ini_index_getsection(&index, s, name, sizeof(name));
+      CHECK(strcmp(expected, name) == 0);
+    }
+    CHECK_GETS("s", "k2", "v2", ini);
+    CHECK_GETS("t", "k", "1", ini);
+    CHECK_GETS("t", "k3", "<default>", ini);
+    ini_index_close(&index);
+  }
+
+#if !INI_READONLY
+  /* writes through the index */
+  test_writefile(ini, "[A]\nx=1\n[B]\ny=2\n");
+  CHECK(ini_index_open(&index, ini));
+  CHECK(ini_index_puts(&index, "A", "x", "10"));
+  CHECK(ini_index_puts(&index, "A", "z", "3"));
+  CHECK(ini_index_puts(&index, "C", "w", "4"));
+  CHECK(ini_index_puts(&index, "B", "y", NULL));
+  CHECK(ini_index_gets(&index, "A", "x", "d", buffer, sizeof(buffer)) && strcmp(buffer, "10") == 0);
+  CHECK(ini_index_gets(&index, "A", "z", "d", buffer, sizeof(buffer)) && strcmp(buffer, "3") == 0);
+  CHECK(ini_index_gets(&index, "C", "w", "d", buffer, sizeof(buffer)) && strcmp(buffer, "4") == 0);
+  CHECK(!ini_index_haskey(&index, "B", "y"));
+  CHECK(strcmp(test_readfile(ini), "[A]\nx = 10\nz = 3\n[B]\n[C]\nw = 4\n") == 0);
+  ini_index_close(&index);
+#endif
+
+  TEST_END(argv[0]);
+}
@@ -0,0 +1,73 @@
+/*  Tests for committing to two alternating slot files (INI_PINGPONG)
+ */
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_pingpong.ini";
+static const char *slot_a = "test_pingpong.ini.a";
+static const char *slot_b = "test_pingpong.ini.b";
+
+/* Write a slot file with a valid trailer */
+static void write_slot(const char *filename, unsigned seq, const char *text)
+{
+  unsigned a = 1, b = 0;
+  const char *p;
+  FILE *fp;
+
+  for (p = text; *p != '\0'; p++) {
+    a = (a + (unsigned char)*p) % 65521;
+    b = (b + a) % 65521;
+  }
+  fp = fopen(filename, "wb");
+  fprintf(fp, "%s;@slot %08x %08x\n", text, seq, (b << 16) | a);
+  fclose(fp);
+}
+
+int main(int argc, char *argv[])
+{
+  FILE *fp;
+
+  (void)argc;
+  remove(slot_a);
+  remove(slot_b);
+  CHECK_GETS("A", "x", "<default>", ini);
+
+  /* the commits alternate between the slots, with a rising sequence number */
+  CHECK(ini_puts("A", "x", "1", ini));
+  CHECK(strstr(test_readfile(slot_a), ";@slot 00000001 ") != NULL);
+  CHECK(ini_puts("A", "y", "2", ini));
+  CHECK(strstr(test_readfile(slot_b), ";@slot 00000002 ") != NULL);
+  CHECK(ini_puts("B", "z", "3", ini));
+  CHECK(ini_puts("A", "x", "44", ini));
+  CHECK_GETS("A", "x", "44", ini);
+  CHECK_GETS("A", "y", "2", ini);
+  CHECK_GETS("B", "z", "3", ini);
+  CHECK(strstr(test_readfile(slot_b), ";@slot 00000004 ") != NULL);
+
+  /* a torn slot fails its checksum; readers fall back to the other slot */
+  fp = fopen(slot_b, "r+b");
+  fputc('X', fp);
+  fclose(fp);
+  CHECK_GETS("A", "x", "1", ini);
+  CHECK_GETS("B", "z", "3", ini);
+  CHECK(ini_puts("A", "y", NULL, ini));
+  CHECK(!ini_haskey("A", "y", ini));
+  CHECK_GETS("B", "z", "3", ini);
+  CHECK(strstr(test_readfile(slot_b), ";@slot 00000004 ") != NULL);
+
+  /* a comment that looks like the trailer does not end the file */
+  remove(slot_b);
+  write_slot(slot_a, 7, "[A]\n;@slot 00000009 00000000\nx=1\n[B]\ny=2\n");
+  CHECK_GETS("A", "x", "1", ini);
+  CHECK_GETS("B", "y", "2", ini);
+  CHECK(ini_puts("B", "z", "3", ini));
+  CHECK(strncmp(test_readfile(slot_b), "[A]\n;@slot 00000009 00000000\nx=1\n[B]\ny=2\nz = 3\n;@slot 00000008 ", 60) == 0);
+  CHECK_GETS("B", "z", "3", ini);
+
+  /* one occurrence of a repeated key */
+  CHECK(ini_puts_nth("B", "y", 1, "5", ini));
+  CHECK(ini_puts_nth("B", "y", 0, "4", ini));
+  CHECK(ini_puts_nth("B", "y", 1, NULL, ini));
+  CHECK(strncmp(test_readfile(slot_a), "[A]\n;@slot 00000009 00000000\nx=1\n[B]\ny = 4\nz = 3\n;@slot 0000000b ", 65) == 0);
+  TEST_END(argv[0]);
+}
@@ -0,0 +1,81 @@
+/*  Tests for indexes and documents on a memory resource: all their memory
+ *  comes from the resource and goes back to it, and running out of memory is
+ *  reported instead of thrown
+ */
+#include <memory_resource>
+#include "test.h"
+#include "minIni.hpp"
+
+static const char *ini = "test_pmr.ini";
+
+/* A resource that counts the memory that is in use */
+struct Counting : std::pmr::memory_resource {
+  explicit Counting(std::pmr::memory_resource *upstream) : upstream_(upstream) {}
+  long live = 0, calls = 0;
+
+private:
+  void *do_allocate(std::size_t size, std::size_t align) override
+  {
+    live += (long)size;
+    calls++;
+    return upstream_->allocate(size, align);
+  }
+  void do_deallocate(void *ptr, std::size_t size, std::size_t align) override
+  {
+    live -= (long)size;
+    upstream_->deallocate(ptr, size, align);
+  }
+  bool do_is_equal(const memory_resource &other) const noexcept override { return this == &other; }
+
+  std::pmr::memory_resource *upstream_;
+};
+
+int main(int argc, char *argv[])
+{
+  alignas(16) static char buffer[1 << 16];
+  alignas(16) static char tiny[64];
+  Counting counting(std::pmr::new_delete_resource());
+  int i;
+
+  (void)argc;
+  test_writefile(ini, "top=1\n[a]\nx=1\ny=2\n[b]\nz=3\n");
+  {
+    minIni::Document doc(ini, &counting);
+    CHECK(doc.is_open() && doc.resource() == &counting);
+    CHECK(doc.gets("a", "y") == "2");
+    for (i = 0; i < 200; i++)
+      doc.put("b", "k", i);
+    CHECK(doc.get<int>("b", "k", 0) == 199);
+    CHECK(doc.undo() && doc.get<int>("b", "k", 0) == 198);
+    minIni::Document moved(std::move(doc));
+    CHECK(moved.gets("a", "x") == "1" && moved.save());
+  }
+  CHECK(counting.calls > 0 && counting.live == 0);
+
+  counting.calls = 0;
+  {
+    minIni::Index index(ini, &counting);
+    CHECK(index.gets("b", "z") == "3");
+    for (i = 0; i < 50; i++)
+      index.put("n", "k", i);
+    CHECK(index.get<int>("n", "k", 0) == 49);
+  }
+  CHECK(counting.calls > 0 && counting.live == 0);
+
+  /* a document per level, released in one step */
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+  {
+    minIni::Document level(ini, &arena);
+    CHECK(level.gets("a", "x") == "1");
+  }
+  arena.release();
+
+  /* out of memory */
+  std::pmr::monotonic_buffer_resource small(tiny, sizeof(tiny), std::pmr::null_memory_resource());
+  {
+    minIni::Document none(ini, &small);
+    CHECK(!none.is_open() && none.gets("a", "x", "d") == "d");
+  }
+
+  TEST_END(argv[0]);
+}
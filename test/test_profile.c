@@ -0,0 +1,72 @@
+/*  Tests for the hot-key profiler (INI_PROFILE)
+ */
+#include "test.h"
+#include "minIni.h"
+
+static const INI_PROFILE_ENTRY *find(const INI_PROFILE_ENTRY *entries, int count, const char *section, const char *key)
+{
+  int i;
+
+  for (i = 0; i < count; i++)
+    if (strcmp(entries[i].section, section) == 0 && strcmp(entries[i].key, key) == 0)
+      return &entries[i];
+  return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+  INI_PROFILE_ENTRY entries[INI_PROFILESIZE];
+  const INI_PROFILE_ENTRY *entry;
+  char buffer[64], key[16];
+  INI_INDEX index;
+  int i, count;
+
+  (void)argc;
+  test_writefile("test_profile.ini", "[A]\nx=1\ny=2\n");
+  ini_profile_reset();
+  CHECK(ini_profile_top(entries, INI_PROFILESIZE) == 0);
+  for (i = 0; i < 5; i++)
+    ini_gets("A", "x", "", buffer, sizeof(buffer), "test_profile.ini");
+  ini_gets("a", "X", "", buffer, sizeof(buffer), "test_profile.ini");    /* the same key */
+  ini_gets("A", "none", "", buffer, sizeof(buffer), "test_profile.ini");
+  CHECK(ini_index_open(&index, "test_profile.ini"));
+  ini_index_gets(&index, "A", "y", "", buffer, sizeof(buffer));
+  ini_index_gets(&index, "A", "y", "", buffer, sizeof(buffer));
+  ini_index_close(&index);
+
+  count = ini_profile_top(entries, INI_PROFILESIZE);
+  CHECK(count == 3);
+  entry = find(entries, count, "A", "x");
+  CHECK(entry != NULL && entry->calls == 6 && entry->found == 6 && entry->paths == INI_PATH_CLASSIC);
+  CHECK(entry != NULL && strcmp(entry->file, "test_profile.ini") == 0);
+  entry = find(entries, count, "A", "none");
+  CHECK(entry != NULL && entry->calls == 1 && entry->found == 0);
+  entry = find(entries, count, "A", "y");
+  CHECK(entry != NULL && entry->calls == 2 && entry->found == 2 && entry->paths == INI_PATH_INDEX);
+  for (i = 1; i < count; i++)
+    CHECK(entries[i - 1].time >= entries[i].time);  /* most expensive first */
+  CHECK(ini_profile_top(entries, 1) == 1);
+
+  /* the report has a header and a line per entry */
+  CHECK(ini_profile_dump(2, "test_profile.txt"));
+  CHECK(strncmp(test_readfile("test_profile.txt"), "; calls\thits\tfound\tavg(us)\tpaths\tfile\tsection\tkey\n", 48) == 0);
+  for (i = 0, count = 0; test_readfile("test_profile.txt")[i] != '\0'; i++)
+    count += test_readfile("test_profile.txt")[i] == '\n';
+  CHECK(count == 3);
+  CHECK(ini_profile_dump(8, "test_profile.txt") && strstr(test_readfile("test_profile.txt"), "\n6\t0\t6\t") != NULL);
+  CHECK(strstr(test_readfile("test_profile.txt"), "\tC\ttest_profile.ini\tA\tx\n") != NULL);
+
+  /* a full table drops the new keys, and counts them */
+  ini_profile_reset();
+  CHECK(ini_profile_dropped() == 0);
+  for (i = 0; i < INI_PROFILESIZE + 10; i++) {
+    sprintf(key, "k%d", i);
+    ini_gets("A", key, "", buffer, sizeof(buffer), "test_profile.ini");
+  }
+  CHECK(ini_profile_top(entries, INI_PROFILESIZE) == INI_PROFILESIZE);
+  CHECK(ini_profile_dropped() == 10);
+  ini_profile_reset();
+  CHECK(ini_profile_top(entries, INI_PROFILESIZE) == 0 && ini_profile_dropped() == 0);
+
+  TEST_END(argv[0]);
+}
@@ -0,0 +1,84 @@
+/*  Tests for the section and key ranges: one pass over the file gives all
+ *  sections and keys in file order, and they work with C++20 range adaptors
+ */
+#include <ranges>
+#include <string>
+#include "test.h"
+#include "minIni.hpp"
+
+static const char *ini = "test_ranges.ini";
+
+static_assert(std::ranges::input_range<minIni::Sections>);
+static_assert(std::ranges::view<minIni::Sections>);
+static_assert(std::ranges::input_range<minIni::Sections::Section>);
+
+int main(int argc, char *argv[])
+{
+  std::string out;
+
+  (void)argc;
+  test_writefile(ini, "top=0\n; c\n[a]\nx=1\n\ny=\"q\"\n[b]\n[c]\nz=3\nw=4\nv=5\n");
+  minIni::File file(ini);
+  for (auto &section : file.sections()) {
+    out += "[" + std::string(section.name()) + "]";
+    for (auto [key, value] : section)
+      out += std::string(key) + "=" + std::string(value) + ";";
+  }
+  CHECK(out == "[]top=0;[a]x=1;y=q;[b][c]z=3;w=4;v=5;");
+
+  /* skipping the keys, or some of them */
+  out.clear();
+  for (auto &section : file.sections())
+    out += std::string(section.name()) + ",";
+  CHECK(out == ",a,b,c,");
+  out.clear();
+  for (auto &section : file.sections()) {
+    for (auto [key, value] : section) {
+      out += std::string(key);
+      break;
+    }
+    out += "|";
+  }
+  CHECK(out == "top|x||z|");
+
+  /* range adaptors */
+  out.clear();
+  for (auto &section : file.sections() | std::views::filter([](auto &s) { return !s.name().empty(); })
+                                       | std::views::take(2)) {
+    out += std::string(section.name()) + ":";
+    for (auto [key, value] : section | std::views::take(1))
+      out += std::string(key);
+    out += ",";
+  }
+  CHECK(out == "a:x,b:,");
+  out.clear();
+  for (auto &section : file.sections())
+    if (section.name() == "c")
+      for (auto [key, value] : section | std::views::filter([](auto kv) { return kv.second != "4"; }))
+        out += std::string(key);
+  CHECK(out == "zv");
+
+  /* moving a range */
+  auto first = file.sections();
+  auto second = std::move(first);
+  CHECK((*second.begin()).name() == "");
+  for (auto [key, value] : *second.begin()) {
+    CHECK(key == "top" && value == "0");
+    break;
+  }
+
+  /* a file without sections or keys, and a file that does not exist */
+  int count = 0;
+  test_writefile(ini, "; nothing\n");
+  for (auto &section : minIni::Sections(ini)) {
+    (void)section;
+    count++;
+  }
+  for (auto &section : minIni::Sections("test_ranges.none")) {
+    (void)section;
+    count++;
+  }
+  CHECK(count == 0);
+
+  TEST_END(argv[0]);
+}
@@ -0,0 +1,59 @@
+/*  Tests for the pull parser (ini_reader_open(), ini_next()) and for
+ *  ini_browse(), which is built on it
+ */
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_reader.ini";
+static char output[4096];
+
+static SceBool collect(const char *Section, const char *Key, const char *Value, void *UserData)
+{
+  int *limit = (int *)UserData;
+  sprintf(strchr(output, '\0'), "%s|%s|%s\n", Section, Key, Value);
+  return limit == NULL || --*limit > 0;
+}
+
+int main(int argc, char *argv[])
+{
+  static const char *names[] = { "eof", "section", "key", "comment", "blank" };
+  INI_READER reader;
+  INI_EVENT event;
+  char events[1024] = "";
+  int type, limit;
+
+  (void)argc;
+  test_writefile(ini, "top=1\n\n  [ A ]  \nx = 1 ; c\n# hello \ny=\"q\\\"z\" ; c\ngarbage\n[B]\nk:v");
+
+  /* every line gives an event; the spans are zero-terminated */
+  CHECK(ini_reader_open(&reader, ini));
+  while ((type = ini_next(&reader, &event)) != INI_EVENT_EOF) {
+    CHECK(strlen(event.section.ptr) == event.section.len);
+    sprintf(strchr(events, '\0'), "%s[%s]", names[type], event.section.ptr);
+    if (type == INI_EVENT_KEY) {
+      CHECK(strlen(event.key.ptr) == event.key.len && strlen(event.value.ptr) == event.value.len);
+      sprintf(strchr(events, '\0'), "%s=%s", event.key.ptr, event.value.ptr);
+    } else if (type == INI_EVENT_COMMENT) {
+      sprintf(strchr(events, '\0'), "'%s'", event.value.ptr);
+    }
+    strcat(events, ";");
+  }
+  CHECK(ini_next(&reader, &event) == INI_EVENT_EOF);    /* stays at the end */
+  ini_reader_close(&reader);
+  CHECK(strcmp(events, "key[]top=1;blank[];section[A];key[A]x=1;comment[A]'hello';"
+                       "key[A]y=q\"z;section[B];key[B]k=v;") == 0);
+
+  /* ini_browse() reports the keys */
+  CHECK(ini_browse(collect, NULL, ini));
+  CHECK(strcmp(output, "|top|1\nA|x|1\nA|y|q\"z\nB|k|v\n") == 0);
+  output[0] = '\0';
+  limit = 2;    /* the callback stops the browsing */
+  CHECK(ini_browse(collect, &limit, ini));
+  CHECK(strcmp(output, "|top|1\nA|x|1\n") == 0);
+
+  /* a file that does not exist */
+  CHECK(!ini_reader_open(&reader, "test_reader.none"));
+  CHECK(!ini_browse(collect, NULL, "test_reader.none"));
+
+  TEST_END(argv[0]);
+}
@@ -0,0 +1,177 @@
+/*  Tests for the sidecar index (INI_SIDECAR)
+ */
+#include <unistd.h>
+#include <utime.h>
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_sidecar.ini";
+static const char *sidecar = "test_sidecar.ini.idx";
+
+#define HEADER_SIZE   48  /* sizeof(SIDECAR_HEADER) */
+#define RECORD_SIZE   24  /* sizeof(SIDECAR_RECORD) */
+
+/* These pairs of names have the same (case-folded) FNV-1a hash */
+#define COLLIDE1a     "s0744af"
+#define COLLIDE1b     "s0ef140"
+#define COLLIDE2a     "s0744ad"
+#define COLLIDE2b     "s0ef142"
+
+static long filesize(const char *filename)
+{
+  FILE *fp = fopen(filename, "rb");
+  long size;
+  if (fp == NULL)
+    return -1;
+  fseek(fp, 0, SEEK_END);
+  size = ftell(fp);
+  fclose(fp);
+  return size;
+}
+
+/* Clear the section hashes of all records: when the sidecar is kept, no key
+ * is found through it any more; when it is rebuilt, all keys are */
+static void clear_records(void)
+{
+  FILE *fp = fopen(sidecar, "r+b");
+  long size = filesize(sidecar), pos;
+  char zero[4] = { 0 };
+  for (pos = HEADER_SIZE; pos < size; pos += RECORD_SIZE) {
+    fseek(fp, pos, SEEK_SET);
+    fwrite(zero, sizeof(zero), 1, fp);
+  }
+  fclose(fp);
+}
+
+static void set_mtime(long seconds)
+{
+  struct utimbuf times;
+  times.actime = times.modtime = seconds;
+  utime(ini, &times);
+}
+
+int main(int argc, char *argv[])
+{
+  char section[16], key[16], expected[32];
+  FILE *fp;
+  int s, k;
+
+  (void)argc;
+  unlink(sidecar);
+  test_writefile(ini, "top=1\n  [ A ]  \nx = 1\ny=\"q\\\"z\" ; c\n[bogus\nlost=1\n[B]\nk:v\n = e\n"
+                      "[a]\nx=dup\nw=2\n# c\n\n\t[C]\nm=n");
+  CHECK_GETS("a", "X", "1", ini);
+  CHECK(filesize(sidecar) > HEADER_SIZE);
+  CHECK_GETS("A", "y", "q\"z", ini);
+  CHECK_GETS("A", "lost", "<default>", ini);
+  CHECK_GETS("A", "w", "<default>", ini);    /* a repeated section is not searched */
+  CHECK_GETS("B", "k", "v", ini);
+  CHECK_GETS("B", "", "<default>", ini);
+  CHECK_GETS("C", "m", "n", ini);
+  CHECK_GETS(NULL, "top", "1", ini);
+  CHECK_GETS("", "top", "1", ini);
+  CHECK_GETS("Z", "top", "<default>", ini);
+  CHECK(ini_haskey("C", "m", ini) && !ini_haskey("C", "q", ini));
+
+  /* an update in place keeps the sidecar: after the file is touched, only
+     the checksum can tell that the sidecar is still valid */
+  CHECK(ini_puts("B", "k", "w", ini));
+  CHECK_GETS("B", "k", "w", ini);
+  set_mtime(1000);
+  clear_records();
+  CHECK_GETS("C", "m", "<default>", ini);    /* kept */
+
+  /* a stale sidecar is rebuilt */
+  fp = fopen(ini, "ab");
+  fputs("\nadded=5\n", fp);
+  fclose(fp);
+  CHECK_GETS("C", "m", "n", ini);
+  CHECK_GETS("C", "added", "5", ini);
+
+  /* keys that ini_puts() appends become overflow records */
+  CHECK(ini_puts("C", "new", "7", ini));
+  CHECK(ini_puts("D", "e", "8", ini));
+  CHECK_GETS("C", "new", "7", ini);
+  CHECK_GETS("d", "E", "8", ini);
+  set_mtime(2000);
+  clear_records();
+  CHECK_GETS("d", "E", "<default>", ini);    /* kept */
+  unlink(sidecar);
+
+  /* too many overflow records: the sidecar is rebuilt */
+  for (k = 0; k < INI_SIDECAROVERFLOW + 5; k++) {
+    sprintf(key, "o%d", k);
+    CHECK(ini_puti("D", key, k, ini));
+    CHECK(ini_geti("D", key, -1, ini) == k);
+  }
+
+  /* sections and keys whose names have the same hash */
+  unlink(sidecar);
+  test_writefile(ini, "[" COLLIDE1a "]\nx=1\n[" COLLIDE1b "]\nx=2\ny=3\n"
+                      "[S]\n" COLLIDE2a "=4\n" COLLIDE2b "=5\n");
+  CHECK_GETS(COLLIDE1a, "x", "1", ini);
+  CHECK_GETS(COLLIDE1b, "x", "2", ini);
+  CHECK_GETS(COLLIDE1b, "y", "3", ini);
+  CHECK_GETS("S", COLLIDE2a, "4", ini);
+  CHECK_GETS("S", COLLIDE2b, "5", ini);
+  CHECK(ini_puts(COLLIDE2a, "z", "6", ini));         /* appended, with a colliding name */
+  CHECK(ini_puts("S", "z", "7", ini));
+  CHECK_GETS(COLLIDE2a, "z", "6", ini);
+  CHECK_GETS("S", "z", "7", ini);
+  test_writefile(ini, "[" COLLIDE1a "]\nx=1\n");
+  CHECK_GETS(COLLIDE1b, "x", "<default>", ini);      /* a missing section */
+  CHECK_GETS(COLLIDE1a, "x", "1", ini);
+
+  /* a sidecar that is stale, although the size and the modification time of
+     the file did not change (e.g. within the 2-second resolution of FAT) */
+  test_writefile(ini, "[A]\na=1\nb=2\n");
+  set_mtime(3000);
+  CHECK_GETS("A", "a", "1", ini);
+  test_writefile(ini, "[A]\nb=2\na=1\n");
+  set_mtime(3000);
+  CHECK_GETS("A", "a", "1", ini);
+  CHECK_GETS("A", "b", "2", ini);
+  test_writefile(ini, "[A]\na=1\n[B]\nb=2\n");
+  set_mtime(4000);
+  CHECK_GETS("A", "a", "1", ini);
+  test_writefile(ini, "[B]\nb=2\n[A]\na=1\n");
+  set_mtime(4000);
+  CHECK_GETS("A", "a", "1", ini);
+  CHECK_GETS("B", "b", "2", ini);
+
+  /* compare with the values of a generated file */
+  fp = fopen(ini, "wb");
+  for (s = 0; s < 300; s++) {
+    fprintf(fp, "%s[Sec%d]\n", (s % 7 == 0) ? "  " : "", s);
+    for (k = 0; k < 1 + s % 13; k++)
+      fprintf(fp, "%sk%d %c v%d_%d%s\n", (k % 3) ? "" : " ", k, (k % 2) ? '=' : ':', s, k, (k % 5) ? "" : " ;cmt");
+  }
+  fclose(fp);
+  for (s = 0; s < 300; s++) {
+    for (k = 0; k < 15; k++) {
+      sprintf(section, "sec%d", s);
+      sprintf(key, "K%d", k);
+      sprintf(expected, "v%d_%d", s, k);
+      CHECK_GETS(section, key, (k < 1 + s % 13) ? expected : "<default>", ini);
+    }
+  }
+  /* deleting goes through a copy of the file, and the sidecar is rebuilt */
+  CHECK(ini_puts("Sec5", "k1", NULL, ini));
+  CHECK_GETS("Sec5", "k1", "<default>", ini);
+  CHECK_GETS("Sec5", "k2", "v5_2", ini);
+
+  /* many sections, each of which is repeated further on: only the keys of the
+     first section with a name are found, as with a scan of the file */
+  fp = fopen(ini, "wb");
+  for (s = 0; s < 4000; s++)
+    fprintf(fp, "[R%d]\nk=%d\n%s", s % 2000, s, (s < 2000) ? "" : "r=1\n");
+  fclose(fp);
+  for (s = 0; s < 2000; s += 97) {
+    sprintf(section, "r%d", s);
+    sprintf(expected, "%d", s);
+    CHECK_GETS(section, "k", expected, ini);
+    CHECK_GETS(section, "r", "<default>", ini);
+  }
+
+  TEST_END(argv[0]);
+}
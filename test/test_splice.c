@@ -0,0 +1,97 @@
+/*  Tests for the splice that ini_puts_splice() reports, and for keeping the
+ *  section index up to date with it
+ */
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_splice.ini";
+static char before[1 << 16];
+
+/* Write through ini_puts_splice(), and check that the file only changed in
+ * the reported splice */
+static void put(const char *Section, const char *Key, const char *Value, long removed, long inserted)
+{
+  INI_SPLICE splice;
+  const char *after;
+  long size_before, size_after;
+
+  strcpy(before, test_readfile(ini));
+  CHECK(ini_puts_splice(Section, Key, Value, ini, &splice));
+  after = test_readfile(ini);
+  size_before = (long)strlen(before);
+  size_after = (long)strlen(after);
+  CHECK(splice.offset >= 0 && splice.offset + splice.removed <= size_before);
+  CHECK(size_after - size_before == splice.inserted - splice.removed);
+  CHECK(memcmp(before, after, (size_t)splice.offset) == 0);
+  CHECK(strcmp(before + splice.offset + splice.removed, after + splice.offset + splice.inserted) == 0);
+  if (removed >= 0)
+    CHECK(splice.removed == removed);
+  if (inserted >= 0)
+    CHECK(splice.inserted == inserted);
+}
+
+int main(int argc, char *argv[])
+{
+  char buffer[64], expected[64], section[16], key[16], value[32];
+  INI_INDEX index, fresh;
+  FILE *fp;
+  int s, k, n;
+
+  (void)argc;
+  fp = fopen(ini, "wb");
+  for (s = 0; s < 20; s++) {
+    fprintf(fp, "[S%d]\n", s);
+    for (k = 0; k < s % 5; k++)
+      fprintf(fp, "k%d=v%d_%d\n", k, s, k);
+  }
+  fclose(fp);
+
+  put("S3", "k1", "v3_1", 0, 0);      /* unchanged */
+  put("S3", "k1", "XX33", 8, 10);     /* "k1=v3_1\n" -> "k1 = XX33\n" */
+  put("S3", "k1", "YY33", 10, 10);    /* in place */
+  put("S3", "k1", "longer", -1, -1);
+  put("S3", "k9", "new", 0, 9);       /* added to a section in the middle */
+  put("S19", "k9", "new", 0, 9);      /* appended to the last section */
+  put("S40", "k", "new", 0, 14);      /* a new section */
+  put("S3", "k0", NULL, 8, 0);        /* deleted */
+  put("S3", "k0", NULL, 0, 0);        /* already gone */
+  put("S4", NULL, NULL, -1, 0);       /* a whole section */
+
+  /* an index that is kept up to date through the splices must stay equal
+     to an index that is built anew */
+  CHECK(ini_index_open(&index, ini));
+  ini_index_setbudget(&index, 400);
+  srand(11);
+  for (n = 0; n < 300; n++) {
+    int op = rand() % 10;
+    sprintf(section, "S%d", rand() % 25);
+    sprintf(key, "k%d", rand() % 7);
+    sprintf(value, "val%.*s", rand() % 12, "abcdefghijklmnop");
+    ini_index_gets(&index, section, "k0", "", buffer, sizeof(buffer));  /* so that some sections are parsed */
+    if (op == 0)
+      CHECK(ini_index_puts(&index, section, NULL, NULL));
+    else if (op < 3)
+      CHECK(ini_index_puts(&index, section, key, NULL));
+    else
+      CHECK(ini_index_puts(&index, section, key, value));
+    for (s = 0; s < 25; s++) {
+      for (k = 0; k < 7; k++) {
+        sprintf(section, "S%d", s);
+        sprintf(key, "k%d", k);
+        ini_gets(section, key, "-", expected, sizeof(expected), ini);
+        ini_index_gets(&index, section, key, "-", buffer, sizeof(buffer));
+        CHECK(strcmp(buffer, expected) == 0);
+      }
+    }
+    CHECK(ini_index_open(&fresh, ini));
+    CHECK(fresh.count == index.count);
+    for (s = 0; s < fresh.count && s < index.count; s++)
+      CHECK(fresh.sections[s].start == index.sections[s].start && fresh.sections[s].end == index.sections[s].end);
+    ini_index_close(&fresh);
+    if (test_failures > 0)
+      break;
+  }
+  ini_index_close(&index);
+
+  TEST_END(argv[0]);
+}
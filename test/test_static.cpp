@@ -0,0 +1,66 @@
+/*  Tests for INI files that are parsed at compile time (INI_STATIC): every
+ *  lookup must give what ini_gets() gives on the same text in a file
+ */
+#include <string>
+#include "test.h"
+#include "minIni.hpp"
+
+static const char *ini = "test_static.ini";
+
+constexpr auto defaults = INI_STATIC("top=1\n[net]\nport = 8080 ; c\nname=\"a \"\"b\"\" \\\"c\"\n[NET]\nport=1\n[x]\nk:v\n");
+static_assert(defaults.gets("", "top") == "1");
+static_assert(defaults.gets("Net", "PORT") == "8080");
+static_assert(defaults.gets("net", "name") == "a \"b\" \"c");
+static_assert(defaults.gets("x", "k") == "v");
+static_assert(defaults.gets("x", "z", "dflt") == "dflt");
+static_assert(defaults.has_key("x", "k") && !defaults.has_key("x", "z"));
+static_assert(defaults.size() == 4);
+constexpr minIni::StaticKey port("net", "port");
+static_assert(defaults.gets(port) == "8080");
+
+/* Look up all combinations of a set of names, in the table and in the file */
+template <class Table>
+static void compare(const Table &table, const char *text, int line)
+{
+  static const char *names[] = { "a", "A", "b", "B", "x", "", "X y", " a" };
+  char value[INI_BUFFERSIZE];
+
+  test_writefile(ini, text);
+  for (const char *section : names) {
+    for (const char *key : names) {
+      ini_gets(section, key, "\x01", value, sizeof(value), ini);
+      std::string_view found = table.gets(section, key, "\x01");
+      if (found != value) {
+        printf("%s:%d: [%s] %s is \"%.*s\", expected \"%s\"\n", __FILE__, line, section, key,
+               (int)found.size(), found.data(), value);
+        test_failures++;
+      }
+    }
+  }
+}
+
+#define COMPARE(text) \
+  do { \
+    constexpr auto table_ = INI_STATIC(text); \
+    compare(table_, text, __LINE__); \
+  } while (0)
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  COMPARE("");
+  COMPARE("\n");
+  COMPARE("a=1");                                   /* no line end */
+  COMPARE(" A= ");
+  COMPARE("  a:][Barfoox\nA=BarfooBar\n[a\n a = ]  Bar\n;\n X y =   ]\n;\n");
+  COMPARE(" X y:=;b:;a\nb=\n [B \nX y =\\\" a\n ;a \n\t[a\n =");
+  COMPARE(" a=Bar\n[B\n  a=\n[ B ]x]\n x=  \n");
+  COMPARE("x:ab=\\\"\"\"\n;:\nA :;]1\na  = :AafooBar\n[ ]\n\t[ a]x]\n A =[1afoo\"\"\nA=\\\";\n");
+  COMPARE("X y=\"X y\"\"\nX y =Bar \n\t[B ] ;c\n  =]b");
+  COMPARE(" a:\n X y  = [\n X y  = \n\t[x]\n[a ]x]\n a=1x]foo=\n a =]foo\t Bar\nB:Bar#;foo\n");
+  COMPARE(" =]#\\\"\n#\nB=##\"\nA = \n B  = x\n b  = \\\"\" b\n  a=Barfoo\n [  ] ;c\nX y :x\"1ax\nx =A Bar\"");
+  COMPARE("a=1\n[A]\na=2\n[a]\na=3\n");             /* only the first section counts */
+  COMPARE("[a]\nb=\"  padded  \"\nx=\"unterminated\nA=\"a\"\"b\"\n");
+
+  TEST_END(argv[0]);
+}
@@ -0,0 +1,86 @@
+/*  Tests for the trace export (INI_TRACE): the trace must be a valid JSON
+ *  array of matching begin/end events, also when events are dropped
+ */
+#include "test.h"
+#include "minIni.h"
+
+static char trace[1 << 16];
+
+/* Whether the text is an array of flat objects, and count the begin and
+   end events in it */
+static int checkjson(const char *text, int *begins, int *ends)
+{
+  int depth = 0, instring = 0;
+
+  *begins = *ends = 0;
+  if (*text != '[')
+    return 0;
+  for (text++; *text != '\0'; text++) {
+    if (instring) {
+      if (*text == '\\' && text[1] != '\0')
+        text++;
+      else if (*text == '"')
+        instring = 0;
+    } else if (*text == '"') {
+      instring = 1;
+      if (strncmp(text, "\"ph\":\"B\"", 8) == 0)
+        (*begins)++;
+      else if (strncmp(text, "\"ph\":\"E\"", 8) == 0)
+        (*ends)++;
+    } else if (*text == '{') {
+      if (++depth > 1)
+        return 0;
+    } else if (*text == '}') {
+      if (--depth < 0)
+        return 0;
+    } else if (*text == ']') {
+      while (text[1] == '\n' || text[1] == '\r')
+        text++;
+      return depth == 0 && text[1] == '\0';
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  static char small[300];
+  char buffer[64];
+  int begins, ends, i;
+  SceSize size;
+
+  (void)argc;
+  test_writefile("test_trace.ini", "[A]\nx=1\n");
+  CHECK(!ini_trace_start(small, 4));
+  CHECK(ini_trace_start(trace, sizeof(trace)));
+  ini_gets("A", "x", "", buffer, sizeof(buffer), "test_trace.ini");
+  ini_puts("A", "y", "2", "test_trace.ini");
+  size = ini_trace_stop();
+  CHECK(size == strlen(trace));
+  CHECK(checkjson(trace, &begins, &ends));
+  CHECK(begins == ends && begins >= 4);
+  CHECK(strstr(trace, "\"name\":\"ini_gets\"") != NULL && strstr(trace, "\"name\":\"ini_puts\"") != NULL);
+  CHECK(strstr(trace, "\"cat\":\"io\"") != NULL);
+  CHECK(ini_trace_dropped() == 0);
+
+  /* nothing is traced after the stop */
+  ini_gets("A", "x", "", buffer, sizeof(buffer), "test_trace.ini");
+  CHECK(strlen(trace) == size);
+
+  /* a small buffer drops events, but the trace stays valid */
+  CHECK(ini_trace_start(small, sizeof(small)));
+  ini_gets("A", "x", "", buffer, sizeof(buffer), "test_trace.ini");
+  ini_trace_stop();
+  CHECK(ini_trace_dropped() > 0);
+  CHECK(checkjson(small, &begins, &ends) && begins >= ends);   /* an unfinished call has no end */
+
+  /* a trace to a file */
+  CHECK(ini_trace_startfile("test_trace.json"));
+  for (i = 0; i < 50; i++)
+    ini_gets("A", "x", "", buffer, sizeof(buffer), "test_trace.ini");
+  ini_trace_stop();
+  CHECK(checkjson(test_readfile("test_trace.json"), &begins, &ends));
+  CHECK(begins == ends && begins >= 50);
+
+  TEST_END(argv[0]);
+}
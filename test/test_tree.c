@@ -0,0 +1,76 @@
+/*  Tests for the hierarchy of dotted section names in an index: listing the
+ *  subsections of a section, and looking up a key in a section or its
+ *  parents
+ */
+#include "test.h"
+#include "minIni.h"
+
+static const char *ini = "test_tree.ini";
+
+/* All subsections of a section, each followed by a '|' */
+static const char *subsections(INI_INDEX *index, const char *section)
+{
+  static char list[512];
+  char name[64];
+  int i;
+
+  list[0] = '\0';
+  for (i = 0; ini_index_getsubsection(index, section, i, name, sizeof(name)) > 0; i++) {
+    strcat(list, name);
+    strcat(list, "|");
+  }
+  return list;
+}
+
+#define CHECK_INHERIT(section, key, expected) \
+  do { \
+    char value_[64]; \
+    ini_index_gets_inherit(&index, (section), (key), "-", value_, sizeof(value_)); \
+    if (strcmp(value_, (expected)) != 0) { \
+      printf("%s:%d: [%s] %s is \"%s\", expected \"%s\"\n", __FILE__, __LINE__, (section), (key), value_, (expected)); \
+      test_failures++; \
+    } \
+  } while (0)
+
+int main(int argc, char *argv[])
+{
+  INI_INDEX index;
+  char name[64];
+
+  (void)argc;
+  test_writefile(ini, "g=top\n[Render]\nq=high\nw=1\n[Render.Shadows.Cascade0]\nd=10\n[Audio]\nv=5\n"
+                      "[Render.Shadows]\nd=50\nw=2\n[Render.Shadows.Cascade1]\n[render.shadowsX]\nd=7\n"
+                      "[Render]\nq=dup\n[Render.Shadows.Cascade0.Deep]\nz=1\n");
+  CHECK(ini_index_open(&index, ini));
+  CHECK(strcmp(subsections(&index, "render.shadows"),
+               "Render.Shadows|Render.Shadows.Cascade0|Render.Shadows.Cascade0.Deep|Render.Shadows.Cascade1|") == 0);
+  CHECK(strcmp(subsections(&index, NULL),
+               "Render|Render.Shadows|Render.Shadows.Cascade0|Render.Shadows.Cascade0.Deep|Render.Shadows.Cascade1|render.shadowsX|Audio|") == 0);
+  CHECK(ini_index_getsubsection(&index, "Render.Shadows.Cascade0", 1, name, sizeof(name)) > 0
+        && strcmp(name, "Render.Shadows.Cascade0.Deep") == 0);
+  CHECK(ini_index_getsubsection(&index, "Nope", 0, name, sizeof(name)) == 0 && name[0] == '\0');
+  CHECK(ini_index_getsubsection(&index, "Render", 7, name, sizeof(name)) == 0);
+
+  CHECK_INHERIT("Render.Shadows.Cascade0", "d", "10");
+  CHECK_INHERIT("Render.Shadows.Cascade1", "d", "50");
+  CHECK_INHERIT("Render.Shadows.Cascade1", "q", "high");   /* the first [Render] */
+  CHECK_INHERIT("Render.Shadows.Cascade0.Deep", "w", "2");
+  CHECK_INHERIT("Render.Shadows.Cascade9", "d", "50");     /* a section that is not there */
+  CHECK_INHERIT("Render.Shadows.Cascade1", "g", "-");      /* not from the keys above the sections */
+  CHECK_INHERIT("Audio.Music", "v", "5");
+  CHECK_INHERIT("", "g", "top");
+  CHECK_INHERIT("x", "g", "-");
+
+  /* a new section goes into the hierarchy */
+  CHECK(ini_index_puts(&index, "Render.Shadows.Cascade2", "d", "99"));
+  CHECK(ini_index_getsubsection(&index, "Render.Shadows", 4, name, sizeof(name)) > 0
+        && strcmp(name, "Render.Shadows.Cascade2") == 0);
+  CHECK_INHERIT("Render.Shadows.Cascade2", "w", "2");
+
+  ini_index_setcase(&index, INI_TRUE);
+  CHECK(ini_index_getsubsection(&index, "render.shadows", 0, name, sizeof(name)) == 0);
+  CHECK(strcmp(subsections(&index, "render"), "render.shadowsX|") == 0);
+  ini_index_close(&index);
+
+  TEST_END(argv[0]);
+}